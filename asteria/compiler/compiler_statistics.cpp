@@ -0,0 +1,166 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "../xprecompiled.hpp"
+#include "compiler_statistics.hpp"
+#include "../utils.hpp"
+#include <time.h>  // ::clock_gettime()
+#ifdef __GLIBC__
+#include <malloc.h>  // ::mallinfo2()
+#endif
+namespace asteria {
+namespace {
+
+// These are statistics that are being collected, and the innermost phase that
+// is being measured, on the current thread.
+struct Collection_State
+  {
+    Compiler_Statistics* stats;
+    Compiler_Phase_Meter* meter;
+  };
+
+thread_local Collection_State s_state;
+
+int64_t
+do_get_time_ns() noexcept
+  {
+    ::timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+  }
+
+int64_t
+do_get_heap_bytes() noexcept
+  {
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ(2, 33)
+    // This is the number of bytes that have been allocated and not freed.
+    struct ::mallinfo2 info = ::mallinfo2();
+    return (int64_t) (info.uordblks + info.hblkhd);
+#endif
+#endif
+    return 0;
+  }
+
+void
+do_put_cell(tinyfmt& fmt, const char* str, size_t len, size_t width)
+  {
+    // Right-align the string in a cell.
+    for(size_t k = len;  k < width;  ++k)
+      fmt.putc(' ');
+    fmt.putn(str, len);
+  }
+
+}  // namespace
+
+tinyfmt&
+Compiler_Statistics::
+print_to(tinyfmt& fmt) const
+  {
+    static constexpr char names[][16] =
+      { "lexing", "parsing", "generation", "optimization", "solidification" };
+
+    static constexpr char units[][16] =
+      { "tokens", "statements", "AIR nodes", "AIR nodes", "rod bytes" };
+
+    fmt << "phase               runs     time (ms)    heap (bytes)           count";
+
+    ::rocket::ascii_numput nump;
+    for(size_t k = 0;  k != compiler_phase_count;  ++k) {
+      const auto& ph = this->phases[k];
+      size_t len = ::strlen(names[k]);
+      fmt << "\n";
+      fmt.putn(names[k], len);
+      do_put_cell(fmt, "", 0, 16 - len);
+
+      nump.put_DU(ph.runs);
+      do_put_cell(fmt, nump.data(), nump.size(), 8);
+
+      // Print time with three decimal places.
+      uint64_t time_us = (uint64_t) (ph.time_ms * 1000);
+      nump.put_DU(time_us / 1000);
+      static_vector<char, 32> sbuf(nump.begin(), nump.end());
+      nump.put_DU(time_us % 1000, 3);
+      sbuf.emplace_back('.');
+      sbuf.append(nump.begin(), nump.end());
+      do_put_cell(fmt, sbuf.data(), sbuf.size(), 14);
+
+      nump.put_DI(ph.heap_bytes);
+      do_put_cell(fmt, nump.data(), nump.size(), 16);
+
+      nump.put_DU(ph.count);
+      do_put_cell(fmt, nump.data(), nump.size(), 16);
+      format(fmt, " $1", units[k]);
+    }
+
+    // Only growth is measured. Memory that is freed within the same phase
+    // does not count, so peaks are not visible.
+    fmt << "\n(heap is net growth of memory in use; peak usage is not measured)";
+    return fmt;
+  }
+
+Compiler_Statistics_Collector::
+Compiler_Statistics_Collector(Compiler_Statistics* stats_opt) noexcept
+  :
+    m_prev(s_state.stats)
+  {
+    if(!stats_opt || (stats_opt == this->m_prev))
+      return;
+
+    *stats_opt = { };
+    s_state.stats = stats_opt;
+  }
+
+Compiler_Statistics_Collector::
+~Compiler_Statistics_Collector()
+  {
+    s_state.stats = this->m_prev;
+  }
+
+Compiler_Phase_Meter::
+Compiler_Phase_Meter(Compiler_Phase index) noexcept
+  :
+    m_phase(nullptr), m_outer(nullptr), m_time_ns(0), m_heap_bytes(0)
+  {
+    if(ROCKET_EXPECT(!s_state.stats))
+      return;
+
+    int64_t time_ns = do_get_time_ns();
+    int64_t heap_bytes = do_get_heap_bytes();
+
+    // Pause the enclosing phase, if any.
+    if(auto outer = s_state.meter) {
+      outer->m_phase->time_ms += (double) (time_ns - outer->m_time_ns) * 0.000001;
+      outer->m_phase->heap_bytes += heap_bytes - outer->m_heap_bytes;
+    }
+
+    this->m_phase = &(s_state.stats->mut_phase(index));
+    this->m_phase->runs ++;
+    this->m_outer = s_state.meter;
+    s_state.meter = this;
+
+    this->m_time_ns = time_ns;
+    this->m_heap_bytes = heap_bytes;
+  }
+
+Compiler_Phase_Meter::
+~Compiler_Phase_Meter()
+  {
+    if(ROCKET_EXPECT(!this->m_phase))
+      return;
+
+    int64_t time_ns = do_get_time_ns();
+    int64_t heap_bytes = do_get_heap_bytes();
+
+    this->m_phase->time_ms += (double) (time_ns - this->m_time_ns) * 0.000001;
+    this->m_phase->heap_bytes += heap_bytes - this->m_heap_bytes;
+
+    // Resume the enclosing phase, if any.
+    s_state.meter = this->m_outer;
+    if(auto outer = this->m_outer) {
+      outer->m_time_ns = time_ns;
+      outer->m_heap_bytes = heap_bytes;
+    }
+  }
+
+}  // namespace asteria
@@ -0,0 +1,101 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_COMPILER_COMPILER_STATISTICS_
+#define ASTERIA_COMPILER_COMPILER_STATISTICS_
+
+#include "../fwd.hpp"
+namespace asteria {
+
+// These are phases of compilation, in the order in which they happen.
+enum Compiler_Phase : uint8_t
+  {
+    compiler_phase_lexing          = 0,  // `Token_Stream`
+    compiler_phase_parsing         = 1,  // `Statement_Sequence`
+    compiler_phase_generation      = 2,  // `Statement::generate_code()`
+    compiler_phase_optimization    = 3,  // `AIR_Optimizer`
+    compiler_phase_solidification  = 4,  // `AVM_Rod`
+  };
+
+constexpr size_t compiler_phase_count = 5;
+
+// These are measurements of compilation, for finding out where time and memory
+// go. As phases of nested functions run inside those of enclosing ones, each
+// phase excludes time and memory of phases that it has started.
+struct Compiler_Statistics
+  {
+    struct Phase
+      {
+        double time_ms = 0;       // wall time
+        int64_t heap_bytes = 0;   // net growth of heap memory in use, not peak
+        uint32_t runs = 0;
+        uint64_t count = 0;       // see below
+      };
+
+    // The counts are numbers of tokens, top-level statements, AIR nodes that
+    // have been generated, AIR nodes after optimization and bytes of rods,
+    // respectively.
+    Phase phases[compiler_phase_count];
+
+    const Phase&
+    phase(Compiler_Phase index) const noexcept
+      { return this->phases[index];  }
+
+    Phase&
+    mut_phase(Compiler_Phase index) noexcept
+      { return this->phases[index];  }
+
+    tinyfmt&
+    print_to(tinyfmt& fmt) const;
+  };
+
+inline
+tinyfmt&
+operator<<(tinyfmt& fmt, const Compiler_Statistics& stats)
+  { return stats.print_to(fmt);  }
+
+// This collects statistics of compilation on the current thread into an object,
+// until it is destroyed. The object is cleared first. If statistics are being
+// collected into the same object already, nothing happens.
+class Compiler_Statistics_Collector
+  {
+  private:
+    Compiler_Statistics* m_prev;
+
+  public:
+    explicit
+    Compiler_Statistics_Collector(Compiler_Statistics* stats_opt) noexcept;
+
+    Compiler_Statistics_Collector(const Compiler_Statistics_Collector&) = delete;
+    Compiler_Statistics_Collector& operator=(const Compiler_Statistics_Collector&) & = delete;
+    ~Compiler_Statistics_Collector();
+  };
+
+// This measures a phase, from its construction to its destruction. If no
+// statistics are being collected, it does nothing.
+class Compiler_Phase_Meter
+  {
+  private:
+    Compiler_Statistics::Phase* m_phase;
+    Compiler_Phase_Meter* m_outer;
+    int64_t m_time_ns;
+    int64_t m_heap_bytes;
+
+  public:
+    explicit
+    Compiler_Phase_Meter(Compiler_Phase index) noexcept;
+
+    Compiler_Phase_Meter(const Compiler_Phase_Meter&) = delete;
+    Compiler_Phase_Meter& operator=(const Compiler_Phase_Meter&) & = delete;
+    ~Compiler_Phase_Meter();
+
+    void
+    add_count(uint64_t count) noexcept
+      {
+        if(this->m_phase)
+          this->m_phase->count += count;
+      }
+  };
+
+}  // namespace asteria
+#endif
@@ -155,7 +155,7 @@ generate_code(cow_vector<AIR_Node>& code, const Compiler_Options& opts,
           optmz.reload(&ctx, altr.params, global, altr.body);
 
           AIR_Node::S_define_function xnode = { opts, altr.sloc, altr.unique_name, altr.params,
-                                                optmz.get_code() };
+                                                optmz.get_code(), { }, { } };
           code.emplace_back(move(xnode));
           return;
         }
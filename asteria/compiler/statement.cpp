@@ -26,6 +26,48 @@ do_user_declare(Analytic_Context& ctx, cow_vector<phsh_string>* names_opt, phsh_
     ctx.insert_named_reference(name);
   }
 
+void
+do_generate_lazy_captures(AIR_Node::S_define_function& defn, const Analytic_Context& ctx)
+  {
+    // The body has not been parsed, so it is not known which names refer to
+    // variables outside it. Every identifier that is not a member name and is
+    // found in an enclosing context is assumed to be captured. A reference
+    // to it is generated, as if it were in the body, so it will be captured
+    // when the function is defined. Extra captures are harmless. If such a
+    // name can't be captured, for example because it is only an object key
+    // and its initialization has been bypassed, it is left unbound, and an
+    // error is reported only if the body uses it.
+    Analytic_Context ctx_func(xtc_function, &ctx, defn.params);
+
+    for(size_t k = 0;  k < defn.lazy_tokens.size();  ++k) {
+      const auto& token = defn.lazy_tokens.at(k);
+      if(!token.is_identifier())
+        continue;
+
+      if(k && defn.lazy_tokens.at(k - 1).is_punctuator()
+         && (defn.lazy_tokens.at(k - 1).as_punctuator() == punctuator_dot))
+        continue;
+
+      phsh_string name = token.as_identifier();
+      if(find(defn.lazy_names, name) || ctx_func.get_named_reference_opt(name))
+        continue;
+
+      uint32_t depth = 1;
+      const Abstract_Context* qctx = &ctx;
+      while(qctx && !qctx->get_named_reference_opt(name)) {
+        qctx = qctx->get_parent_opt();
+        depth ++;
+      }
+
+      if(!qctx)
+        continue;
+
+      AIR_Node::S_push_local_reference xnode = { token.sloc(), depth, name };
+      defn.code_body.emplace_back(move(xnode));
+      defn.lazy_names.emplace_back(move(name));
+    }
+  }
+
 void
 do_generate_clear_stack(cow_vector<AIR_Node>& code)
   {
@@ -167,14 +209,14 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
               if(decl.init.units.empty()) {
                 // Declare a variable with default initialization.
                 AIR_Node::S_define_null_variable xnode_decl = { decl.sloc, altr.immutable,
-                                                                decl.names.at(0) };
+                                                                decl.names.at(0), false };
                 code.emplace_back(move(xnode_decl));
               }
               else {
                 // Evaluate the initializer.
                 do_generate_clear_stack(code);
 
-                AIR_Node::S_declare_variable xnode_decl = { decl.sloc, decl.names.at(0) };
+                AIR_Node::S_declare_variable xnode_decl = { decl.sloc, decl.names.at(0), false };
                 code.emplace_back(move(xnode_decl));
 
                 // Generate code for the initializer.
@@ -194,7 +236,7 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
                 // Declare variables with default initialization.
                 for(uint32_t k = 1;  k != decl.names.size() - 1;  ++k) {
                   AIR_Node::S_define_null_variable xnode_decl = { decl.sloc, altr.immutable,
-                                                                  decl.names.at(k) };
+                                                                  decl.names.at(k), false };
                   code.emplace_back(move(xnode_decl));
                 }
               }
@@ -203,7 +245,7 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
                 do_generate_clear_stack(code);
 
                 for(uint32_t k = 1;  k != decl.names.size() - 1;  ++k) {
-                  AIR_Node::S_declare_variable xnode_decl = { decl.sloc, decl.names.at(k) };
+                  AIR_Node::S_declare_variable xnode_decl = { decl.sloc, decl.names.at(k), false };
                   code.emplace_back(move(xnode_decl));
                 }
 
@@ -224,7 +266,8 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
               if(decl.init.units.empty()) {
                 // Declare variables with default initialization.
                 for(uint32_t k = 1;  k != decl.names.size() - 1;  ++k) {
-                  AIR_Node::S_define_null_variable xnode_decl = { decl.sloc, altr.immutable, decl.names.at(k) };
+                  AIR_Node::S_define_null_variable xnode_decl = { decl.sloc, altr.immutable,
+                                                                  decl.names.at(k), false };
                   code.emplace_back(move(xnode_decl));
                 }
               }
@@ -233,7 +276,7 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
                 do_generate_clear_stack(code);
 
                 for(uint32_t k = 1;  k != decl.names.size() - 1;  ++k) {
-                  AIR_Node::S_declare_variable xnode_decl = { decl.sloc, decl.names.at(k) };
+                  AIR_Node::S_declare_variable xnode_decl = { decl.sloc, decl.names.at(k), false };
                   code.emplace_back(move(xnode_decl));
                 }
 
@@ -260,16 +303,25 @@ generate_code(cow_vector<AIR_Node>& code, Analytic_Context& ctx,
           do_user_declare(ctx, names_opt, altr.name);
 
           // Declare the function, which is effectively an immutable variable.
-          AIR_Node::S_declare_variable xnode_decl = { altr.sloc, altr.name };
+          AIR_Node::S_declare_variable xnode_decl = { altr.sloc, altr.name, false };
           code.emplace_back(move(xnode_decl));
 
-          // Generate code
-          AIR_Optimizer optmz(opts);
-          optmz.reload(&ctx, altr.params, global, altr.body);
-
-          AIR_Node::S_define_function xnode_defn = { opts, altr.sloc, altr.name, altr.params,
-                                                     optmz.get_code() };
-          code.emplace_back(move(xnode_defn));
+          if(!altr.lazy_tokens.empty()) {
+            // Generate references to names that the body may capture.
+            AIR_Node::S_define_function xnode_defn = { opts, altr.sloc, altr.name, altr.params,
+                                                       { }, altr.lazy_tokens, { } };
+            do_generate_lazy_captures(xnode_defn, ctx);
+            code.emplace_back(move(xnode_defn));
+          }
+          else {
+            // Generate code
+            AIR_Optimizer optmz(opts);
+            optmz.reload(&ctx, altr.params, global, altr.body);
+
+            AIR_Node::S_define_function xnode_defn = { opts, altr.sloc, altr.name, altr.params,
+                                                       optmz.get_code(), { }, { } };
+            code.emplace_back(move(xnode_defn));
+          }
 
           // Initialize the function.
           AIR_Node::S_initialize_variable xnode = { altr.sloc, true };
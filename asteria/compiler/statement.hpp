@@ -6,6 +6,7 @@
 
 #include "../fwd.hpp"
 #include "../source_location.hpp"
+#include "token.hpp"
 namespace asteria {
 
 class Statement
@@ -41,6 +42,7 @@ class Statement
         phsh_string name;
         cow_vector<phsh_string> params;
         cow_vector<Statement> body;
+        cow_vector<Token> lazy_tokens;  // if not empty, `body` is not parsed
       };
 
     struct S_if
@@ -9,6 +9,7 @@
 #include "expression_unit.hpp"
 #include "statement.hpp"
 #include "infix_element.hpp"
+#include "compiler_statistics.hpp"
 #include "enums.hpp"
 #include "../runtime/enums.hpp"
 #include "../utils.hpp"
@@ -585,6 +586,29 @@ do_accept_reference_definition_opt(Token_Stream& tstrm)
     return move(xstmt);
   }
 
+cow_vector<Statement>
+do_accept_function_body(Token_Stream& tstrm, const Source_Location& op_sloc)
+  {
+    // function-body ::=
+    //   statement * "}"
+    // This is not the same as a block due to the implicit `return;` at the end.
+    cow_vector<Statement> body;
+    while(auto qstmt = do_accept_statement_opt(tstrm, scope_plain))
+      body.emplace_back(move(*qstmt));
+
+    auto cl_sloc = tstrm.next_sloc();
+    auto kpunct = do_accept_punctuator_opt(tstrm, { punctuator_brace_cl });
+    if(!kpunct)
+      throw Compiler_Error(xtc_status_format,
+                compiler_status_closing_brace_or_statement_expected, tstrm.next_sloc(),
+                "[unmatched `{` at '$1']", op_sloc);
+
+    // Add an implicit return.
+    Statement::S_return xendf = { move(cl_sloc), true, Statement::S_expression() };
+    body.emplace_back(move(xendf));
+    return body;
+  }
+
 opt<Statement>
 do_accept_function_definition_opt(Token_Stream& tstrm)
   {
@@ -644,30 +668,40 @@ do_accept_function_definition_opt(Token_Stream& tstrm)
                 tstrm.next_sloc(),
                 "[unmatched `(` at '$1']", op_sloc);
 
-    // Parse the function body. This is not the same as a block due to the implicit
-    // `return;` at the end.
     op_sloc = tstrm.next_sloc();
     kpunct = do_accept_punctuator_opt(tstrm, { punctuator_brace_op });
     if(!kpunct)
       throw Compiler_Error(xtc_status,
                 compiler_status_open_brace_expected, tstrm.next_sloc());
 
-    cow_vector<Statement> body;
-    while(auto qstmt = do_accept_statement_opt(tstrm, scope_plain))
-      body.emplace_back(move(*qstmt));
-
-    auto cl_sloc = tstrm.next_sloc();
-    kpunct = do_accept_punctuator_opt(tstrm, { punctuator_brace_cl });
-    if(!kpunct)
-      throw Compiler_Error(xtc_status_format,
-                compiler_status_closing_brace_or_statement_expected, tstrm.next_sloc(),
-                "[unmatched `{` at '$1']", op_sloc);
+    if(tstrm.get_options().lazy_function_bodies) {
+      // Only look for the matching closing brace. The body will be parsed when
+      // the function is called for the first time.
+      cow_vector<Token> lazy_tokens;
+      size_t depth = 1;
+      while(depth != 0) {
+        auto qtok = tstrm.peek_opt();
+        if(!qtok)
+          throw Compiler_Error(xtc_status_format,
+                    compiler_status_closing_brace_or_statement_expected, tstrm.next_sloc(),
+                    "[unmatched `{` at '$1']", op_sloc);
+
+        if(qtok->is_punctuator() && (qtok->as_punctuator() == punctuator_brace_op))
+          depth ++;
+        else if(qtok->is_punctuator() && (qtok->as_punctuator() == punctuator_brace_cl))
+          depth --;
+
+        lazy_tokens.emplace_back(*qtok);
+        tstrm.shift();
+      }
 
-    // Add an implicit return.
-    Statement::S_return xendf = { move(cl_sloc), true, Statement::S_expression() };
-    body.emplace_back(move(xendf));
+      Statement::S_function xstmt = { move(sloc), move(*qname), move(params), { },
+                                      move(lazy_tokens) };
+      return move(xstmt);
+    }
 
-    Statement::S_function xstmt = { move(sloc), move(*qname), move(params), move(body) };
+    auto body = do_accept_function_body(tstrm, op_sloc);
+    Statement::S_function xstmt = { move(sloc), move(*qname), move(params), move(body), { } };
     return move(xstmt);
   }
 
@@ -2601,6 +2635,7 @@ reload(Token_Stream&& tstrm)
     cow_vector<Statement> stmts;
     this->m_stmts.clear();
     stmts.swap(this->m_stmts);
+    Compiler_Phase_Meter meter(compiler_phase_parsing);
 
     // document ::=
     //   statement *
@@ -2617,6 +2652,28 @@ reload(Token_Stream&& tstrm)
     stmts.emplace_back(move(xendf));
 
     // Succeed.
+    meter.add_count(stmts.size());
+    this->m_stmts = move(stmts);
+  }
+
+void
+Statement_Sequence::
+reload_function_body(Token_Stream&& tstrm)
+  {
+    // Destroy the contents of `*this`.
+    this->m_stmts.clear();
+    Compiler_Phase_Meter meter(compiler_phase_parsing);
+
+    // The body ends with the closing brace.
+    auto stmts = do_accept_function_body(tstrm, tstrm.next_sloc());
+
+    // If there are any non-statement tokens left in the stream, fail.
+    if(!tstrm.empty())
+      throw Compiler_Error(xtc_status,
+                compiler_status_statement_expected, tstrm.next_sloc());
+
+    // Succeed.
+    meter.add_count(stmts.size());
     this->m_stmts = move(stmts);
   }
 
@@ -2628,6 +2685,7 @@ reload_oneline(Token_Stream&& tstrm)
     cow_vector<Statement> stmts;
     this->m_stmts.clear();
     stmts.swap(this->m_stmts);
+    Compiler_Phase_Meter meter(compiler_phase_parsing);
 
     // Parse an expression. This is required.
     auto kexpr = do_accept_expression_opt(tstrm);
@@ -2645,6 +2703,7 @@ reload_oneline(Token_Stream&& tstrm)
     stmts.emplace_back(move(xstmt));
 
     // Succeed.
+    meter.add_count(stmts.size());
     this->m_stmts = move(stmts);
   }
 
@@ -60,6 +60,12 @@ class Statement_Sequence
     void
     reload(Token_Stream&& tstrm);
 
+    // This function parses the body of a function whose parsing has been
+    // deferred, including the closing brace, as a series of statements.
+    // This function throws a `Compiler_Error` upon failure.
+    void
+    reload_function_body(Token_Stream&& tstrm);
+
     // This function parses a single expression (without trailing
     // semicolons) instead of a series of statements, as a `return`
     // statement.
@@ -6,28 +6,163 @@
 #include "enums.hpp"
 #include "token.hpp"
 #include "compiler_error.hpp"
+#include "compiler_statistics.hpp"
 #include "../utils.hpp"
 namespace asteria {
 namespace {
 
+// These functions return the number of leading characters of `str` that belong
+// to a class. Sixteen characters are examined at a time where SSE2 is available.
+size_t
+do_span_ascii(const char* str, size_t len) noexcept
+  {
+    // Characters that need no UTF-8 decoding, i.e. non-null ASCII ones.
+    size_t n = 0;
+#ifdef __SSE2__
+    while(len - n >= 16) {
+      __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + n));
+      __m128i m = _mm_cmpeq_epi8(t, _mm_setzero_si128());
+      uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(t, m)));
+      if(bits != 0)
+        return n + static_cast<uint32_t>(__builtin_ctz(bits));
+      n += 16;
+    }
+#endif  // __SSE2__
+    while((n != len) && (static_cast<uint8_t>(str[n] - 1) < 0x7F))
+      n ++;
+    return n;
+  }
+
+size_t
+do_span_blanks(const char* str, size_t len) noexcept
+  {
+    // Spaces and tabs, which make up the vast majority of whitespace.
+    size_t n = 0;
+#ifdef __SSE2__
+    while(len - n >= 16) {
+      __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + n));
+      __m128i m = _mm_or_si128(_mm_cmpeq_epi8(t, _mm_set1_epi8(' ')),
+                               _mm_cmpeq_epi8(t, _mm_set1_epi8('\t')));
+      uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(m)) ^ 0xFFFFU;
+      if(bits != 0)
+        return n + static_cast<uint32_t>(__builtin_ctz(bits));
+      n += 16;
+    }
+#endif  // __SSE2__
+    while((n != len) && ((str[n] == ' ') || (str[n] == '\t')))
+      n ++;
+    return n;
+  }
+
+size_t
+do_span_name(const char* str, size_t len) noexcept
+  {
+    // Letters, digits and underscores. Characters outside ASCII compare less
+    // than all of these as signed bytes.
+    size_t n = 0;
+#ifdef __SSE2__
+    while(len - n >= 16) {
+      __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + n));
+      __m128i l = _mm_or_si128(t, _mm_set1_epi8(0x20));
+      __m128i m = _mm_and_si128(_mm_cmpgt_epi8(l, _mm_set1_epi8('a' - 1)),
+                                _mm_cmplt_epi8(l, _mm_set1_epi8('z' + 1)));
+      m = _mm_or_si128(m, _mm_and_si128(_mm_cmpgt_epi8(t, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(t, _mm_set1_epi8('9' + 1))));
+      m = _mm_or_si128(m, _mm_cmpeq_epi8(t, _mm_set1_epi8('_')));
+      uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(m)) ^ 0xFFFFU;
+      if(bits != 0)
+        return n + static_cast<uint32_t>(__builtin_ctz(bits));
+      n += 16;
+    }
+#endif  // __SSE2__
+    while((n != len) && is_cmask(str[n], cmask_namei | cmask_digit))
+      n ++;
+    return n;
+  }
+
+size_t
+do_span_string_body(const char* str, size_t len, char head, bool escapable) noexcept
+  {
+    // Characters that can be copied from a string literal as is.
+    size_t n = 0;
+#ifdef __SSE2__
+    __m128i esc = _mm_set1_epi8(escapable ? '\\' : head);
+    while(len - n >= 16) {
+      __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + n));
+      __m128i m = _mm_or_si128(_mm_cmpeq_epi8(t, _mm_set1_epi8(head)),
+                               _mm_cmpeq_epi8(t, esc));
+      uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(m));
+      if(bits != 0)
+        return n + static_cast<uint32_t>(__builtin_ctz(bits));
+      n += 16;
+    }
+#endif  // __SSE2__
+    while((n != len) && (str[n] != head) && (!escapable || (str[n] != '\\')))
+      n ++;
+    return n;
+  }
+
+// Interned strings are looked up with characters from the source, so no
+// string is allocated unless it is seen for the first time.
+struct Source_Span
+  {
+    const char* ptr;
+    size_t len;
+  };
+
+struct Interned_Hash
+  {
+    size_t
+    operator()(const phsh_string& str) const noexcept
+      { return str.rdhash();  }
+
+    size_t
+    operator()(const Source_Span& span) const noexcept
+      { return cow_string::hash()(span.ptr, span.len);  }
+  };
+
+struct Interned_Equal
+  {
+    bool
+    operator()(const phsh_string& lhs, const phsh_string& rhs) const noexcept
+      { return lhs == rhs;  }
+
+    bool
+    operator()(const phsh_string& lhs, const Source_Span& rhs) const noexcept
+      {
+        return (lhs.size() == rhs.len)
+               && (::memcmp(lhs.rdstr().data(), rhs.ptr, rhs.len) == 0);
+      }
+  };
+
 class Text_Reader
   {
   private:
-    tinybuf& m_cbuf;
+    tinybuf* m_cbuf_opt;
+    const char* m_bptr;  // remaining characters if `m_cbuf_opt` is null
+    const char* m_eptr;
     cow_string m_file;
     int m_line = 0;
 
     // current line
+    const char* m_lptr = "";
+    size_t m_llen = 0;
     size_t m_off = 0;
     cow_string m_str;
 
     // string cache
-    cow_dictionary<bool> m_interned_strings;
+    ::rocket::cow_hashmap<phsh_string, bool, Interned_Hash, Interned_Equal> m_interned_strings;
 
   public:
     Text_Reader(tinybuf& xcbuf, cow_stringR xfile, int xline)
       :
-        m_cbuf(xcbuf), m_file(xfile), m_line(xline)
+        m_cbuf_opt(&xcbuf), m_bptr(nullptr), m_eptr(nullptr), m_file(xfile), m_line(xline)
+      {
+      }
+
+    Text_Reader(const char* xstr, size_t xlen, cow_stringR xfile, int xline)
+      :
+        m_cbuf_opt(nullptr), m_bptr(xstr), m_eptr(xstr + xlen), m_file(xfile), m_line(xline)
       {
       }
 
@@ -54,27 +189,49 @@ class Text_Reader
     advance()
       {
         this->m_off = 0;
-        bool succ = getline(this->m_str, this->m_cbuf);
-        this->m_line += succ;
-        return succ;
+
+        if(this->m_cbuf_opt) {
+          // Copy the next line from the stream.
+          bool succ = getline(this->m_str, *(this->m_cbuf_opt));
+          this->m_lptr = this->m_str.data();
+          this->m_llen = this->m_str.size();
+          this->m_line += succ;
+          return succ;
+        }
+
+        if(this->m_bptr == this->m_eptr)
+          return false;
+
+        // Reference the next line in place.
+        size_t rlen = static_cast<size_t>(this->m_eptr - this->m_bptr);
+        auto eol = static_cast<const char*>(::memchr(this->m_bptr, '\n', rlen));
+        if(!eol)
+          eol = this->m_eptr;
+
+        this->m_lptr = this->m_bptr;
+        this->m_llen = static_cast<size_t>(eol - this->m_bptr);
+        this->m_bptr = eol + (eol != this->m_eptr);
+        this->m_line ++;
+        return true;
       }
 
     size_t
     navail() const noexcept
       {
-        return this->m_str.size() - this->m_off;
+        return this->m_llen - this->m_off;
       }
 
     const char*
     data(size_t nadd = 0) const noexcept
       {
-        return (nadd <= this->navail()) ? (this->m_str.data() + this->m_off + nadd) : "";
+        return (nadd <= this->navail()) ? (this->m_lptr + this->m_off + nadd) : "";
       }
 
     char
     peek(size_t nadd = 0) const noexcept
       {
-         return *(this->data(nadd));
+         // Lines are not null-terminated in place.
+         return (nadd < this->navail()) ? this->m_lptr[this->m_off + nadd] : '\0';
       }
 
     bool
@@ -96,10 +253,23 @@ class Text_Reader
         this->m_off = 0;
       }
 
+    const phsh_string&
+    intern_string(const char* str, size_t len)
+      {
+        Source_Span span = { str, len };
+        auto it = this->m_interned_strings.find(span);
+        if(it != this->m_interned_strings.end())
+          return it->first;
+
+        it = this->m_interned_strings.try_emplace(cow_string(str, len)).first;
+        return it->first;
+      }
+
     const phsh_string&
     intern_string(cow_string&& val)
       {
-        auto it = this->m_interned_strings.find(val);
+        Source_Span span = { val.data(), val.size() };
+        auto it = this->m_interned_strings.find(span);
         if(it != this->m_interned_strings.end())
           return it->first;
 
@@ -508,7 +678,20 @@ do_accept_string_literal(cow_vector<Token>& tokens, Text_Reader& reader, char he
     size_t tlen = 1;
     cow_string val;
 
+    // If the literal contains no escape sequence, it is interned from the
+    // source directly.
+    size_t slen = do_span_string_body(reader.data(tlen), reader.navail() - tlen, head, escapable);
+    if(reader.peek(tlen + slen) == head) {
+      Token::S_string_literal xtoken = { reader.intern_string(reader.data(tlen), slen) };
+      return do_push_token(tokens, reader, tlen + slen + 1, move(xtoken));
+    }
+
     for(;;) {
+      // Copy characters that need no translation in bulk.
+      slen = do_span_string_body(reader.data(tlen), reader.navail() - tlen, head, escapable);
+      val.append(reader.data(tlen), slen);
+      tlen += slen;
+
       // Read a character.
       char next = reader.peek(tlen);
       if(next == 0)
@@ -719,8 +902,7 @@ do_accept_identifier_or_keyword(cow_vector<Token>& tokens, Text_Reader& reader,
       return false;
 
     // Check for keywords if not otherwise disabled.
-    size_t tlen = 0;
-    do_cmask_length(tlen, reader, cmask_namei | cmask_digit);
+    size_t tlen = do_span_name(reader.data(), reader.navail());
 
     if(!keywords_as_identifiers) {
       auto r = do_prefix_range(s_keywords, reader.peek());
@@ -739,36 +921,18 @@ do_accept_identifier_or_keyword(cow_vector<Token>& tokens, Text_Reader& reader,
     }
 
     // Accept a plain identifier.
-    cow_string name;
-    name.assign(reader.data(), tlen);
-
-    Token::S_identifier xtoken = { reader.intern_string(move(name)) };
+    Token::S_identifier xtoken = { reader.intern_string(reader.data(), tlen) };
     return do_push_token(tokens, reader, tlen, move(xtoken));
   }
 
-}  // namespace
-
-Token_Stream::
-~Token_Stream()
-  {
-  }
-
 void
-Token_Stream::
-reload(cow_stringR file, int start_line, tinybuf&& cbuf)
+do_tokenize(cow_vector<Token>& tokens, Text_Reader& reader, const Compiler_Options& opts,
+            int start_line)
   {
-    // Tokens are parsed and stored here in normal order.
-    // We will have to reverse this sequence before storing it into `*this` if
-    // it is accepted. The storage may be reused.
-    cow_vector<Token> tokens;
-    tokens.swap(this->m_rtoks);
-    tokens.clear();
-
     // Save the position of an unterminated block comment.
     opt<Source_Location> bcomm;
 
     // Read source code line by line.
-    Text_Reader reader(cbuf, file, start_line);
     while(reader.advance()) {
       if(reader.line() == start_line) {
         // Remove the UTF-8 BOM, if any.
@@ -788,6 +952,12 @@ reload(cow_stringR file, int start_line, tinybuf&& cbuf)
 
       // Ensure this line is a valid UTF-8 string.
       while(reader.navail() != 0) {
+        // Skip ASCII characters in bulk.
+        size_t alen = do_span_ascii(reader.data(), reader.navail());
+        reader.consume(alen);
+        if(reader.navail() == 0)
+          break;
+
         // Decode a code point.
         char32_t cp;
         auto tptr = reader.data();
@@ -812,20 +982,25 @@ reload(cow_stringR file, int start_line, tinybuf&& cbuf)
         // Are we inside a block comment?
         if(bcomm) {
           // Search for the terminator of this block comment.
-          auto tptr = ::strstr(reader.data(), "*/");
+          auto tptr = static_cast<const char*>(::memchr(reader.data(), '*', reader.navail()));
           if(!tptr)
             break;
 
-          // Finish this comment and resume from the end of it.
-          bcomm.reset();
-          reader.consume(static_cast<size_t>(tptr + 2 - reader.data()));
+          // Finish this comment if the asterisk is followed by a slash.
+          size_t clen = static_cast<size_t>(tptr + 1 - reader.data());
+          if(reader.peek(clen) == '/') {
+            bcomm.reset();
+            clen ++;
+          }
+          reader.consume(clen);
           continue;
         }
 
         // Read a character.
         if(is_cmask(reader.peek(), cmask_space)) {
-          // Skip a space.
-          reader.consume(1);
+          // Skip spaces. Blanks are skipped in bulk.
+          size_t slen = do_span_blanks(reader.data(), reader.navail());
+          reader.consume(::rocket::max(slen, (size_t) 1));
           continue;
         }
 
@@ -843,13 +1018,13 @@ reload(cow_stringR file, int start_line, tinybuf&& cbuf)
         }
 
         bool found = do_accept_numeric_literal(tokens, reader,
-                                   this->m_opts.integers_as_reals) ||
+                                   opts.integers_as_reals) ||
                      do_accept_punctuator(tokens, reader) ||
                      do_accept_string_literal(tokens, reader, '\"', true) ||
                      do_accept_string_literal(tokens, reader, '\'',
-                                   this->m_opts.escapable_single_quotes) ||
+                                   opts.escapable_single_quotes) ||
                      do_accept_identifier_or_keyword(tokens, reader,
-                                   this->m_opts.keywords_as_identifiers);
+                                   opts.keywords_as_identifiers);
         if(!found)
           throw Compiler_Error(xtc_status,
                     compiler_status_token_character_unrecognized, reader.tell());
@@ -863,10 +1038,62 @@ reload(cow_stringR file, int start_line, tinybuf&& cbuf)
       throw Compiler_Error(xtc_format,
                 compiler_status_block_comment_unclosed, reader.tell(),
                 "Block comment unclosed\n[unmatched `/*` at '$1']", *bcomm);
+  }
+
+}  // namespace
+
+Token_Stream::
+~Token_Stream()
+  {
+  }
+
+void
+Token_Stream::
+reload(cow_stringR file, int start_line, tinybuf&& cbuf)
+  {
+    // Tokens are parsed and stored here in normal order.
+    // We will have to reverse this sequence before storing it into `*this` if
+    // it is accepted. The storage may be reused.
+    cow_vector<Token> tokens;
+    tokens.swap(this->m_rtoks);
+    tokens.clear();
+
+    Compiler_Phase_Meter meter(compiler_phase_lexing);
+    Text_Reader reader(cbuf, file, start_line);
+    do_tokenize(tokens, reader, this->m_opts, start_line);
+    meter.add_count(tokens.size());
 
     // Reverse the token sequence and accept it.
     ::std::reverse(tokens.mut_begin(), tokens.mut_end());
     this->m_rtoks = move(tokens);
   }
 
+void
+Token_Stream::
+reload(cow_stringR file, int start_line, const char* str, size_t len)
+  {
+    // This is the same as above, but lines are not copied.
+    cow_vector<Token> tokens;
+    tokens.swap(this->m_rtoks);
+    tokens.clear();
+
+    Compiler_Phase_Meter meter(compiler_phase_lexing);
+    Text_Reader reader(str, len, file, start_line);
+    do_tokenize(tokens, reader, this->m_opts, start_line);
+    meter.add_count(tokens.size());
+
+    // Reverse the token sequence and accept it.
+    ::std::reverse(tokens.mut_begin(), tokens.mut_end());
+    this->m_rtoks = move(tokens);
+  }
+
+
+void
+Token_Stream::
+reload(const cow_vector<Token>& tokens)
+  {
+    this->m_rtoks.clear();
+    this->m_rtoks.append(tokens.rbegin(), tokens.rend());
+  }
+
 }  // namespace asteria
@@ -87,6 +87,19 @@ class Token_Stream
     // This function throws a `Compiler_Error` upon failure.
     void
     reload(cow_stringR file, int start_line, tinybuf&& cbuf);
+
+    // This function parses characters from a contiguous buffer, which need
+    // only be valid until this function returns. It is faster than the
+    // other overload, as lines are not copied and characters are scanned in
+    // blocks.
+    // This function throws a `Compiler_Error` upon failure.
+    void
+    reload(cow_stringR file, int start_line, const char* str, size_t len);
+
+    // This function loads tokens that have been taken from another stream,
+    // in their original order. The contents of `*this` are destroyed.
+    void
+    reload(const cow_vector<Token>& tokens);
   };
 
 }  // namespace asteria
@@ -154,11 +154,13 @@ class Abstract_Context;
 class Analytic_Context;
 class Executive_Context;
 class Global_Context;
+class Global_Context_Handle;
 class Garbage_Collector;
 class Random_Engine;
 class Module_Loader;
 class Variadic_Arguer;
 class Instantiated_Function;
+class Coroutine;
 class AIR_Node;
 class Argument_Reader;
 class Binding_Generator;
@@ -841,6 +843,12 @@ template<>
 struct Compiler_Options_fragment<2>
   {
     // Note: Please keep this struct as compact as possible.
+
+    // Parse bodies of function definitions only when they are called for the
+    // first time. Syntax errors in bodies of functions that are never called
+    // are not diagnosed.
+    // [useful for large modules of which only a few functions are used]
+    bool lazy_function_bodies = false;
   };
 
 // These are aliases for historical versions.
@@ -0,0 +1,143 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "../xprecompiled.hpp"
+#include "coroutine.hpp"
+#include "../runtime/coroutine.hpp"
+#include "../runtime/argument_reader.hpp"
+#include "../runtime/binding_generator.hpp"
+#include "../runtime/global_context.hpp"
+#include "../runtime/runtime_error.hpp"
+#include "../utils.hpp"
+namespace asteria {
+namespace {
+
+void
+do_construct_Coroutine(V_object& result, V_function body)
+  {
+    static constexpr auto s_private_uuid = &"{1E5E8E40-6F2B-4A35-9C71-2B0C7F6D3A18}";
+    result.insert_or_assign(s_private_uuid, std_coroutine_Coroutine_private(body));
+
+    result.insert_or_assign(&"resume",
+      ASTERIA_BINDING(
+        "std.coroutine.Coroutine::resume", "[value]",
+        Global_Context& global, Reference&& self, Argument_Reader&& reader)
+      {
+        // Hold a reference, as the object may be modified by the body.
+        auto co = self.dereference_readonly().as_object().at(s_private_uuid).as_opaque();
+        Value value;
+
+        reader.start_overload();
+        reader.optional(value);
+        if(reader.end_overload())
+          return (Value) std_coroutine_Coroutine_resume(global, co, value);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"done",
+      ASTERIA_BINDING(
+        "std.coroutine.Coroutine::done", "",
+        Reference&& self, Argument_Reader&& reader)
+      {
+        auto co = self.dereference_readonly().as_object().at(s_private_uuid).as_opaque();
+
+        reader.start_overload();
+        if(reader.end_overload())
+          return (Value) std_coroutine_Coroutine_done(co);
+
+        reader.throw_no_matching_function_call();
+      });
+  }
+
+}  // namespace
+
+V_object
+std_coroutine_Coroutine(V_function body)
+  {
+    V_object result;
+    do_construct_Coroutine(result, body);
+    return result;
+  }
+
+V_opaque
+std_coroutine_Coroutine_private(V_function body)
+  {
+    return ::rocket::make_refcnt<Coroutine>(body);
+  }
+
+Value
+std_coroutine_Coroutine_resume(Global_Context& global, V_opaque& r, Value value)
+  {
+    return r.open<Coroutine>().resume(global, value);
+  }
+
+V_boolean
+std_coroutine_Coroutine_done(V_opaque& r)
+  {
+    return r.open<Coroutine>().state() == Coroutine::state_finished;
+  }
+
+Value
+std_coroutine_yield(Global_Context& global, Value value)
+  {
+    auto co = global.get_coroutine_opt();
+    if(!co)
+      ASTERIA_THROW(("`yield` called outside a coroutine"));
+
+    return co->yield(value);
+  }
+
+V_boolean
+std_coroutine_is_running(Global_Context& global)
+  {
+    return global.get_coroutine_opt() != nullptr;
+  }
+
+void
+create_bindings_coroutine(V_object& result, API_Version /*version*/)
+  {
+    result.insert_or_assign(&"Coroutine",
+      ASTERIA_BINDING(
+        "std.coroutine.Coroutine", "body",
+        Argument_Reader&& reader)
+      {
+        V_function body;
+
+        reader.start_overload();
+        reader.required(body);
+        if(reader.end_overload())
+          return (Value) std_coroutine_Coroutine(body);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"yield",
+      ASTERIA_BINDING(
+        "std.coroutine.yield", "[value]",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        Value value;
+
+        reader.start_overload();
+        reader.optional(value);
+        if(reader.end_overload())
+          return (Value) std_coroutine_yield(global, value);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"is_running",
+      ASTERIA_BINDING(
+        "std.coroutine.is_running", "",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        reader.start_overload();
+        if(reader.end_overload())
+          return (Value) std_coroutine_is_running(global);
+
+        reader.throw_no_matching_function_call();
+      });
+  }
+
+}  // namespace asteria
@@ -0,0 +1,36 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_LIBRARY_COROUTINE_
+#define ASTERIA_LIBRARY_COROUTINE_
+
+#include "../fwd.hpp"
+namespace asteria {
+
+// `std.coroutine.Coroutine`
+V_object
+std_coroutine_Coroutine(V_function body);
+
+V_opaque
+std_coroutine_Coroutine_private(V_function body);
+
+Value
+std_coroutine_Coroutine_resume(Global_Context& global, V_opaque& r, Value value);
+
+V_boolean
+std_coroutine_Coroutine_done(V_opaque& r);
+
+// `std.coroutine.yield`
+Value
+std_coroutine_yield(Global_Context& global, Value value);
+
+// `std.coroutine.is_running`
+V_boolean
+std_coroutine_is_running(Global_Context& global);
+
+// Create an object that is to be referenced as `std.coroutine`.
+void
+create_bindings_coroutine(V_object& result, API_Version version);
+
+}  // namespace asteria
+#endif
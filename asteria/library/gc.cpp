@@ -56,6 +56,62 @@ std_gc_set_threshold(Global_Context& global, V_integer generation, V_integer thr
     return static_cast<int64_t>(oldval);
   }
 
+V_integer
+std_gc_get_slice_size(Global_Context& global)
+  {
+    // Get the maximum number of variables to examine at a time.
+    const auto gcoll = global.garbage_collector();
+    size_t nvars = gcoll->get_slice_size();
+    return static_cast<int64_t>(nvars);
+  }
+
+V_integer
+std_gc_set_slice_size(Global_Context& global, V_integer size)
+  {
+    // Set the slice size and return its old value.
+    const auto gcoll = global.garbage_collector();
+    size_t oldval = gcoll->get_slice_size();
+    gcoll->set_slice_size(::rocket::clamp_cast<size_t>(size, 0, PTRDIFF_MAX));
+    return static_cast<int64_t>(oldval);
+  }
+
+V_boolean
+std_gc_get_adaptive(Global_Context& global)
+  {
+    // Check whether thresholds are tuned automatically.
+    const auto gcoll = global.garbage_collector();
+    return gcoll->is_adaptive();
+  }
+
+V_boolean
+std_gc_set_adaptive(Global_Context& global, V_boolean enable)
+  {
+    // Enable or disable adaptive thresholds and return the old state.
+    const auto gcoll = global.garbage_collector();
+    bool oldval = gcoll->is_adaptive();
+    gcoll->set_adaptive(enable);
+    return oldval;
+  }
+
+V_integer
+std_gc_get_ceiling(Global_Context& global)
+  {
+    // Get the number of variables that forces garbage collection.
+    const auto gcoll = global.garbage_collector();
+    size_t nvars = gcoll->get_variable_ceiling();
+    return static_cast<int64_t>(nvars);
+  }
+
+V_integer
+std_gc_set_ceiling(Global_Context& global, V_integer count)
+  {
+    // Set the ceiling and return its old value.
+    const auto gcoll = global.garbage_collector();
+    size_t oldval = gcoll->get_variable_ceiling();
+    gcoll->set_variable_ceiling(::rocket::clamp_cast<size_t>(count, 0, PTRDIFF_MAX));
+    return static_cast<int64_t>(oldval);
+  }
+
 V_integer
 std_gc_collect(Global_Context& global, optV_integer generation_limit)
   {
@@ -123,6 +179,87 @@ create_bindings_gc(V_object& result, API_Version /*version*/)
         reader.throw_no_matching_function_call();
       });
 
+    result.insert_or_assign(&"get_slice_size",
+      ASTERIA_BINDING(
+        "std.gc.get_slice_size", "",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        reader.start_overload();
+        if(reader.end_overload())
+          return (Value) std_gc_get_slice_size(global);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"set_slice_size",
+      ASTERIA_BINDING(
+        "std.gc.set_slice_size", "size",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        V_integer size;
+
+        reader.start_overload();
+        reader.required(size);
+        if(reader.end_overload())
+          return (Value) std_gc_set_slice_size(global, size);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"get_adaptive",
+      ASTERIA_BINDING(
+        "std.gc.get_adaptive", "",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        reader.start_overload();
+        if(reader.end_overload())
+          return (Value) std_gc_get_adaptive(global);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"set_adaptive",
+      ASTERIA_BINDING(
+        "std.gc.set_adaptive", "enable",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        V_boolean enable;
+
+        reader.start_overload();
+        reader.required(enable);
+        if(reader.end_overload())
+          return (Value) std_gc_set_adaptive(global, enable);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"get_ceiling",
+      ASTERIA_BINDING(
+        "std.gc.get_ceiling", "",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        reader.start_overload();
+        if(reader.end_overload())
+          return (Value) std_gc_get_ceiling(global);
+
+        reader.throw_no_matching_function_call();
+      });
+
+    result.insert_or_assign(&"set_ceiling",
+      ASTERIA_BINDING(
+        "std.gc.set_ceiling", "count",
+        Global_Context& global, Argument_Reader&& reader)
+      {
+        V_integer count;
+
+        reader.start_overload();
+        reader.required(count);
+        if(reader.end_overload())
+          return (Value) std_gc_set_ceiling(global, count);
+
+        reader.throw_no_matching_function_call();
+      });
+
     result.insert_or_assign(&"collect",
       ASTERIA_BINDING(
         "std.gc.collect", "[generation_limit]",
@@ -19,6 +19,30 @@ std_gc_get_threshold(Global_Context& global, V_integer generation);
 V_integer
 std_gc_set_threshold(Global_Context& global, V_integer generation, V_integer threshold);
 
+// `std.gc.get_slice_size`
+V_integer
+std_gc_get_slice_size(Global_Context& global);
+
+// `std.gc.set_slice_size`
+V_integer
+std_gc_set_slice_size(Global_Context& global, V_integer size);
+
+// `std.gc.get_adaptive`
+V_boolean
+std_gc_get_adaptive(Global_Context& global);
+
+// `std.gc.set_adaptive`
+V_boolean
+std_gc_set_adaptive(Global_Context& global, V_boolean enable);
+
+// `std.gc.get_ceiling`
+V_integer
+std_gc_get_ceiling(Global_Context& global);
+
+// `std.gc.set_ceiling`
+V_integer
+std_gc_set_ceiling(Global_Context& global, V_integer count);
+
 // `std.gc.collect`
 V_integer
 std_gc_collect(Global_Context& global, optV_integer generation_limit);
@@ -625,8 +625,8 @@ do_parse_nonrecursive(Token_Stream& tstrm)
     return value;
   }
 
-Value
-do_parse(tinybuf& cbuf)
+Compiler_Options
+do_make_options()
   {
     // We reuse the lexer of Asteria here, allowing quite a few extensions e.g. binary numeric
     // literals and comments.
@@ -634,9 +634,12 @@ do_parse(tinybuf& cbuf)
     opts.escapable_single_quotes = true;
     opts.keywords_as_identifiers = true;
     opts.integers_as_reals = true;
+    return opts;
+  }
 
-    Token_Stream tstrm(opts);
-    tstrm.reload(&"[JSON text]", 1, move(cbuf));
+Value
+do_parse_tokens(Token_Stream& tstrm)
+  {
     if(tstrm.empty())
       ASTERIA_THROW(("Empty JSON string"));
 
@@ -648,6 +651,22 @@ do_parse(tinybuf& cbuf)
     return value;
   }
 
+Value
+do_parse(tinybuf& cbuf)
+  {
+    Token_Stream tstrm(do_make_options());
+    tstrm.reload(&"[JSON text]", 1, move(cbuf));
+    return do_parse_tokens(tstrm);
+  }
+
+Value
+do_parse(const char* str, size_t len)
+  {
+    Token_Stream tstrm(do_make_options());
+    tstrm.reload(&"[JSON text]", 1, str, len);
+    return do_parse_tokens(tstrm);
+  }
+
 }  // namespace
 
 V_string
@@ -671,10 +690,8 @@ std_json_format(Value value, V_integer indent, optV_boolean json5)
 Value
 std_json_parse(V_string text)
   {
-    // Parse characters from the string.
-    ::rocket::tinybuf_str cbuf;
-    cbuf.set_string(text, tinybuf::open_read);
-    return do_parse(cbuf);
+    // Parse characters from the string in place.
+    return do_parse(text.data(), text.size());
   }
 
 Value
@@ -688,7 +705,8 @@ std_json_parse_file(V_string path)
           "[`fopen()` failed: ${errno:full}]"),
           path);
 
-    // Parse characters from the file.
+    // Parse characters from the file. It is read through a buffer rather than
+    // mapped into memory, as another process may truncate it meanwhile.
     ::rocket::tinybuf_file cbuf(move(fp));
     return do_parse(cbuf);
   }
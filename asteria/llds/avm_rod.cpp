@@ -5,6 +5,8 @@
 #include "avm_rod.hpp"
 #include "../runtime/air_node.hpp"
 #include "../runtime/runtime_error.hpp"
+#include "../runtime/executive_context.hpp"
+#include "../runtime/global_context.hpp"
 #include "../runtime/enums.hpp"
 #include "../utils.hpp"
 namespace asteria {
@@ -188,6 +190,9 @@ execute(Executive_Context& ctx) const
             except.push_frame_plain(head->pv_meta->sloc);
             throw;
           }
+
+          if(ROCKET_UNEXPECT(status == air_status_throw))
+            ctx.global().mut_pending_exception().push_frame_plain(head->pv_meta->sloc);
           break;
       }
 
@@ -67,6 +67,11 @@ class AVM_Rod
     empty() const noexcept
       { return this->m_einit == 0;  }
 
+    // Get the number of bytes of nodes.
+    size_t
+    size_in_bytes() const noexcept
+      { return this->m_einit * sizeof(Header);  }
+
     void
     clear() noexcept;
 
@@ -171,4 +171,16 @@ erase(phsh_stringR key, Reference* refp_opt) noexcept
     return true;
   }
 
+void
+Reference_Dictionary::
+collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
+  {
+    if(this->m_nbkt == 0)
+      return;
+
+    auto eptr = this->m_bptr + this->m_nbkt;
+    for(auto qbkt = eptr->next;  qbkt != eptr;  qbkt = qbkt->next)
+      qbkt->ref.collect_variables(staged, temp);
+  }
+
 }  // namespace asteria
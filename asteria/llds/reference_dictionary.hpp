@@ -82,6 +82,12 @@ class Reference_Dictionary
     size() const noexcept
       { return this->m_size;  }
 
+    // Gets the number of buckets, which is zero if no storage has been
+    // allocated.
+    uint32_t
+    bucket_count() const noexcept
+      { return this->m_nbkt;  }
+
     void
     clear() noexcept
       {
@@ -105,6 +111,9 @@ class Reference_Dictionary
 
     bool
     erase(phsh_stringR key, Reference* refp_opt) noexcept;
+
+    void
+    collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const;
   };
 
 inline
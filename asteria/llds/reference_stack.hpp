@@ -63,6 +63,10 @@ class Reference_Stack
     size() const noexcept
       { return this->m_etop;  }
 
+    uint32_t
+    capacity() const noexcept
+      { return this->m_estor;  }
+
     void
     clear() noexcept
       {
@@ -59,6 +59,18 @@ class Abstract_Context
         this->m_named_refs.clear();
       }
 
+    void
+    do_swap_named_references(Reference_Dictionary& other) noexcept
+      {
+        this->m_named_refs.swap(other);
+      }
+
+    void
+    do_collect_named_references(Variable_HashMap& staged, Variable_HashMap& temp) const
+      {
+        this->m_named_refs.collect_variables(staged, temp);
+      }
+
   public:
     bool
     is_analytic() const noexcept
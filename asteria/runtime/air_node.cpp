@@ -15,6 +15,7 @@
 #include "ptc_arguments.hpp"
 #include "module_loader.hpp"
 #include "air_optimizer.hpp"
+#include "instantiated_function.hpp"
 #include "../compiler/token_stream.hpp"
 #include "../compiler/statement_sequence.hpp"
 #include "../compiler/statement.hpp"
@@ -61,11 +62,285 @@ void
 do_solidify_nodes(AVM_Rod& rod, const cow_vector<AIR_Node>& code)
   {
     rod.clear();
-    for(size_t i = 0;  i < code.size();  ++i)
-      code.at(i).solidify(rod);
+    AIR_Node::solidify_all(rod, code);
     rod.finalize();
   }
 
+// This describes a reference that a closure captures from the context where
+// it is defined. If `index` is `UINT32_MAX`, the reference is a local one,
+// `depth` contexts above; otherwise, it has been captured by the enclosing
+// function, as its `index`-th element.
+struct Closure_Capture
+  {
+    phsh_string name;
+    uint32_t depth;
+    uint32_t index;
+  };
+
+uint32_t
+do_add_closure_capture(cow_vector<Closure_Capture>& caps, phsh_stringR name, uint32_t depth,
+                       uint32_t index)
+  {
+    for(uint32_t k = 0;  k != caps.size();  ++k)
+      if((caps[k].depth == depth) && (caps[k].index == index) && (caps[k].name == name))
+        return k;
+
+    caps.push_back({ name, depth, index });
+    return (uint32_t) caps.size() - 1;
+  }
+
+template<typename xFunc>
+void
+do_for_each_reference(cow_vector<AIR_Node>& code, uint32_t level, xFunc&& func);
+
+template<typename xFunc>
+void
+do_for_each_reference(AIR_Node& node, uint32_t level, xFunc&& func)
+  {
+    // Call `func` on each node that pushes a local or captured reference.
+    // `level` is the number of contexts between the node and the outermost
+    // one, and mirrors `AIR_Node::rebind_opt()`.
+    switch(node.index())
+      {
+      case AIR_Node::index_push_local_reference:
+      case AIR_Node::index_push_captured_reference:
+        func(node, level);
+        return;
+
+      case AIR_Node::index_execute_block:
+        do_for_each_reference(node.mut<AIR_Node::S_execute_block>().code_body, level + 1, func);
+        return;
+
+      case AIR_Node::index_if_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_if_statement>();
+          do_for_each_reference(altr.code_true, level + 1, func);
+          do_for_each_reference(altr.code_false, level + 1, func);
+          return;
+        }
+
+      case AIR_Node::index_switch_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_switch_statement>();
+          for(size_t k = 0;  k < altr.clauses.size();  ++k) {
+            do_for_each_reference(altr.clauses.mut(k).code_label, level, func);
+            do_for_each_reference(altr.clauses.mut(k).code_body, level + 1, func);
+          }
+          return;
+        }
+
+      case AIR_Node::index_do_while_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_do_while_statement>();
+          do_for_each_reference(altr.code_body, level + 1, func);
+          do_for_each_reference(altr.code_cond, level, func);
+          return;
+        }
+
+      case AIR_Node::index_while_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_while_statement>();
+          do_for_each_reference(altr.code_cond, level, func);
+          do_for_each_reference(altr.code_body, level + 1, func);
+          return;
+        }
+
+      case AIR_Node::index_for_each_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_for_each_statement>();
+          do_for_each_reference(altr.code_init, level + 1, func);
+          do_for_each_reference(altr.code_body, level + 2, func);
+          return;
+        }
+
+      case AIR_Node::index_for_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_for_statement>();
+          do_for_each_reference(altr.code_init, level + 1, func);
+          do_for_each_reference(altr.code_cond, level + 1, func);
+          do_for_each_reference(altr.code_step, level + 1, func);
+          do_for_each_reference(altr.code_body, level + 2, func);
+          return;
+        }
+
+      case AIR_Node::index_try_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_try_statement>();
+          do_for_each_reference(altr.code_try, level + 1, func);
+          do_for_each_reference(altr.code_catch, level + 1, func);
+          return;
+        }
+
+      case AIR_Node::index_define_function:
+        do_for_each_reference(node.mut<AIR_Node::S_define_function>().code_body, level + 1, func);
+        return;
+
+      case AIR_Node::index_branch_expression:
+        {
+          auto& altr = node.mut<AIR_Node::S_branch_expression>();
+          do_for_each_reference(altr.code_true, level, func);
+          do_for_each_reference(altr.code_false, level, func);
+          return;
+        }
+
+      case AIR_Node::index_defer_expression:
+        do_for_each_reference(node.mut<AIR_Node::S_defer_expression>().code_body, level, func);
+        return;
+
+      case AIR_Node::index_catch_expression:
+        do_for_each_reference(node.mut<AIR_Node::S_catch_expression>().code_body, level, func);
+        return;
+
+      case AIR_Node::index_coalesce_expression:
+        do_for_each_reference(node.mut<AIR_Node::S_coalesce_expression>().code_null, level, func);
+        return;
+
+      case AIR_Node::index_inline_call:
+        do_for_each_reference(node.mut<AIR_Node::S_inline_call>().code_body, level + 1, func);
+        return;
+
+      case AIR_Node::index_clear_stack:
+      case AIR_Node::index_declare_variable:
+      case AIR_Node::index_initialize_variable:
+      case AIR_Node::index_throw_statement:
+      case AIR_Node::index_assert_statement:
+      case AIR_Node::index_simple_status:
+      case AIR_Node::index_check_argument:
+      case AIR_Node::index_push_global_reference:
+      case AIR_Node::index_push_bound_reference:
+      case AIR_Node::index_function_call:
+      case AIR_Node::index_push_unnamed_array:
+      case AIR_Node::index_push_unnamed_object:
+      case AIR_Node::index_apply_operator:
+      case AIR_Node::index_unpack_array:
+      case AIR_Node::index_unpack_object:
+      case AIR_Node::index_define_null_variable:
+      case AIR_Node::index_single_step_trap:
+      case AIR_Node::index_variadic_call:
+      case AIR_Node::index_import_call:
+      case AIR_Node::index_declare_reference:
+      case AIR_Node::index_initialize_reference:
+      case AIR_Node::index_return_statement:
+      case AIR_Node::index_push_constant:
+      case AIR_Node::index_alt_clear_stack:
+      case AIR_Node::index_alt_function_call:
+      case AIR_Node::index_member_access:
+      case AIR_Node::index_apply_operator_bi32:
+      case AIR_Node::index_return_statement_bi32:
+        return;
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), node.index());
+    }
+  }
+
+template<typename xFunc>
+void
+do_for_each_reference(cow_vector<AIR_Node>& code, uint32_t level, xFunc&& func)
+  {
+    for(size_t i = 0;  i < code.size();  ++i)
+      do_for_each_reference(code.mut(i), level, func);
+  }
+
+void
+do_capture_nodes(cow_vector<Closure_Capture>& caps, cow_vector<AIR_Node>& code)
+  {
+    // Replace references to contexts outside the closure with captured ones.
+    do_for_each_reference(code, 1,
+      [&](AIR_Node& node, uint32_t level)
+      {
+        if(node.index() == AIR_Node::index_push_captured_reference) {
+          auto& altr = node.mut<AIR_Node::S_push_captured_reference>();
+          altr.index = do_add_closure_capture(caps, altr.name, 0, altr.index);
+          return;
+        }
+
+        const auto& altr = node.as<AIR_Node::S_push_local_reference>();
+        if(altr.depth < level)
+          return;
+
+        AIR_Node::S_push_captured_reference xnode = { altr.sloc, 0, altr.name };
+        xnode.index = do_add_closure_capture(caps, altr.name, altr.depth - level, UINT32_MAX);
+        node = move(xnode);
+      });
+  }
+
+bool
+do_solidify_block(AVM_Rod& rod, const cow_vector<AIR_Node>& code)
+  {
+    // A block that declares nothing and defers nothing does not need its own
+    // context, and can be executed in the enclosing one. The return value
+    // indicates whether a context is required.
+    for(size_t i = 0;  i < code.size();  ++i) {
+      auto index = code.at(i).index();
+      if((index == AIR_Node::index_declare_variable)
+         || (index == AIR_Node::index_define_null_variable)
+         || (index == AIR_Node::index_declare_reference)
+         || (index == AIR_Node::index_initialize_reference)
+         || (index == AIR_Node::index_defer_expression)) {
+        do_solidify_nodes(rod, code);
+        return true;
+      }
+    }
+
+    // References to outer contexts are now one level closer.
+    auto code_elided = code;
+    do_for_each_reference(code_elided, 1,
+      [&](AIR_Node& node, uint32_t level)
+      {
+        if(node.index() == AIR_Node::index_push_local_reference) {
+          auto& altr = node.mut<AIR_Node::S_push_local_reference>();
+          if(altr.depth >= level)
+            altr.depth --;
+        }
+      });
+
+    do_solidify_nodes(rod, code_elided);
+    return false;
+  }
+
+const Instantiated_Function&
+do_get_enclosing_function(const Executive_Context& ctx)
+  {
+    // Only a function context has no parent.
+    const Executive_Context* qctx = &ctx;
+    while(qctx->get_parent_opt())
+      qctx = qctx->get_parent_opt();
+
+    ROCKET_ASSERT(qctx->func_opt());
+    return *(qctx->func_opt());
+  }
+
+Reference
+do_get_closure_capture(const Executive_Context& ctx, const Closure_Capture& cap, bool lazy)
+  {
+    if(cap.index != UINT32_MAX)
+      return do_get_enclosing_function(ctx).captures().at(cap.index);
+
+    // Locate the target context.
+    const Executive_Context* qctx = &ctx;
+    for(uint32_t k = 0;  k != cap.depth;  ++k)
+      qctx = qctx->get_parent_opt();
+
+    // A name that has not been declared yet is left unbound, and an error is
+    // reported only if the closure uses it.
+    auto qref = qctx->get_named_reference_opt(cap.name);
+    if(!qref)
+      return Reference();
+
+    if(qref->is_invalid()) {
+      // The body of a lazy function has not been parsed, so this name might
+      // not denote a variable at all, and it is left unbound, too.
+      if(lazy)
+        return Reference();
+
+      throw Runtime_Error(xtc_format,
+               "Initialization of variable or reference `$1` bypassed", cap.name);
+    }
+
+    return *qref;
+  }
+
 template<typename xModifier>
 void
 do_push_modifier_and_check(Reference& ref, xModifier&& xmod)
@@ -91,6 +366,110 @@ do_sparam_dtor(Header* head)
     ::rocket::details_variant::wrapped_destroy<xSparam>(head->sparam);
   }
 
+bool
+do_is_fusible_comparison_operator(Xop xop) noexcept
+  {
+    return (xop == xop_cmp_eq) || (xop == xop_cmp_ne) || (xop == xop_cmp_un)
+           || (xop == xop_cmp_lt) || (xop == xop_cmp_gt) || (xop == xop_cmp_lte)
+           || (xop == xop_cmp_gte);
+  }
+
+bool
+do_is_fusible_binary_operator(Xop xop, bool shift_ok) noexcept
+  {
+    switch(xop)
+      {
+      case xop_cmp_eq:
+      case xop_cmp_ne:
+      case xop_cmp_un:
+      case xop_cmp_lt:
+      case xop_cmp_gt:
+      case xop_cmp_lte:
+      case xop_cmp_gte:
+      case xop_cmp_3way:
+      case xop_add:
+      case xop_sub:
+      case xop_mul:
+      case xop_div:
+      case xop_mod:
+      case xop_andb:
+      case xop_orb:
+      case xop_xorb:
+      case xop_addm:
+      case xop_subm:
+      case xop_mulm:
+      case xop_adds:
+      case xop_subs:
+      case xop_muls:
+        return true;
+
+      case xop_sll:
+      case xop_srl:
+      case xop_sla:
+      case xop_sra:
+        // A shift count that is not an integer is handled differently.
+        return shift_ok;
+
+      case xop_inc:
+      case xop_dec:
+      case xop_index:
+      case xop_pos:
+      case xop_neg:
+      case xop_notb:
+      case xop_notl:
+      case xop_unset:
+      case xop_countof:
+      case xop_typeof:
+      case xop_sqrt:
+      case xop_isnan:
+      case xop_isinf:
+      case xop_abs:
+      case xop_sign:
+      case xop_round:
+      case xop_floor:
+      case xop_ceil:
+      case xop_trunc:
+      case xop_iround:
+      case xop_ifloor:
+      case xop_iceil:
+      case xop_itrunc:
+      case xop_assign:
+      case xop_fma:
+      case xop_head:
+      case xop_tail:
+      case xop_lzcnt:
+      case xop_tzcnt:
+      case xop_popcnt:
+      case xop_random:
+      case xop_isvoid:
+        return false;
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), xop);
+    }
+  }
+
+const Reference&
+do_get_local_reference(const Executive_Context& ctx, uint32_t depth, phsh_stringR name)
+  {
+    // Locate the target context.
+    const Executive_Context* qctx = &ctx;
+    for(uint32_t k = 0;  k != depth;  ++k)
+      qctx = qctx->get_parent_opt();
+
+    // Look for the name in the target context.
+    auto qref = qctx->get_named_reference_opt(name);
+    if(!qref)
+      throw Runtime_Error(xtc_format,
+               "Undeclared identifier `$1`", name);
+
+    if(qref->is_invalid())
+      throw Runtime_Error(xtc_format,
+               "Initialization of variable or reference `$1` bypassed", name);
+
+    return *qref;
+  }
+
 AIR_Status
 do_execute_block(const AVM_Rod& rod, const Executive_Context& ctx)
   {
@@ -107,6 +486,49 @@ do_execute_block(const AVM_Rod& rod, const Executive_Context& ctx)
     return status;
   }
 
+AIR_Status
+do_execute_block(const AVM_Rod& rod, Executive_Context& ctx, bool scoped)
+  {
+    // A block that has no context of its own is executed in the enclosing one.
+    if(!scoped)
+      return rod.execute(ctx);
+
+    return do_execute_block(rod, ctx);
+  }
+
+AIR_Status
+do_execute_catch(const Executive_Context& ctx, const Source_Location& sloc_catch,
+                 phsh_stringR name_except, const AVM_Rod& rod_catch, Runtime_Error& except)
+  {
+    // Exceptions from `throw` statements inside the `catch` clause inherit
+    // frames from `except`.
+    const auto saved_handled = ctx.global().exchange_handled_exception(&except);
+    auto handled_cleanup = [&](Global_Context* qglobal) { qglobal->exchange_handled_exception(saved_handled);  };
+    unique_ptr<Global_Context, decltype(handled_cleanup)> handled_guard(&(ctx.global()), handled_cleanup);
+
+    // `__backtrace` is created from `except` only when it is requested.
+    Executive_Context ctx_catch(xtc_plain, ctx, except);
+    AIR_Status status;
+    try {
+      // Set the exception reference.
+      auto& except_ref = ctx_catch.insert_named_reference(name_except);
+      except_ref.set_temporary(except.value());
+
+      // Execute the `catch` clause.
+      status = rod_catch.execute(ctx_catch);
+    }
+    catch(Runtime_Error& nested) {
+      ctx_catch.on_scope_exit_exceptional(nested);
+      nested.push_frame_catch(sloc_catch, except.value());
+      throw;
+    }
+    ctx_catch.on_scope_exit_normal(status);
+
+    if(status == air_status_throw)
+      ctx.global().mut_pending_exception().push_frame_catch(sloc_catch, except.value());
+    return status;
+  }
+
 AIR_Status
 do_evaluate_subexpression(Executive_Context& ctx, bool assign, const AVM_Rod& rod)
   {
@@ -118,7 +540,10 @@ do_evaluate_subexpression(Executive_Context& ctx, bool assign, const AVM_Rod& ro
       // Evaluate the subexpression and assign the result to the first operand.
       // The result value has to be copied, in case that a reference to an element
       // of the LHS operand is returned.
-      rod.execute(ctx);
+      AIR_Status status = rod.execute(ctx);
+      if(status != air_status_next)
+        return status;
+
       auto& val = ctx.stack().mut_top().dereference_copy();
       ctx.stack().pop();
       ctx.stack().top().dereference_mutable() = move(val);
@@ -147,16 +572,22 @@ do_invoke_partial(Reference& self, Executive_Context& ctx, const Source_Location
 
     const auto& f = target.as_function();
     if(ROCKET_EXPECT(ptc == ptc_aware_none)) {
-      // Perform a plain call.
+      // Perform a plain call. If the target is a script function, exceptions
+      // from its `throw` statements are propagated as a status code.
       if(auto hooks = ctx.global().get_hooks_opt())
         hooks->on_call(sloc, f);
 
+      if(f.type() == typeid(Instantiated_Function))
+        ctx.global().request_throw_by_status();
+
       f.invoke(self, ctx.global(), move(ctx.alt_stack()));
+      if(ROCKET_UNEXPECT(ctx.global().has_pending_exception()))
+        return air_status_throw;
       return air_status_next;
     }
     else {
       // Perform a tail call.
-      self.set_ptc(::rocket::make_refcnt<PTC_Arguments>(sloc, ptc, f, move(self), move(ctx.alt_stack())));
+      self.set_ptc(ctx.global().allocate_ptc_arguments(sloc, ptc, f, move(self), move(ctx.alt_stack())));
       return air_status_return_ref;
     }
   }
@@ -773,1248 +1204,1794 @@ do_apply_binary_operator_with_integer(uint8_t uxop, Value& lhs, V_integer irhs)
     }
   }
 
-}  // namespace
-
-opt<Value>
-AIR_Node::
-get_constant_opt() const noexcept
+AIR_Status
+do_apply_binary_operator(uint8_t uxop, Value& lhs, const Value& rhs)
   {
-    switch(this->m_stor.index())
+    // The fast path should be a proper tail call.
+    if(rhs.type() == type_integer)
+      return do_apply_binary_operator_with_integer(uxop, lhs, rhs.as_integer());
+
+    switch(uxop)
       {
-      case index_push_bound_reference:
-        try {
-          const auto& altr = this->m_stor.as<S_push_bound_reference>();
-          if(altr.ref.is_temporary())
-            return altr.ref.dereference_readonly();
+      case xop_cmp_eq:
+        {
+          // Check whether the two operands are equal. Unordered values are
+          // considered to be unequal.
+          lhs = lhs.compare_partial(rhs) == compare_equal;
+          return air_status_next;
         }
-        catch(...) { }
-        return nullopt;
 
-      case index_push_constant:
-        return this->m_stor.as<S_push_constant>().val;
+      case xop_cmp_ne:
+        {
+          // Check whether the two operands are not equal. Unordered values are
+          // considered to be unequal.
+          lhs = lhs.compare_partial(rhs) != compare_equal;
+          return air_status_next;
+        }
 
-      default:
-        return nullopt;
-    }
-  }
+      case xop_cmp_un:
+        {
+          // Check whether the two operands are unordered.
+          lhs = lhs.compare_partial(rhs) == compare_unordered;
+          return air_status_next;
+        }
 
-bool
-AIR_Node::
-is_terminator() const noexcept
-  {
-    switch(static_cast<Index>(this->m_stor.index()))
-      {
-      case index_clear_stack:
-      case index_declare_variable:
-      case index_initialize_variable:
-      case index_switch_statement:
-      case index_do_while_statement:
-      case index_while_statement:
-      case index_for_each_statement:
-      case index_for_statement:
-      case index_try_statement:
-      case index_assert_statement:
-      case index_check_argument:
-      case index_push_global_reference:
-      case index_push_local_reference:
-      case index_push_bound_reference:
-      case index_define_function:
-      case index_push_unnamed_array:
-      case index_push_unnamed_object:
-      case index_apply_operator:
-      case index_unpack_array:
-      case index_unpack_object:
-      case index_define_null_variable:
-      case index_single_step_trap:
-      case index_defer_expression:
-      case index_import_call:
-      case index_declare_reference:
-      case index_initialize_reference:
-      case index_catch_expression:
-      case index_push_constant:
-      case index_alt_clear_stack:
-      case index_coalesce_expression:
-      case index_member_access:
-      case index_apply_operator_bi32:
-      case index_return_statement_bi32:
-        return false;
+      case xop_cmp_lt:
+        {
+          // Check whether the LHS operand is less than the RHS operand. If
+          // they are unordered, an exception shall be thrown.
+          lhs = lhs.compare_total(rhs) == compare_less;
+          return air_status_next;
+        }
 
-      case index_throw_statement:
-      case index_return_statement:
-        return true;
-
-      case index_simple_status:
-        return this->m_stor.as<S_simple_status>().status != air_status_next;
-
-      case index_function_call:
-        return this->m_stor.as<S_function_call>().ptc != ptc_aware_none;
-
-      case index_variadic_call:
-        return this->m_stor.as<S_variadic_call>().ptc != ptc_aware_none;
-
-      case index_alt_function_call:
-        return this->m_stor.as<S_alt_function_call>().ptc != ptc_aware_none;
+      case xop_cmp_gt:
+        {
+          // Check whether the LHS operand is greater than the RHS operand. If
+          // they are unordered, an exception shall be thrown.
+          lhs = lhs.compare_total(rhs) == compare_greater;
+          return air_status_next;
+        }
 
-      case index_execute_block:
+      case xop_cmp_lte:
         {
-          const auto& altr = this->m_stor.as<S_execute_block>();
-          return !altr.code_body.empty() && altr.code_body.back().is_terminator();
+          // Check whether the LHS operand is less than or equal to the RHS
+          // operand. If they are unordered, an exception shall be thrown.
+          lhs = lhs.compare_total(rhs) != compare_greater;
+          return air_status_next;
         }
 
-      case index_if_statement:
+      case xop_cmp_gte:
         {
-          const auto& altr = this->m_stor.as<S_if_statement>();
-          return !altr.code_true.empty() && altr.code_true.back().is_terminator()
-                 && !altr.code_false.empty() && altr.code_false.back().is_terminator();
+          // Check whether the LHS operand is greater than or equal to the RHS
+          // operand. If they are unordered, an exception shall be thrown.
+          lhs = lhs.compare_total(rhs) != compare_less;
+          return air_status_next;
         }
 
-      case index_branch_expression:
+      case xop_cmp_3way:
         {
-          const auto& altr = this->m_stor.as<S_branch_expression>();
-          return !altr.code_true.empty() && altr.code_true.back().is_terminator()
-                 && !altr.code_false.empty() && altr.code_false.back().is_terminator();
+          // Defines a partial ordering on all values. For unordered operands,
+          // a string is returned, so `x <=> y` and `(x <=> y) <=> 0` produces
+          // the same result.
+          int64_t cmp = lhs.compare_partial(rhs);
+          lhs = cmp - compare_equal;
+          if(ROCKET_UNEXPECT(cmp == compare_unordered))
+            lhs = &"[unordered]";
+          return air_status_next;
         }
 
-      default:
-        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
-    }
-  }
+      case xop_add:
+        {
+          // Perform logical OR on two boolean values, or get the sum of two
+          // arithmetic values, or concatenate two strings.
+          if(lhs.is_real() && rhs.is_real()) {
+            V_real& val = lhs.mut_real();
+            V_real other = rhs.as_real();
 
-opt<AIR_Node>
-AIR_Node::
-rebind_opt(Abstract_Context& ctx) const
-  {
-    switch(static_cast<Index>(this->m_stor.index()))
-      {
-      case index_clear_stack:
-      case index_declare_variable:
-      case index_initialize_variable:
-      case index_throw_statement:
-      case index_assert_statement:
-      case index_simple_status:
-      case index_check_argument:
-      case index_push_global_reference:
-      case index_push_bound_reference:
-      case index_function_call:
-      case index_push_unnamed_array:
-      case index_push_unnamed_object:
-      case index_apply_operator:
-      case index_unpack_array:
-      case index_unpack_object:
-      case index_define_null_variable:
-      case index_single_step_trap:
-      case index_variadic_call:
-      case index_import_call:
-      case index_declare_reference:
-      case index_initialize_reference:
-      case index_return_statement:
-      case index_push_constant:
-      case index_alt_clear_stack:
-      case index_alt_function_call:
-      case index_member_access:
-      case index_apply_operator_bi32:
-      case index_return_statement_bi32:
-        return nullopt;
+            val += other;
+            return air_status_next;
+          }
 
-      case index_execute_block:
-        {
-          const auto& altr = this->m_stor.as<S_execute_block>();
+          if(lhs.is_string() && rhs.is_string()) {
+            V_string& val = lhs.mut_string();
+            const V_string& other = rhs.as_string();
 
-          // Rebind the body in a nested scope.
-          bool dirty = false;
-          auto bound = altr;
+            val.append(other);
+            return air_status_next;
+          }
 
-          Analytic_Context ctx_body(xtc_plain, ctx);
-          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+          if(lhs.is_boolean() && rhs.is_boolean()) {
+            V_boolean& val = lhs.mut_boolean();
+            V_boolean other = rhs.as_boolean();
 
-          return do_return_rebound_opt(dirty, move(bound));
+            val |= other;
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "Addition not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_if_statement:
+      case xop_sub:
         {
-          const auto& altr = this->m_stor.as<S_if_statement>();
+          // Perform logical XOR on two boolean values, or get the difference
+          // of two arithmetic values.
+          if(lhs.is_real() && rhs.is_real()) {
+            V_real& val = lhs.mut_real();
+            V_real other = rhs.as_real();
 
-          // Rebind both branches in a nested scope.
-          bool dirty = false;
-          auto bound = altr;
+            // Overflow will result in an infinity, so this is safe.
+            val -= other;
+            return air_status_next;
+          }
 
-          Analytic_Context ctx_body(xtc_plain, ctx);
-          do_rebind_nodes(dirty, bound.code_true, ctx_body);
-          do_rebind_nodes(dirty, bound.code_false, ctx_body);
+          if(lhs.is_boolean() && rhs.is_boolean()) {
+            V_boolean& val = lhs.mut_boolean();
+            V_boolean other = rhs.as_boolean();
 
-          return do_return_rebound_opt(dirty, move(bound));
+            // Perform logical XOR of the operands.
+            val ^= other;
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "Subtraction not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_switch_statement:
+      case xop_mul:
         {
-          const auto& altr = this->m_stor.as<S_switch_statement>();
+           // Perform logical AND on two boolean values, or get the product of
+           // two arithmetic values, or duplicate a string or array by a given
+           // times.
+          if(lhs.is_real() && rhs.is_real()) {
+            V_real& val = lhs.mut_real();
+            V_real other = rhs.as_real();
 
-          // Rebind all labels and clauses.
-          bool dirty = false;
-          auto bound = altr;
+            val *= other;
+            return air_status_next;
+          }
 
-          Analytic_Context ctx_body(xtc_plain, ctx);
-          for(size_t k = 0;  k < bound.clauses.size();  ++k) {
-            // Labels are to be evaluated in the same scope as the condition
-            // expression, and are not parts of the body.
-            for(size_t i = 0;  i < bound.clauses.at(k).code_label.size();  ++i)
-              if(auto qnode = bound.clauses.at(k).code_label.at(i).rebind_opt(ctx))
-                do_set_rebound(dirty, bound.clauses.mut(k).code_label.mut(i), move(*qnode));
+          if(lhs.is_integer() && rhs.is_string()) {
+            V_integer count = lhs.as_integer();
+            lhs = rhs.as_string();
+            V_string& val = lhs.mut_string();
 
-            for(size_t i = 0;  i < bound.clauses.at(k).code_body.size();  ++i)
-              if(auto qnode = bound.clauses.at(k).code_body.at(i).rebind_opt(ctx_body))
-                do_set_rebound(dirty, bound.clauses.mut(k).code_body.mut(i), move(*qnode));
+            do_duplicate_sequence(val, count);
+            return air_status_next;
           }
 
-          return do_return_rebound_opt(dirty, move(bound));
+          if(lhs.is_integer() && rhs.is_array()) {
+            V_integer count = lhs.as_integer();
+            lhs = rhs.as_array();
+            V_array& val = lhs.mut_array();
+
+            do_duplicate_sequence(val, count);
+            return air_status_next;
+          }
+
+          if(lhs.is_boolean() && rhs.is_boolean()) {
+            V_boolean& val = lhs.mut_boolean();
+            V_boolean other = rhs.as_boolean();
+
+            val &= other;
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "Multiplication not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_do_while_statement:
+      case xop_div:
         {
-          const auto& altr = this->m_stor.as<S_do_while_statement>();
+          // Get the quotient of two arithmetic values. If both operands are
+          // integers, the result is also an integer, truncated towards zero.
+          if(lhs.is_real() && rhs.is_real()) {
+            V_real& val = lhs.mut_real();
+            V_real other = rhs.as_real();
 
-          // Rebind the body and the condition expression.
-          // The condition expression is not a part of the body.
-          bool dirty = false;
-          auto bound = altr;
+            val /= other;
+            return air_status_next;
+          }
 
-          Analytic_Context ctx_body(xtc_plain, ctx);
-          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+          throw Runtime_Error(xtc_format,
+                   "Division not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
+        }
 
-          do_rebind_nodes(dirty, bound.code_cond, ctx);
+      case xop_mod:
+        {
+          // Get the remainder of two arithmetic values. The quotient is
+          // truncated towards zero. If both operands are integers, the result
+          // is also an integer.
+          if(lhs.is_real() && rhs.is_real()) {
+            V_real& val = lhs.mut_real();
+            V_real other = rhs.as_real();
 
-          return do_return_rebound_opt(dirty, move(bound));
+            val = ::std::fmod(val, other);
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "Modulo not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_while_statement:
+      case xop_andb:
         {
-          const auto& altr = this->m_stor.as<S_while_statement>();
+          // Perform the bitwise AND operation on all bits of the operands. If
+          // the two operands have different lengths, the result is truncated
+          // to the same length as the shorter one.
+          if(lhs.is_string() && rhs.is_string()) {
+            V_string& val = lhs.mut_string();
+            const V_string& mask = rhs.as_string();
 
-          // Rebind the condition expression and the body.
-          // The condition expression is not a part of the body.
-          bool dirty = false;
-          auto bound = altr;
+            if(val.size() > mask.size())
+              val.erase(mask.size());
+            auto maskp = mask.begin();
+            for(auto it = val.mut_begin();  it != val.end();  ++it, ++maskp)
+              *it = static_cast<char>(*it & *maskp);
+            return air_status_next;
+          }
 
-          do_rebind_nodes(dirty, bound.code_cond, ctx);
+          if(lhs.is_boolean() && rhs.is_boolean()) {
+            V_boolean& val = lhs.mut_boolean();
+            V_boolean other = rhs.as_boolean();
 
-          Analytic_Context ctx_body(xtc_plain, ctx);
-          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+            val &= other;
+            return air_status_next;
+          }
 
-          return do_return_rebound_opt(dirty, move(bound));
+          throw Runtime_Error(xtc_format,
+                   "Bitwise AND not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_for_each_statement:
+      case xop_orb:
         {
-          const auto& altr = this->m_stor.as<S_for_each_statement>();
+          // Perform the bitwise OR operation on all bits of the operands. If
+          // the two operands have different lengths, the result is padded to
+          // the same length as the longer one, with zeroes.
+          if(lhs.is_string() && rhs.is_string()) {
+            V_string& val = lhs.mut_string();
+            const V_string& mask = rhs.as_string();
 
-          // Rebind the range initializer and the body.
-          // The range key and mapped references are declared in a dedicated scope
-          // where the initializer is to be evaluated. The body is to be executed
-          // in an inner scope, created and destroyed for each iteration.
-          bool dirty = false;
-          auto bound = altr;
+            if(val.size() < mask.size())
+              val.append(mask.size() - val.size(), 0);
+            auto valp = val.mut_begin();
+            for(auto it = mask.begin();  it != mask.end();  ++it, ++valp)
+              *valp = static_cast<char>(*valp | *it);
+            return air_status_next;
+          }
 
-          Analytic_Context ctx_for(xtc_plain, ctx);
-          if(!altr.name_key.empty())
-            ctx_for.insert_named_reference(altr.name_key);
-          ctx_for.insert_named_reference(altr.name_mapped);
-          do_rebind_nodes(dirty, bound.code_init, ctx_for);
+          if(lhs.is_boolean() && rhs.is_boolean()) {
+            V_boolean& val = lhs.mut_boolean();
+            V_boolean other = rhs.as_boolean();
 
-          Analytic_Context ctx_body(xtc_plain, ctx_for);
-          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+            val |= other;
+            return air_status_next;
+          }
 
-          return do_return_rebound_opt(dirty, move(bound));
+          throw Runtime_Error(xtc_format,
+                   "Bitwise OR not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_for_statement:
+      case xop_xorb:
         {
-          const auto& altr = this->m_stor.as<S_for_statement>();
+          // Perform the bitwise XOR operation on all bits of the operands. If
+          // the two operands have different lengths, the result is padded to
+          // the same length as the longer one, with zeroes.
+          if(lhs.is_string() && rhs.is_string()) {
+            V_string& val = lhs.mut_string();
+            const V_string& mask = rhs.as_string();
 
-          // Rebind the initializer, condition expression and step expression. All
-          // these are declared in a dedicated scope where the initializer is to be
-          // evaluated. The body is to be executed in an inner scope, created and
-          // destroyed for each iteration.
-          bool dirty = false;
-          auto bound = altr;
+            if(val.size() < mask.size())
+              val.append(mask.size() - val.size(), 0);
+            auto valp = val.mut_begin();
+            for(auto it = mask.begin();  it != mask.end();  ++it, ++valp)
+              *valp = static_cast<char>(*valp ^ *it);
+            return air_status_next;
+          }
 
-          Analytic_Context ctx_for(xtc_plain, ctx);
-          do_rebind_nodes(dirty, bound.code_init, ctx_for);
-          do_rebind_nodes(dirty, bound.code_cond, ctx_for);
-          do_rebind_nodes(dirty, bound.code_step, ctx_for);
+          if(lhs.is_boolean() && rhs.is_boolean()) {
+            V_boolean& val = lhs.mut_boolean();
+            V_boolean other = rhs.as_boolean();
 
-          Analytic_Context ctx_body(xtc_plain, ctx_for);
-          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+            val ^= other;
+            return air_status_next;
+          }
 
-          return do_return_rebound_opt(dirty, move(bound));
+          throw Runtime_Error(xtc_format,
+                   "Bitwise XOR not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_try_statement:
+      case xop_addm:
         {
-          const auto& altr = this->m_stor.as<S_try_statement>();
-
-          // Rebind the `try` and `catch` clauses.
-          bool dirty = false;
-          auto bound = altr;
-
-          Analytic_Context ctx_try(xtc_plain, ctx);
-          do_rebind_nodes(dirty, bound.code_try, ctx_try);
-
-          Analytic_Context ctx_catch(xtc_plain, ctx);
-          ctx_catch.insert_named_reference(altr.name_except);
-          do_rebind_nodes(dirty, bound.code_catch, ctx_catch);
-
-          return do_return_rebound_opt(dirty, move(bound));
+          // This should have been redirected to the fast path.
+          throw Runtime_Error(xtc_format,
+                   "Modular addition not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_push_local_reference:
+      case xop_subm:
         {
-          const auto& altr = this->m_stor.as<S_push_local_reference>();
-
-          // Get the context.
-          const Abstract_Context* qctx = &ctx;
-          for(uint32_t k = 0;  k != altr.depth;  ++k)
-            qctx = qctx->get_parent_opt();
-
-          if(qctx->is_analytic())
-            return nullopt;
+          // This should have been redirected to the fast path.
+          throw Runtime_Error(xtc_format,
+                   "Modular subtraction not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
+        }
 
-          // Look for the name.
-          auto qref = qctx->get_named_reference_opt(altr.name);
-          if(!qref)
-            return nullopt;
-          else if(qref->is_invalid())
-            throw Runtime_Error(xtc_format,
-                     "Initialization of variable or reference `$1` bypassed", altr.name);
+      case xop_mulm:
+        {
+          // This should have been redirected to the fast path.
+          throw Runtime_Error(xtc_format,
+                   "Modular multiplication not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
+        }
 
-          // Bind this reference.
-          S_push_bound_reference xnode = { *qref };
-          return move(xnode);
+      case xop_adds:
+        {
+          // This should have been redirected to the fast path.
+          throw Runtime_Error(xtc_format,
+                   "Saturating addition not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
         }
 
-      case index_define_function:
+      case xop_subs:
         {
-          const auto& altr = this->m_stor.as<S_define_function>();
+          // This should have been redirected to the fast path.
+          throw Runtime_Error(xtc_format,
+                   "Saturating subtraction not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
+        }
 
-          // Rebind the function body.
-          // This is the only scenario where names in the outer scope are visible
-          // to the body of a function.
-          bool dirty = false;
-          auto bound = altr;
+      case xop_muls:
+        {
+          // This should have been redirected to the fast path.
+          throw Runtime_Error(xtc_format,
+                   "Saturating multiplication not applicable (operands were `$1` and `$2`)",
+                   lhs, rhs);
+        }
 
-          Analytic_Context ctx_func(xtc_function, &ctx, altr.params);
-          do_rebind_nodes(dirty, bound.code_body, ctx_func);
+      default:
+        ROCKET_UNREACHABLE();
+    }
+  }
 
-          return do_return_rebound_opt(dirty, move(bound));
+AIR_Status
+do_apply_unary_operator(uint8_t uxop, Value& rhs)
+  {
+    switch(uxop)
+      {
+      case xop_pos:
+        {
+          // This operator does nothing.
+          return air_status_next;
         }
 
-      case index_branch_expression:
+      case xop_neg:
         {
-          const auto& altr = this->m_stor.as<S_branch_expression>();
-
-          // Rebind both branches.
-          bool dirty = false;
-          auto bound = altr;
+          // Get the additive inverse of the operand.
+          if(rhs.type() == type_integer) {
+            V_integer& val = rhs.mut_integer();
 
-          do_rebind_nodes(dirty, bound.code_true, ctx);
-          do_rebind_nodes(dirty, bound.code_false, ctx);
+            int64_t result;
+            if(ROCKET_SUB_OVERFLOW(0, val, &result))
+              throw Runtime_Error(xtc_format,
+                       "Integer negation overflow (operand was `$1`)", val);
 
-          return do_return_rebound_opt(dirty, move(bound));
-        }
+            val = result;
+            return air_status_next;
+          }
 
-      case index_defer_expression:
-        {
-          const auto& altr = this->m_stor.as<S_defer_expression>();
+          if(rhs.type() == type_real) {
+            V_real& val = rhs.mut_real();
 
-          // Rebind the expression.
-          bool dirty = false;
-          auto bound = altr;
+            int64_t bits;
+            bcopy(bits, val);
+            bits ^= INT64_MIN;
 
-          do_rebind_nodes(dirty, bound.code_body, ctx);
+            bcopy(val, bits);
+            return air_status_next;
+          }
 
-          return do_return_rebound_opt(dirty, move(bound));
+          throw Runtime_Error(xtc_format,
+                   "Arithmetic negation not applicable (operand was `$1`)", rhs);
         }
 
-      case index_catch_expression:
+      case xop_notb:
         {
-          const auto& altr = this->m_stor.as<S_catch_expression>();
+          // Flip all bits (of all bytes) in the operand.
+          if(rhs.type() == type_boolean) {
+            V_boolean& val = rhs.mut_boolean();
+            val = !val;
+            return air_status_next;
+          }
 
-          // Rebind the expression.
-          bool dirty = false;
-          auto bound = altr;
+          if(rhs.type() == type_integer) {
+            V_integer& val = rhs.mut_integer();
+            val = ~val;
+            return air_status_next;
+          }
 
-          do_rebind_nodes(dirty, bound.code_body, ctx);
+          if(rhs.type() == type_string) {
+            V_string& val = rhs.mut_string();
+            for(auto it = val.mut_begin();  it != val.end();  ++it)
+              *it = static_cast<char>(*it ^ -1);
+            return air_status_next;
+          }
 
-          return do_return_rebound_opt(dirty, move(bound));
+          throw Runtime_Error(xtc_format,
+                   "Bitwise NOT not applicable (operand was `$1`)", rhs);
         }
 
-      case index_coalesce_expression:
+      case xop_notl:
         {
-          const auto& altr = this->m_stor.as<S_coalesce_expression>();
+          // Perform the builtin boolean conversion and negate the result.
+          rhs = !rhs.test();
+          return air_status_next;
+        }
 
-          // Rebind the null branch.
-          bool dirty = false;
-          auto bound = altr;
+      case xop_countof:
+        {
+          // Get the number of elements in the operand.
+          if(rhs.type() == type_null) {
+            rhs = V_integer(0);
+            return air_status_next;
+          }
 
-          do_rebind_nodes(dirty, bound.code_null, ctx);
+          if(rhs.type() == type_string) {
+            rhs = V_integer(rhs.as_string().size());
+            return air_status_next;
+          }
 
-          return do_return_rebound_opt(dirty, move(bound));
-        }
+          if(rhs.type() == type_array) {
+            rhs = V_integer(rhs.as_array().size());
+            return air_status_next;
+          }
 
-      default:
-        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
-    }
-  }
+          if(rhs.type() == type_object) {
+            rhs = V_integer(rhs.as_object().size());
+            return air_status_next;
+          }
 
-void
-AIR_Node::
-collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
-  {
-    switch(static_cast<Index>(this->m_stor.index()))
-      {
-      case index_clear_stack:
-      case index_declare_variable:
-      case index_initialize_variable:
-      case index_throw_statement:
-      case index_assert_statement:
-      case index_simple_status:
-      case index_check_argument:
-      case index_push_global_reference:
-      case index_push_local_reference:
-      case index_function_call:
-      case index_push_unnamed_array:
-      case index_push_unnamed_object:
-      case index_apply_operator:
-      case index_unpack_array:
-      case index_unpack_object:
-      case index_define_null_variable:
-      case index_single_step_trap:
-      case index_variadic_call:
-      case index_import_call:
-      case index_declare_reference:
-      case index_initialize_reference:
-      case index_return_statement:
-      case index_alt_clear_stack:
-      case index_alt_function_call:
-      case index_member_access:
-      case index_apply_operator_bi32:
-      case index_return_statement_bi32:
-        return;
+          throw Runtime_Error(xtc_format,
+                   "`countof` not applicable (operand was `$1`)", rhs);
+        }
 
-      case index_execute_block:
+      case xop_typeof:
         {
-          const auto& altr = this->m_stor.as<S_execute_block>();
-
-          // Collect variables from the body.
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          return;
+          // Ge the type of the operand as a string.
+          rhs = ::rocket::sref(describe_type(rhs.type()));
+          return air_status_next;
         }
 
-      case index_if_statement:
+      case xop_sqrt:
         {
-          const auto& altr = this->m_stor.as<S_if_statement>();
+          // Get the arithmetic square root of the operand, as a real number.
+          if(rhs.is_real()) {
+            rhs = ::std::sqrt(rhs.as_real());
+            return air_status_next;
+          }
 
-          // Collect variables from both branches.
-          do_collect_variables_for_each(staged, temp, altr.code_true);
-          do_collect_variables_for_each(staged, temp, altr.code_false);
-          return;
+          throw Runtime_Error(xtc_format,
+                   "`__sqrt` not applicable (operand was `$1`)", rhs);
         }
 
-      case index_switch_statement:
+      case xop_isnan:
         {
-          const auto& altr = this->m_stor.as<S_switch_statement>();
-
-          // Collect variables from all labels and clauses.
-          for(const auto& clause : altr.clauses) {
-            do_collect_variables_for_each(staged, temp, clause.code_label);
-            do_collect_variables_for_each(staged, temp, clause.code_body);
+          // Checks whether the operand is a NaN. The operand must be of an
+          // arithmetic type. An integer is never a NaN.
+          if(rhs.type() == type_integer) {
+            rhs = false;
+            return air_status_next;
           }
-          return;
-        }
 
-      case index_do_while_statement:
-        {
-          const auto& altr = this->m_stor.as<S_do_while_statement>();
+          if(rhs.type() == type_real) {
+            rhs = ::std::isnan(rhs.as_real());
+            return air_status_next;
+          }
 
-          // Collect variables from the body and the condition expression.
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          do_collect_variables_for_each(staged, temp, altr.code_cond);
-          return;
+          throw Runtime_Error(xtc_format,
+                   "`__isnan` not applicable (operand was `$1`)", rhs);
         }
 
-      case index_while_statement:
+      case xop_isinf:
         {
-          const auto& altr = this->m_stor.as<S_while_statement>();
+          // Checks whether the operand is an infinity. The operand must be of
+          // an arithmetic type. An integer is never an infinity.
+          if(rhs.type() == type_integer) {
+            rhs = false;
+            return air_status_next;
+          }
 
-          // Collect variables from the condition expression and the body.
-          do_collect_variables_for_each(staged, temp, altr.code_cond);
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          return;
+          if(rhs.type() == type_real) {
+            rhs = ::std::isinf(rhs.as_real());
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "`__isinf` not applicable (operand was `$1`)", rhs);
         }
 
-      case index_for_each_statement:
+      case xop_abs:
         {
-          const auto& altr = this->m_stor.as<S_for_each_statement>();
+          // Get the absolute value of the operand.
+          if(rhs.type() == type_integer) {
+            V_integer& val = rhs.mut_integer();
 
-          // Collect variables from the range initializer and the body.
-          do_collect_variables_for_each(staged, temp, altr.code_init);
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          return;
-        }
+            V_integer neg_val;
+            if(ROCKET_SUB_OVERFLOW(0, val, &neg_val))
+              throw Runtime_Error(xtc_format,
+                       "Integer negation overflow (operand was `$1`)", val);
 
-      case index_for_statement:
-        {
-          const auto& altr = this->m_stor.as<S_for_statement>();
+            val ^= (val ^ neg_val) & (val >> 63);
+            return air_status_next;
+          }
 
-          // Collect variables from the initializer, condition expression and
-          // step expression.
-          do_collect_variables_for_each(staged, temp, altr.code_init);
-          do_collect_variables_for_each(staged, temp, altr.code_cond);
-          do_collect_variables_for_each(staged, temp, altr.code_step);
-          return;
-        }
+          if(rhs.type() == type_real) {
+            V_real& val = rhs.mut_real();
 
-      case index_try_statement:
-        {
-          const auto& altr = this->m_stor.as<S_try_statement>();
+            double result = ::std::fabs(val);
 
-          // Collect variables from the `try` and `catch` clauses.
-          do_collect_variables_for_each(staged, temp, altr.code_try);
-          do_collect_variables_for_each(staged, temp, altr.code_catch);
-          return;
+            val = result;
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "`__abs` not applicable (operand was `$1`)", rhs);
         }
 
-      case index_push_bound_reference:
+      case xop_sign:
         {
-          const auto& altr = this->m_stor.as<S_push_bound_reference>();
+          // Get the sign bit of the operand as a boolean value.
+          if(rhs.type() == type_integer) {
+            rhs = rhs.as_integer() < 0;
+            return air_status_next;
+          }
 
-          // Collect variables from the bound reference.
-          altr.ref.collect_variables(staged, temp);
-          return;
+          if(rhs.type() == type_real) {
+            rhs = ::std::signbit(rhs.as_real());
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "`__sign` not applicable (operand was `$1`)", rhs);
         }
 
-      case index_define_function:
+      case xop_round:
         {
-          const auto& altr = this->m_stor.as<S_define_function>();
+          // Round the operand to the nearest integer of the same type.
+          if(rhs.type() == type_integer) {
+            return air_status_next;
+          }
 
-          // Collect variables from the function body.
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          return;
+          if(rhs.type() == type_real) {
+            rhs.mut_real() = ::std::round(rhs.as_real());
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "`__round` not applicable (operand was `$1`)", rhs);
         }
 
-      case index_branch_expression:
+      case xop_floor:
         {
-          const auto& altr = this->m_stor.as<S_branch_expression>();
+          // Round the operand to the nearest integer of the same type,
+          // towards negative infinity.
+          if(rhs.type() == type_integer) {
+            return air_status_next;
+          }
 
-          // Collect variables from both branches.
-          do_collect_variables_for_each(staged, temp, altr.code_true);
-          do_collect_variables_for_each(staged, temp, altr.code_false);
-          return;
+          if(rhs.type() == type_real) {
+            rhs.mut_real() = ::std::floor(rhs.as_real());
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "`__floor` not applicable (operand was `$1`)", rhs);
         }
 
-      case index_defer_expression:
+      case xop_ceil:
         {
-          const auto& altr = this->m_stor.as<S_defer_expression>();
+          // Round the operand to the nearest integer of the same type,
+          // towards positive infinity.
+          if(rhs.type() == type_integer) {
+            return air_status_next;
+          }
 
-          // Collect variables from the expression.
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          return;
+          if(rhs.type() == type_real) {
+            rhs.mut_real() = ::std::ceil(rhs.as_real());
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "`__ceil` not applicable (operand was `$1`)", rhs);
         }
 
-      case index_catch_expression:
+      case xop_trunc:
         {
-          const auto& altr = this->m_stor.as<S_catch_expression>();
+          // Truncate the operand to the nearest integer towards zero.
+          if(rhs.type() == type_integer) {
+            return air_status_next;
+          }
 
-          // Collect variables from the expression.
-          do_collect_variables_for_each(staged, temp, altr.code_body);
-          return;
+          if(rhs.type() == type_real) {
+            rhs.mut_real() = ::std::trunc(rhs.as_real());
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "`__trunc` not applicable (operand was `$1`)", rhs);
         }
 
-      case index_push_constant:
+      case xop_iround:
         {
-          const auto& altr = this->m_stor.as<S_push_constant>();
+          // Round the operand to the nearest integer.
+          if(rhs.type() == type_integer) {
+            return air_status_next;
+          }
 
-          // Collect variables from the expression.
-          altr.val.collect_variables(staged, temp);
-          return;
+          if(rhs.type() == type_real) {
+            rhs = safe_double_to_int64(::std::round(rhs.as_real()));
+            return air_status_next;
+          }
+
+          throw Runtime_Error(xtc_format,
+                   "`__iround` not applicable (operand was `$1`)", rhs);
         }
 
-      case index_coalesce_expression:
+      case xop_ifloor:
         {
-          const auto& altr = this->m_stor.as<S_coalesce_expression>();
+          // Round the operand to the nearest integer towards negative infinity.
+          if(rhs.type() == type_integer) {
+            return air_status_next;
+          }
 
-          // Collect variables from the null branch.
-          do_collect_variables_for_each(staged, temp, altr.code_null);
-          return;
-        }
+          if(rhs.type() == type_real) {
+            rhs = safe_double_to_int64(::std::floor(rhs.as_real()));
+            return air_status_next;
+          }
 
-      default:
-        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
-    }
-  }
+          throw Runtime_Error(xtc_format,
+                   "`__ifloor` not applicable (operand was `$1`)", rhs);
+        }
 
-void
-AIR_Node::
-solidify(AVM_Rod& rod) const
-  {
-    switch(static_cast<Index>(this->m_stor.index()))
-      {
-      case index_clear_stack:
+      case xop_iceil:
         {
-          const auto& altr = this->m_stor.as<S_clear_stack>();
-
-          (void) altr;
+          // Round the operand to the nearest integer towards positive infinity.
+          if(rhs.type() == type_integer) {
+            return air_status_next;
+          }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* /*head*/) -> AIR_Status
-            {
-              ctx.stack().clear();
-              return air_status_next;
-            }
+          if(rhs.type() == type_real) {
+            rhs = safe_double_to_int64(::std::ceil(rhs.as_real()));
+            return air_status_next;
+          }
 
-            // Uparam
-            , Uparam()
+          throw Runtime_Error(xtc_format,
+                   "`__iceil` not applicable (operand was `$1`)", rhs);
+        }
 
-            // Sparam
-            , 0, nullptr, nullptr, nullptr
+      case xop_itrunc:
+        {
+          // Truncate the operand to the nearest integer towards zero.
+          if(rhs.type() == type_integer) {
+            return air_status_next;
+          }
 
-            // Collector
-            , nullptr
+          if(rhs.type() == type_real) {
+            rhs = safe_double_to_int64(::std::trunc(rhs.as_real()));
+            return air_status_next;
+          }
 
-            // Symbols
-            , nullptr
-          );
-          return;
+          throw Runtime_Error(xtc_format,
+                   "`__itrunc` not applicable (operand was `$1`)", rhs);
         }
 
-      case index_execute_block:
+      case xop_lzcnt:
         {
-          const auto& altr = this->m_stor.as<S_execute_block>();
+          // Get the number of leading zeroes in the operand.
+          if(rhs.type() == type_integer) {
+            V_integer& val = rhs.mut_integer();
 
-          struct Sparam
-            {
-              AVM_Rod rod_body;
-            };
+            val = (int64_t) ROCKET_LZCNT64((uint64_t) val);
+            return air_status_next;
+          }
 
-          Sparam sp2;
-          do_solidify_nodes(sp2.rod_body, altr.code_body);
+          throw Runtime_Error(xtc_format,
+                   "`__lzcnt` not applicable (operand was `$1`)", rhs);
+        }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+      case xop_tzcnt:
+        {
+          // Get the number of trailing zeroes in the operand.
+          if(rhs.type() == type_integer) {
+            V_integer& val = rhs.mut_integer();
 
-              // Execute the block on a new context. The block may contain control
-              // statements, so the status shall be forwarded verbatim.
-              return do_execute_block(sp.rod_body, ctx);
-            }
+            val = (int64_t) ROCKET_TZCNT64((uint64_t) val);
+            return air_status_next;
+          }
 
-            // Uparam
-            , Uparam()
+          throw Runtime_Error(xtc_format,
+                   "`__tzcnt` not applicable (operand was `$1`)", rhs);
+        }
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+      case xop_popcnt:
+        {
+          // Get the number of ones in the operand.
+          if(rhs.type() == type_integer) {
+            V_integer& val = rhs.mut_integer();
 
-            // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.rod_body.collect_variables(staged, temp);
-            }
+            val = (int64_t) ROCKET_POPCNT64((uint64_t) val);
+            return air_status_next;
+          }
 
-            // Symbols
-            , nullptr
-          );
-          return;
+          throw Runtime_Error(xtc_format,
+                   "`__popcnt` not applicable (operand was `$1`)", rhs);
         }
 
-      case index_declare_variable:
-        {
-          const auto& altr = this->m_stor.as<S_declare_variable>();
+      default:
+        ROCKET_UNREACHABLE();
+    }
+  }
 
-          struct Sparam
-            {
-              phsh_string name;
-            };
+AIR_Status
+do_apply_fma_operator(Value& lhs, const Value& mid, const Value& rhs)
+  {
+    // Perform floating-point fused multiply-add.
+    if(lhs.is_real() && mid.is_real() && rhs.is_real()) {
+      V_real& val = lhs.mut_real();
+      V_real y_mul = mid.as_real();
+      V_real z_add = rhs.as_real();
 
-          Sparam sp2;
-          sp2.name = altr.name;
+      val = ::std::fma(val, y_mul, z_add);
+      return air_status_next;
+    }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              const auto& sloc = head->pv_meta->sloc;
+    throw Runtime_Error(xtc_format,
+             "`__fma` not applicable (operands were `$1`, `$2` and `$3`)",
+             lhs, mid, rhs);
+  }
 
-              // Allocate a variable and inject it into the current context.
-              const auto gcoll = ctx.global().garbage_collector();
-              const auto var = gcoll->create_variable();
-              ctx.insert_named_reference(sp.name).set_variable(var);
+// An operator site is quickened after it has seen operands of the same type
+// for this number of times in a row.
+constexpr uint8_t quick_warmup_count = 16;
 
-              if(auto hooks = ctx.global().get_hooks_opt())
-                hooks->on_declare(sloc, sp.name);
+// This is the type feedback of a binary operator site. It is updated as the
+// operator is executed.
+struct Quick_Feedback
+  {
+    mutable Type qtype;
+    mutable uint8_t count;
+  };
 
-              // Push a copy of the reference onto the stack, which we will get
-              // back after the initializer finishes execution.
-              ctx.stack().push().set_variable(var);
-              return air_status_next;
-            }
+bool
+do_is_quickenable_operator(uint8_t uxop, Type qtype) noexcept
+  {
+    switch(uxop)
+      {
+      case xop_cmp_eq:
+      case xop_cmp_ne:
+      case xop_cmp_lt:
+      case xop_cmp_gt:
+      case xop_cmp_lte:
+      case xop_cmp_gte:
+      case xop_add:
+        return ::rocket::is_any_of(qtype, { type_integer, type_real, type_string });
 
-            // Uparam
-            , Uparam()
+      case xop_cmp_3way:
+        return ::rocket::is_any_of(qtype, { type_integer, type_string });
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+      case xop_sub:
+      case xop_mul:
+        return ::rocket::is_any_of(qtype, { type_integer, type_real });
 
-            // Collector
-            , nullptr
+      case xop_div:
+        return qtype == type_real;
 
-            // Symbols
-            , &(altr.sloc)
-          );
-          return;
-        }
+      default:
+        return false;
+    }
+  }
 
-      case index_initialize_variable:
-        {
-          const auto& altr = this->m_stor.as<S_initialize_variable>();
-
-          Uparam up2;
-          up2.b0 = altr.immutable;
+void
+do_update_quick_feedback(const Quick_Feedback& qfb, uint8_t uxop, const Value& lhs,
+                         const Value& rhs) noexcept
+  {
+    // Count executions with operands of the same type. Any other type resets
+    // the counter.
+    if((lhs.type() != rhs.type()) || !do_is_quickenable_operator(uxop, lhs.type()))
+      qfb.count = 0;
+    else if(lhs.type() != qfb.qtype) {
+      qfb.qtype = lhs.type();
+      qfb.count = 1;
+    }
+    else if(qfb.count < quick_warmup_count)
+      qfb.count ++;
+  }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const bool immutable = head->uparam.b0;
+// These are specialized implementations of binary operators for quickened
+// sites. The caller shall have checked that both operands are of the type
+// in question. If the result can't be calculated without a trip to the
+// generic implementation, such as overflows or unordered comparisons, `false`
+// is returned, and `lhs` is left intact.
+ROCKET_ALWAYS_INLINE
+bool
+do_apply_binary_operator_quick_integer(uint8_t uxop, Value& lhs, V_integer other)
+  {
+    V_integer& val = lhs.mut_integer();
+    int64_t result;
 
-              // Read the value of the initializer. The initializer must not have
-              // been empty for this function.
-              const auto& val = ctx.stack().top().dereference_readonly();
-              ctx.stack().pop();
+    switch(uxop)
+      {
+      case xop_cmp_eq:
+        lhs = val == other;
+        return true;
 
-              // Get the variable back.
-              auto var = ctx.stack().top().unphase_variable_opt();
-              ctx.stack().pop();
-              ROCKET_ASSERT(var && !var->is_initialized());
+      case xop_cmp_ne:
+        lhs = val != other;
+        return true;
 
-              // Initialize it with this value.
-              var->initialize(val);
-              var->set_immutable(immutable);
-              return air_status_next;
-            }
+      case xop_cmp_lt:
+        lhs = val < other;
+        return true;
 
-            // Uparam
-            , up2
+      case xop_cmp_gt:
+        lhs = val > other;
+        return true;
 
-            // Sparam
-            , 0, nullptr, nullptr, nullptr
+      case xop_cmp_lte:
+        lhs = val <= other;
+        return true;
 
-            // Collector
-            , nullptr
+      case xop_cmp_gte:
+        lhs = val >= other;
+        return true;
 
-            // Symbols
-            , &(altr.sloc)
-          );
-          return;
-        }
+      case xop_cmp_3way:
+        lhs = (V_integer) (val > other) - (val < other);
+        return true;
 
-      case index_if_statement:
-        {
-          const auto& altr = this->m_stor.as<S_if_statement>();
+      case xop_add:
+        if(ROCKET_ADD_OVERFLOW(val, other, &result))
+          return false;
 
-          Uparam up2;
-          up2.b0 = altr.negative;
+        val = result;
+        return true;
 
-          struct Sparam
-            {
-              AVM_Rod rod_true;
-              AVM_Rod rod_false;
-            };
+      case xop_sub:
+        if(ROCKET_SUB_OVERFLOW(val, other, &result))
+          return false;
 
-          Sparam sp2;
-          do_solidify_nodes(sp2.rod_true, altr.code_true);
-          do_solidify_nodes(sp2.rod_false, altr.code_false);
+        val = result;
+        return true;
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const bool negative = head->uparam.b0;
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+      case xop_mul:
+        if(ROCKET_MUL_OVERFLOW(val, other, &result))
+          return false;
 
-              // Read the condition and execute the corresponding branch as a block.
-              return (ctx.stack().top().dereference_readonly().test() != negative)
-                        ? do_execute_block(sp.rod_true, ctx)
-                        : do_execute_block(sp.rod_false, ctx);
-            }
+        val = result;
+        return true;
 
-            // Uparam
-            , up2
+      default:
+        return false;
+    }
+  }
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+ROCKET_ALWAYS_INLINE
+bool
+do_apply_binary_operator_quick_real(uint8_t uxop, Value& lhs, V_real other)
+  {
+    V_real& val = lhs.mut_real();
 
-            // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.rod_true.collect_variables(staged, temp);
-              sp.rod_false.collect_variables(staged, temp);
-            }
+    switch(uxop)
+      {
+      case xop_cmp_eq:
+        lhs = val == other;
+        return true;
 
-            // Symbols
-            , nullptr
-          );
-          return;
-        }
+      case xop_cmp_ne:
+        lhs = val != other;
+        return true;
 
-      case index_switch_statement:
+      case xop_cmp_lt:
+      case xop_cmp_gt:
+      case xop_cmp_lte:
+      case xop_cmp_gte:
         {
-          const auto& altr = this->m_stor.as<S_switch_statement>();
-
-          struct Clause
-            {
-              AVM_Rod rod_label;
-              AVM_Rod rod_body;
-              cow_vector<phsh_string> names_added;
-            };
+          // Unordered operands shall cause exceptions.
+          if(::std::isunordered(val, other))
+            return false;
+
+          if(uxop == xop_cmp_lt)
+            lhs = val < other;
+          else if(uxop == xop_cmp_gt)
+            lhs = val > other;
+          else if(uxop == xop_cmp_lte)
+            lhs = val <= other;
+          else
+            lhs = val >= other;
+          return true;
+        }
 
-          struct Sparam
-            {
-              cow_vector<Clause> clauses;
-            };
+      case xop_add:
+        val += other;
+        return true;
 
-          Sparam sp2;
-          for(const auto& clause : altr.clauses) {
-            auto& r = sp2.clauses.emplace_back();
-            do_solidify_nodes(r.rod_label, clause.code_label);
-            do_solidify_nodes(r.rod_body, clause.code_body);
-            r.names_added = clause.names_added;
-          }
+      case xop_sub:
+        val -= other;
+        return true;
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+      case xop_mul:
+        val *= other;
+        return true;
 
-              // Read the value of the condition and find the target clause for it.
-              auto cond = ctx.stack().top().dereference_readonly();
-              uint32_t target_index = UINT32_MAX;
+      case xop_div:
+        val /= other;
+        return true;
 
-              // This is different from the `switch` statement in C, where `case` labels must
-              // have constant operands.
-              for(uint32_t i = 0;  i < sp.clauses.size();  ++i) {
-                // This is a `default` clause if the condition is empty, and a `case` clause
-                // otherwise.
-                if(sp.clauses.at(i).rod_label.empty()) {
-                  target_index = i;
-                  continue;
-                }
+      default:
+        return false;
+    }
+  }
 
-                // Evaluate the operand and check whether it equals `cond`.
-                AIR_Status status = sp.clauses.at(i).rod_label.execute(ctx);
-                ROCKET_ASSERT(status == air_status_next);
-                if(ctx.stack().top().dereference_readonly().compare_partial(cond) == compare_equal) {
-                  target_index = i;
-                  break;
-                }
-              }
+ROCKET_ALWAYS_INLINE
+bool
+do_apply_binary_operator_quick_string(uint8_t uxop, Value& lhs, const V_string& other)
+  {
+    V_string& val = lhs.mut_string();
 
-              // Skip this statement if no matching clause has been found.
-              if(target_index >= sp.clauses.size())
-                return air_status_next;
+    switch(uxop)
+      {
+      case xop_cmp_eq:
+        lhs = val == other;
+        return true;
 
-              // Jump to the target clause.
-              Executive_Context ctx_body(xtc_plain, ctx);
-              AIR_Status status = air_status_next;
-              try {
-                for(size_t i = 0;  i < sp.clauses.size();  ++i)
-                  if(i < target_index) {
-                    // Inject bypassed names into the scope.
-                    for(const auto& name : sp.clauses.at(i).names_added)
-                      ctx_body.insert_named_reference(name);
-                  }
-                  else {
-                    // Execute the body of this clause.
-                    AIR_Status next_status = sp.clauses.at(i).rod_body.execute(ctx_body);
-                    if(next_status != air_status_next) {
-                      if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_switch }))
-                        status = next_status;
-                      break;
-                    }
-                  }
-              }
-              catch(Runtime_Error& except) {
-                ctx_body.on_scope_exit_exceptional(except);
-                throw;
-              }
-              ctx_body.on_scope_exit_normal(status);
-              return status;
-            }
+      case xop_cmp_ne:
+        lhs = val != other;
+        return true;
 
-            // Uparam
-            , Uparam()
+      case xop_cmp_lt:
+        lhs = val.compare(other) < 0;
+        return true;
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+      case xop_cmp_gt:
+        lhs = val.compare(other) > 0;
+        return true;
 
-            // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              for(const auto& r : sp.clauses) {
-                r.rod_label.collect_variables(staged, temp);
-                r.rod_body.collect_variables(staged, temp);
-              }
-            }
+      case xop_cmp_lte:
+        lhs = val.compare(other) <= 0;
+        return true;
 
-            // Symbols
-            , nullptr
-          );
-          return;
-        }
+      case xop_cmp_gte:
+        lhs = val.compare(other) >= 0;
+        return true;
 
-      case index_do_while_statement:
+      case xop_cmp_3way:
         {
-          const auto& altr = this->m_stor.as<S_do_while_statement>();
+          int cmp = val.compare(other);
+          lhs = (V_integer) (cmp > 0) - (cmp < 0);
+          return true;
+        }
 
-          Uparam up2;
-          up2.b0 = altr.negative;
+      case xop_add:
+        val.append(other);
+        return true;
 
-          struct Sparam
-            {
-              AVM_Rod rods_body;
-              AVM_Rod rods_cond;
-            };
+      default:
+        return false;
+    }
+  }
 
-          Sparam sp2;
-          do_solidify_nodes(sp2.rods_body, altr.code_body);
-          do_solidify_nodes(sp2.rods_cond, altr.code_cond);
+}  // namespace
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const bool negative = head->uparam.b0;
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+opt<Value>
+AIR_Node::
+get_constant_opt() const noexcept
+  {
+    switch(this->m_stor.index())
+      {
+      case index_push_bound_reference:
+        try {
+          const auto& altr = this->m_stor.as<S_push_bound_reference>();
+          if(altr.ref.is_temporary())
+            return altr.ref.dereference_readonly();
+        }
+        catch(...) { }
+        return nullopt;
+
+      case index_push_constant:
+        return this->m_stor.as<S_push_constant>().val;
+
+      default:
+        return nullopt;
+    }
+  }
+
+bool
+AIR_Node::
+is_terminator() const noexcept
+  {
+    switch(static_cast<Index>(this->m_stor.index()))
+      {
+      case index_clear_stack:
+      case index_declare_variable:
+      case index_initialize_variable:
+      case index_switch_statement:
+      case index_do_while_statement:
+      case index_while_statement:
+      case index_for_each_statement:
+      case index_for_statement:
+      case index_try_statement:
+      case index_assert_statement:
+      case index_check_argument:
+      case index_push_global_reference:
+      case index_push_local_reference:
+      case index_push_bound_reference:
+      case index_define_function:
+      case index_push_unnamed_array:
+      case index_push_unnamed_object:
+      case index_apply_operator:
+      case index_unpack_array:
+      case index_unpack_object:
+      case index_define_null_variable:
+      case index_single_step_trap:
+      case index_defer_expression:
+      case index_import_call:
+      case index_declare_reference:
+      case index_initialize_reference:
+      case index_catch_expression:
+      case index_push_constant:
+      case index_alt_clear_stack:
+      case index_coalesce_expression:
+      case index_member_access:
+      case index_apply_operator_bi32:
+      case index_return_statement_bi32:
+      case index_push_captured_reference:
+      case index_inline_call:
+        return false;
+
+      case index_throw_statement:
+      case index_return_statement:
+        return true;
+
+      case index_simple_status:
+        return this->m_stor.as<S_simple_status>().status != air_status_next;
+
+      case index_function_call:
+        return this->m_stor.as<S_function_call>().ptc != ptc_aware_none;
+
+      case index_variadic_call:
+        return this->m_stor.as<S_variadic_call>().ptc != ptc_aware_none;
+
+      case index_alt_function_call:
+        return this->m_stor.as<S_alt_function_call>().ptc != ptc_aware_none;
+
+      case index_execute_block:
+        {
+          const auto& altr = this->m_stor.as<S_execute_block>();
+          return !altr.code_body.empty() && altr.code_body.back().is_terminator();
+        }
+
+      case index_if_statement:
+        {
+          const auto& altr = this->m_stor.as<S_if_statement>();
+          return !altr.code_true.empty() && altr.code_true.back().is_terminator()
+                 && !altr.code_false.empty() && altr.code_false.back().is_terminator();
+        }
+
+      case index_branch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_branch_expression>();
+          return !altr.code_true.empty() && altr.code_true.back().is_terminator()
+                 && !altr.code_false.empty() && altr.code_false.back().is_terminator();
+        }
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
+    }
+  }
+
+opt<Value>
+AIR_Node::
+fold_operator_opt(const Value* ops, size_t nops) const
+  {
+    opt<Value> res;
+    try {
+      if(this->m_stor.index() == index_apply_operator_bi32) {
+        const auto& altr = this->m_stor.as<S_apply_operator_bi32>();
+        if(altr.assign || (nops != 1) || ::rocket::is_any_of(altr.xop, { xop_assign, xop_index }))
+          return res;
+
+        // The second operand is encoded in the node.
+        Value lhs = ops[0];
+        do_apply_binary_operator_with_integer(altr.xop, lhs, altr.irhs);
+        res.emplace(move(lhs));
+        return res;
+      }
+
+      if(this->m_stor.index() != index_apply_operator)
+        return res;
+
+      const auto& altr = this->m_stor.as<S_apply_operator>();
+      if(altr.assign)
+        return res;
+
+      switch(altr.xop)
+        {
+        case xop_pos:
+        case xop_neg:
+        case xop_notb:
+        case xop_notl:
+        case xop_countof:
+        case xop_typeof:
+        case xop_sqrt:
+        case xop_isnan:
+        case xop_isinf:
+        case xop_abs:
+        case xop_sign:
+        case xop_round:
+        case xop_floor:
+        case xop_ceil:
+        case xop_trunc:
+        case xop_iround:
+        case xop_ifloor:
+        case xop_iceil:
+        case xop_itrunc:
+        case xop_lzcnt:
+        case xop_tzcnt:
+        case xop_popcnt:
+          {
+            if(nops != 1)
+              return res;
+
+            Value rhs = ops[0];
+            do_apply_unary_operator(altr.xop, rhs);
+            res.emplace(move(rhs));
+            return res;
+          }
+
+        case xop_cmp_eq:
+        case xop_cmp_ne:
+        case xop_cmp_un:
+        case xop_cmp_lt:
+        case xop_cmp_gt:
+        case xop_cmp_lte:
+        case xop_cmp_gte:
+        case xop_cmp_3way:
+        case xop_add:
+        case xop_sub:
+        case xop_mul:
+        case xop_div:
+        case xop_mod:
+        case xop_andb:
+        case xop_orb:
+        case xop_xorb:
+        case xop_addm:
+        case xop_subm:
+        case xop_mulm:
+        case xop_adds:
+        case xop_subs:
+        case xop_muls:
+          {
+            if(nops != 2)
+              return res;
+
+            Value lhs = ops[0];
+            do_apply_binary_operator(altr.xop, lhs, ops[1]);
+            res.emplace(move(lhs));
+            return res;
+          }
+
+        case xop_sll:
+        case xop_srl:
+        case xop_sla:
+        case xop_sra:
+          {
+            if((nops != 2) || !ops[1].is_integer())
+              return res;
+
+            Value lhs = ops[0];
+            do_apply_binary_operator_with_integer(altr.xop, lhs, ops[1].as_integer());
+            res.emplace(move(lhs));
+            return res;
+          }
+
+        case xop_fma:
+          {
+            if(nops != 3)
+              return res;
+
+            Value lhs = ops[0];
+            do_apply_fma_operator(lhs, ops[1], ops[2]);
+            res.emplace(move(lhs));
+            return res;
+          }
+
+        case xop_inc:
+        case xop_dec:
+        case xop_index:
+        case xop_unset:
+        case xop_head:
+        case xop_tail:
+        case xop_random:
+        case xop_isvoid:
+        case xop_assign:
+          // These operators have side effects, or yield references.
+          return res;
+
+        default:
+          ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), altr.xop);
+      }
+    }
+    catch(Runtime_Error&) {
+      // Leave the operator alone, so the error will be reported at run time.
+      return nullopt;
+    }
+  }
+
+opt<AIR_Node>
+AIR_Node::
+rebind_opt(Abstract_Context& ctx) const
+  {
+    switch(static_cast<Index>(this->m_stor.index()))
+      {
+      case index_clear_stack:
+      case index_declare_variable:
+      case index_initialize_variable:
+      case index_throw_statement:
+      case index_assert_statement:
+      case index_simple_status:
+      case index_check_argument:
+      case index_push_global_reference:
+      case index_push_bound_reference:
+      case index_function_call:
+      case index_push_unnamed_array:
+      case index_push_unnamed_object:
+      case index_apply_operator:
+      case index_unpack_array:
+      case index_unpack_object:
+      case index_define_null_variable:
+      case index_single_step_trap:
+      case index_variadic_call:
+      case index_import_call:
+      case index_declare_reference:
+      case index_initialize_reference:
+      case index_return_statement:
+      case index_push_constant:
+      case index_alt_clear_stack:
+      case index_alt_function_call:
+      case index_member_access:
+      case index_apply_operator_bi32:
+      case index_return_statement_bi32:
+        return nullopt;
+
+      case index_execute_block:
+        {
+          const auto& altr = this->m_stor.as<S_execute_block>();
+
+          // Rebind the body in a nested scope.
+          bool dirty = false;
+          auto bound = altr;
+
+          Analytic_Context ctx_body(xtc_plain, ctx);
+          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_if_statement:
+        {
+          const auto& altr = this->m_stor.as<S_if_statement>();
+
+          // Rebind both branches in a nested scope.
+          bool dirty = false;
+          auto bound = altr;
+
+          Analytic_Context ctx_body(xtc_plain, ctx);
+          do_rebind_nodes(dirty, bound.code_true, ctx_body);
+          do_rebind_nodes(dirty, bound.code_false, ctx_body);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_switch_statement:
+        {
+          const auto& altr = this->m_stor.as<S_switch_statement>();
+
+          // Rebind all labels and clauses.
+          bool dirty = false;
+          auto bound = altr;
+
+          Analytic_Context ctx_body(xtc_plain, ctx);
+          for(size_t k = 0;  k < bound.clauses.size();  ++k) {
+            // Labels are to be evaluated in the same scope as the condition
+            // expression, and are not parts of the body.
+            for(size_t i = 0;  i < bound.clauses.at(k).code_label.size();  ++i)
+              if(auto qnode = bound.clauses.at(k).code_label.at(i).rebind_opt(ctx))
+                do_set_rebound(dirty, bound.clauses.mut(k).code_label.mut(i), move(*qnode));
+
+            for(size_t i = 0;  i < bound.clauses.at(k).code_body.size();  ++i)
+              if(auto qnode = bound.clauses.at(k).code_body.at(i).rebind_opt(ctx_body))
+                do_set_rebound(dirty, bound.clauses.mut(k).code_body.mut(i), move(*qnode));
+          }
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_do_while_statement:
+        {
+          const auto& altr = this->m_stor.as<S_do_while_statement>();
+
+          // Rebind the body and the condition expression.
+          // The condition expression is not a part of the body.
+          bool dirty = false;
+          auto bound = altr;
+
+          Analytic_Context ctx_body(xtc_plain, ctx);
+          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+
+          do_rebind_nodes(dirty, bound.code_cond, ctx);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_while_statement:
+        {
+          const auto& altr = this->m_stor.as<S_while_statement>();
+
+          // Rebind the condition expression and the body.
+          // The condition expression is not a part of the body.
+          bool dirty = false;
+          auto bound = altr;
+
+          do_rebind_nodes(dirty, bound.code_cond, ctx);
+
+          Analytic_Context ctx_body(xtc_plain, ctx);
+          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_for_each_statement:
+        {
+          const auto& altr = this->m_stor.as<S_for_each_statement>();
+
+          // Rebind the range initializer and the body.
+          // The range key and mapped references are declared in a dedicated scope
+          // where the initializer is to be evaluated. The body is to be executed
+          // in an inner scope, created and destroyed for each iteration.
+          bool dirty = false;
+          auto bound = altr;
+
+          Analytic_Context ctx_for(xtc_plain, ctx);
+          if(!altr.name_key.empty())
+            ctx_for.insert_named_reference(altr.name_key);
+          ctx_for.insert_named_reference(altr.name_mapped);
+          do_rebind_nodes(dirty, bound.code_init, ctx_for);
+
+          Analytic_Context ctx_body(xtc_plain, ctx_for);
+          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_for_statement:
+        {
+          const auto& altr = this->m_stor.as<S_for_statement>();
+
+          // Rebind the initializer, condition expression and step expression. All
+          // these are declared in a dedicated scope where the initializer is to be
+          // evaluated. The body is to be executed in an inner scope, created and
+          // destroyed for each iteration.
+          bool dirty = false;
+          auto bound = altr;
+
+          Analytic_Context ctx_for(xtc_plain, ctx);
+          do_rebind_nodes(dirty, bound.code_init, ctx_for);
+          do_rebind_nodes(dirty, bound.code_cond, ctx_for);
+          do_rebind_nodes(dirty, bound.code_step, ctx_for);
+
+          Analytic_Context ctx_body(xtc_plain, ctx_for);
+          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_try_statement:
+        {
+          const auto& altr = this->m_stor.as<S_try_statement>();
+
+          // Rebind the `try` and `catch` clauses.
+          bool dirty = false;
+          auto bound = altr;
+
+          Analytic_Context ctx_try(xtc_plain, ctx);
+          do_rebind_nodes(dirty, bound.code_try, ctx_try);
+
+          Analytic_Context ctx_catch(xtc_plain, ctx);
+          ctx_catch.insert_named_reference(altr.name_except);
+          do_rebind_nodes(dirty, bound.code_catch, ctx_catch);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_push_local_reference:
+        {
+          const auto& altr = this->m_stor.as<S_push_local_reference>();
+
+          // Get the context.
+          const Abstract_Context* qctx = &ctx;
+          for(uint32_t k = 0;  k != altr.depth;  ++k)
+            qctx = qctx->get_parent_opt();
+
+          if(qctx->is_analytic())
+            return nullopt;
+
+          // Look for the name.
+          auto qref = qctx->get_named_reference_opt(altr.name);
+          if(!qref)
+            return nullopt;
+          else if(qref->is_invalid())
+            throw Runtime_Error(xtc_format,
+                     "Initialization of variable or reference `$1` bypassed", altr.name);
+
+          // Bind this reference.
+          S_push_bound_reference xnode = { *qref };
+          return move(xnode);
+        }
+
+      case index_push_captured_reference:
+        {
+          const auto& altr = this->m_stor.as<S_push_captured_reference>();
+
+          // Get the innermost executive context, then the function which it
+          // belongs to.
+          const Abstract_Context* qctx = &ctx;
+          while(qctx && qctx->is_analytic())
+            qctx = qctx->get_parent_opt();
+
+          auto qexec = dynamic_cast<const Executive_Context*>(qctx);
+          if(!qexec)
+            return nullopt;
+
+          while(qexec->get_parent_opt())
+            qexec = qexec->get_parent_opt();
+
+          auto qfunc = qexec->func_opt();
+          if(!qfunc)
+            return nullopt;
+
+          // Bind the captured reference. If it is unbound, leave it alone, so
+          // the error will be reported when it is used.
+          const auto& ref = qfunc->captures().at(altr.index);
+          if(ref.is_invalid())
+            return nullopt;
+
+          S_push_bound_reference xnode = { ref };
+          return move(xnode);
+        }
 
-              // This is identical to C.
-              AIR_Status status = air_status_next;
-              for(;;) {
-                // Execute the body.
-                AIR_Status next_status = do_execute_block(sp.rods_body, ctx);
-                if(::rocket::is_none_of(next_status, { air_status_next, air_status_continue_unspec,
-                                                       air_status_continue_while })) {
-                  if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_while }))
-                    status = next_status;
-                  break;
-                }
+      case index_define_function:
+        {
+          const auto& altr = this->m_stor.as<S_define_function>();
 
-                // Check the condition.
-                next_status = sp.rods_cond.execute(ctx);
-                ROCKET_ASSERT(next_status == air_status_next);
-                if(ctx.stack().top().dereference_readonly().test() == negative)
-                  break;
-              }
-              return status;
-            }
+          // Rebind the function body.
+          // This is the only scenario where names in the outer scope are visible
+          // to the body of a function.
+          bool dirty = false;
+          auto bound = altr;
 
-            // Uparam
-            , up2
+          Analytic_Context ctx_func(xtc_function, &ctx, altr.params);
+          do_rebind_nodes(dirty, bound.code_body, ctx_func);
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+          return do_return_rebound_opt(dirty, move(bound));
+        }
 
-            // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.rods_body.collect_variables(staged, temp);
-              sp.rods_cond.collect_variables(staged, temp);
-            }
+      case index_branch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_branch_expression>();
 
-            // Symbols
-            , nullptr
-          );
+          // Rebind both branches.
+          bool dirty = false;
+          auto bound = altr;
+
+          do_rebind_nodes(dirty, bound.code_true, ctx);
+          do_rebind_nodes(dirty, bound.code_false, ctx);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_defer_expression:
+        {
+          const auto& altr = this->m_stor.as<S_defer_expression>();
+
+          // Rebind the expression.
+          bool dirty = false;
+          auto bound = altr;
+
+          do_rebind_nodes(dirty, bound.code_body, ctx);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_catch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_catch_expression>();
+
+          // Rebind the expression.
+          bool dirty = false;
+          auto bound = altr;
+
+          do_rebind_nodes(dirty, bound.code_body, ctx);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_coalesce_expression:
+        {
+          const auto& altr = this->m_stor.as<S_coalesce_expression>();
+
+          // Rebind the null branch.
+          bool dirty = false;
+          auto bound = altr;
+
+          do_rebind_nodes(dirty, bound.code_null, ctx);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      case index_inline_call:
+        {
+          const auto& altr = this->m_stor.as<S_inline_call>();
+
+          // Rebind the body in a nested scope, where arguments are bound to
+          // parameters.
+          bool dirty = false;
+          auto bound = altr;
+
+          Analytic_Context ctx_body(xtc_plain, ctx);
+          for(const auto& name : altr.params)
+            ctx_body.insert_named_reference(name);
+          do_rebind_nodes(dirty, bound.code_body, ctx_body);
+
+          return do_return_rebound_opt(dirty, move(bound));
+        }
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
+    }
+  }
+
+void
+AIR_Node::
+collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
+  {
+    switch(static_cast<Index>(this->m_stor.index()))
+      {
+      case index_clear_stack:
+      case index_declare_variable:
+      case index_initialize_variable:
+      case index_throw_statement:
+      case index_assert_statement:
+      case index_simple_status:
+      case index_check_argument:
+      case index_push_global_reference:
+      case index_push_local_reference:
+      case index_function_call:
+      case index_push_unnamed_array:
+      case index_push_unnamed_object:
+      case index_apply_operator:
+      case index_unpack_array:
+      case index_unpack_object:
+      case index_define_null_variable:
+      case index_single_step_trap:
+      case index_variadic_call:
+      case index_import_call:
+      case index_declare_reference:
+      case index_initialize_reference:
+      case index_return_statement:
+      case index_alt_clear_stack:
+      case index_alt_function_call:
+      case index_member_access:
+      case index_apply_operator_bi32:
+      case index_return_statement_bi32:
+      case index_push_captured_reference:
+        return;
+
+      case index_execute_block:
+        {
+          const auto& altr = this->m_stor.as<S_execute_block>();
+
+          // Collect variables from the body.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
           return;
         }
 
-      case index_while_statement:
+      case index_if_statement:
         {
-          const auto& altr = this->m_stor.as<S_while_statement>();
+          const auto& altr = this->m_stor.as<S_if_statement>();
 
-          Uparam up2;
-          up2.b0 = altr.negative;
+          // Collect variables from both branches.
+          do_collect_variables_for_each(staged, temp, altr.code_true);
+          do_collect_variables_for_each(staged, temp, altr.code_false);
+          return;
+        }
 
-          struct Sparam
-            {
-              AVM_Rod rods_cond;
-              AVM_Rod rods_body;
-            };
+      case index_switch_statement:
+        {
+          const auto& altr = this->m_stor.as<S_switch_statement>();
 
-          Sparam sp2;
-          do_solidify_nodes(sp2.rods_cond, altr.code_cond);
-          do_solidify_nodes(sp2.rods_body, altr.code_body);
+          // Collect variables from all labels and clauses.
+          for(const auto& clause : altr.clauses) {
+            do_collect_variables_for_each(staged, temp, clause.code_label);
+            do_collect_variables_for_each(staged, temp, clause.code_body);
+          }
+          return;
+        }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const bool negative = head->uparam.b0;
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+      case index_do_while_statement:
+        {
+          const auto& altr = this->m_stor.as<S_do_while_statement>();
 
-              // This is identical to C.
-              AIR_Status status = air_status_next;
-              for(;;) {
-                // Check the condition.
-                AIR_Status next_status = sp.rods_cond.execute(ctx);
-                ROCKET_ASSERT(next_status == air_status_next);
-                if(ctx.stack().top().dereference_readonly().test() == negative)
-                  break;
+          // Collect variables from the body and the condition expression.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          do_collect_variables_for_each(staged, temp, altr.code_cond);
+          return;
+        }
 
-                // Execute the body.
-                next_status = do_execute_block(sp.rods_body, ctx);
-                if(::rocket::is_none_of(next_status, { air_status_next, air_status_continue_unspec,
-                                                       air_status_continue_while })) {
-                  if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_while }))
-                    status = next_status;
-                  break;
-                }
-              }
-              return status;
-            }
+      case index_while_statement:
+        {
+          const auto& altr = this->m_stor.as<S_while_statement>();
 
-            // Uparam
-            , up2
+          // Collect variables from the condition expression and the body.
+          do_collect_variables_for_each(staged, temp, altr.code_cond);
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+      case index_for_each_statement:
+        {
+          const auto& altr = this->m_stor.as<S_for_each_statement>();
 
-            // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.rods_cond.collect_variables(staged, temp);
-              sp.rods_body.collect_variables(staged, temp);
-            }
+          // Collect variables from the range initializer and the body.
+          do_collect_variables_for_each(staged, temp, altr.code_init);
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
 
-            // Symbols
-            , nullptr
-          );
+      case index_for_statement:
+        {
+          const auto& altr = this->m_stor.as<S_for_statement>();
+
+          // Collect variables from the initializer, condition expression and
+          // step expression.
+          do_collect_variables_for_each(staged, temp, altr.code_init);
+          do_collect_variables_for_each(staged, temp, altr.code_cond);
+          do_collect_variables_for_each(staged, temp, altr.code_step);
+          return;
+        }
+
+      case index_try_statement:
+        {
+          const auto& altr = this->m_stor.as<S_try_statement>();
+
+          // Collect variables from the `try` and `catch` clauses.
+          do_collect_variables_for_each(staged, temp, altr.code_try);
+          do_collect_variables_for_each(staged, temp, altr.code_catch);
           return;
         }
 
-      case index_for_each_statement:
+      case index_push_bound_reference:
         {
-          const auto& altr = this->m_stor.as<S_for_each_statement>();
-
-          struct Sparam
-            {
-              phsh_string name_key;
-              phsh_string name_mapped;
-              Source_Location sloc_init;
-              AVM_Rod rod_init;
-              AVM_Rod rod_body;
-            };
+          const auto& altr = this->m_stor.as<S_push_bound_reference>();
 
-          Sparam sp2;
-          sp2.name_key = altr.name_key;
-          sp2.name_mapped = altr.name_mapped;
-          sp2.sloc_init = altr.sloc_init;
-          do_solidify_nodes(sp2.rod_init, altr.code_init);
-          do_solidify_nodes(sp2.rod_body, altr.code_body);
+          // Collect variables from the bound reference.
+          altr.ref.collect_variables(staged, temp);
+          return;
+        }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+      case index_define_function:
+        {
+          const auto& altr = this->m_stor.as<S_define_function>();
 
-              // We have to create an outer context due to the fact that the key
-              // and mapped references outlast every iteration.
-              Executive_Context ctx_for(xtc_plain, ctx);
-              AIR_Status status = air_status_next;
-              try {
-                // Create key and mapped references.
-                Reference* qkey_ref = nullptr;
-                if(!sp.name_key.empty())
-                  qkey_ref = &(ctx_for.insert_named_reference(sp.name_key));
-                auto& mapped_ref = ctx_for.insert_named_reference(sp.name_mapped);
+          // Collect variables from the function body.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
 
-                // Evaluate the range initializer and set the range up, which isn't
-                // going to change for all loops.
-                AIR_Status next_status = sp.rod_init.execute(ctx_for);
-                ROCKET_ASSERT(next_status == air_status_next);
-                mapped_ref = move(ctx_for.stack().mut_top());
+      case index_branch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_branch_expression>();
 
-                const auto range = mapped_ref.dereference_readonly();
-                if(range.is_array()) {
-                  const auto& arr = range.as_array();
-                  mapped_ref.push_modifier(Reference_Modifier::S_array_head());  // placeholder
-                  for(int64_t i = 0;  i < arr.ssize();  ++i) {
-                    // Set the key variable which is the subscript of the mapped
-                    // element in the array.
-                    if(qkey_ref) {
-                      auto key_var = qkey_ref->unphase_variable_opt();
-                      if(!key_var) {
-                        key_var = ctx.global().garbage_collector()->create_variable();
-                        qkey_ref->set_variable(key_var);
-                      }
-                      key_var->initialize(i);
-                      key_var->set_immutable();
-                    }
+          // Collect variables from both branches.
+          do_collect_variables_for_each(staged, temp, altr.code_true);
+          do_collect_variables_for_each(staged, temp, altr.code_false);
+          return;
+        }
 
-                    // Set the mapped reference.
-                    mapped_ref.pop_modifier();
-                    Reference_Modifier::S_array_index xmod = { i };
-                    do_push_modifier_and_check(mapped_ref, move(xmod));
+      case index_defer_expression:
+        {
+          const auto& altr = this->m_stor.as<S_defer_expression>();
 
-                    // Execute the loop body.
-                    next_status = do_execute_block(sp.rod_body, ctx_for);
-                    if(::rocket::is_none_of(next_status, { air_status_next, air_status_continue_unspec,
-                                                           air_status_continue_for })) {
-                      if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_for }))
-                        status = next_status;
-                      break;
-                    }
-                  }
-                }
-                else if(range.is_object()) {
-                  const auto& obj = range.as_object();
-                  mapped_ref.push_modifier(Reference_Modifier::S_array_head());  // placeholder
-                  for(auto it = obj.begin();  it != obj.end();  ++it) {
-                    // Set the key variable which is the name of the mapped element
-                    // in the object.
-                    if(qkey_ref) {
-                      auto key_var = qkey_ref->unphase_variable_opt();
-                      if(!key_var) {
-                        key_var = ctx.global().garbage_collector()->create_variable();
-                        qkey_ref->set_variable(key_var);
-                      }
-                      key_var->initialize(it->first.rdstr());
-                      key_var->set_immutable();
-                    }
+          // Collect variables from the expression.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
 
-                    // Set the mapped reference.
-                    mapped_ref.pop_modifier();
-                    Reference_Modifier::S_object_key xmod = { it->first };
-                    do_push_modifier_and_check(mapped_ref, move(xmod));
+      case index_catch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_catch_expression>();
 
-                    // Execute the loop body.
-                    next_status = do_execute_block(sp.rod_body, ctx_for);
-                    if(::rocket::is_none_of(next_status, { air_status_next, air_status_continue_unspec,
-                                                           air_status_continue_for })) {
-                      if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_for }))
-                        status = next_status;
-                      break;
-                    }
-                  }
-                }
-                else if(!range.is_null())
-                  throw Runtime_Error(xtc_assert, sp.sloc_init,
-                            format_string("Range value not iterable (value `$1`)", range));
-              }
-              catch(Runtime_Error& except) {
-                ctx_for.on_scope_exit_exceptional(except);
-                throw;
-              }
-              ctx_for.on_scope_exit_normal(status);
-              return status;
-            }
+          // Collect variables from the expression.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
 
-            // Uparam
-            , Uparam()
+      case index_push_constant:
+        {
+          const auto& altr = this->m_stor.as<S_push_constant>();
 
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+          // Collect variables from the expression.
+          altr.val.collect_variables(staged, temp);
+          return;
+        }
 
-            // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.rod_init.collect_variables(staged, temp);
-              sp.rod_body.collect_variables(staged, temp);
-            }
+      case index_coalesce_expression:
+        {
+          const auto& altr = this->m_stor.as<S_coalesce_expression>();
 
-            // Symbols
-            , nullptr
-          );
+          // Collect variables from the null branch.
+          do_collect_variables_for_each(staged, temp, altr.code_null);
           return;
         }
 
-      case index_for_statement:
+      case index_inline_call:
         {
-          const auto& altr = this->m_stor.as<S_for_statement>();
-
-          struct Sparam
-            {
-              AVM_Rod rod_init;
-              AVM_Rod rod_cond;
-              AVM_Rod rod_step;
-              AVM_Rod rod_body;
-            };
+          const auto& altr = this->m_stor.as<S_inline_call>();
 
-          Sparam sp2;
-          do_solidify_nodes(sp2.rod_init, altr.code_init);
-          do_solidify_nodes(sp2.rod_cond, altr.code_cond);
-          do_solidify_nodes(sp2.rod_step, altr.code_step);
-          do_solidify_nodes(sp2.rod_body, altr.code_body);
+          // Collect variables from the body.
+          do_collect_variables_for_each(staged, temp, altr.code_body);
+          return;
+        }
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), this->m_stor.index());
+    }
+  }
 
-              // This is the same as the `for` statement in C. We have to create
-              // an outer context due to the fact that names declared in the first
-              // segment outlast every iteration.
-              Executive_Context ctx_for(xtc_plain, ctx);
-              AIR_Status status = air_status_next;
-              try {
-                // Execute the loop initializer, which shall only be a definition or
-                // an expression statement.
-                status = sp.rod_init.execute(ctx_for);
-                ROCKET_ASSERT(status == air_status_next);
-                for(;;) {
-                  // Check the condition. There is a special case: If the condition
-                  // is empty then the loop is infinite.
-                  AIR_Status next_status = sp.rod_cond.execute(ctx_for);
-                  ROCKET_ASSERT(next_status == air_status_next);
-                  if(!ctx_for.stack().empty() && !ctx_for.stack().top().dereference_readonly().test())
-                    break;
+void
+AIR_Node::
+solidify(AVM_Rod& rod) const
+  {
+    switch(static_cast<Index>(this->m_stor.index()))
+      {
+      case index_clear_stack:
+        {
+          const auto& altr = this->m_stor.as<S_clear_stack>();
 
-                  // Execute the body.
-                  next_status = do_execute_block(sp.rod_body, ctx_for);
-                  if(::rocket::is_none_of(next_status, { air_status_next, air_status_continue_unspec,
-                                                         air_status_continue_for })) {
-                    if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_for }))
-                      status = next_status;
-                    break;
-                  }
+          (void) altr;
 
-                  // Execute the increment.
-                  status = sp.rod_step.execute(ctx_for);
-                  ROCKET_ASSERT(status == air_status_next);
-                }
-              }
-              catch(Runtime_Error& except) {
-                ctx_for.on_scope_exit_exceptional(except);
-                throw;
-              }
-              ctx_for.on_scope_exit_normal(status);
-              return status;
+          rod.append(
+            +[](Executive_Context& ctx, const Header* /*head*/) -> AIR_Status
+            {
+              ctx.stack().clear();
+              return air_status_next;
             }
 
             // Uparam
             , Uparam()
 
             // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+            , 0, nullptr, nullptr, nullptr
 
             // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.rod_init.collect_variables(staged, temp);
-              sp.rod_cond.collect_variables(staged, temp);
-              sp.rod_step.collect_variables(staged, temp);
-              sp.rod_body.collect_variables(staged, temp);
-            }
+            , nullptr
 
             // Symbols
             , nullptr
@@ -2022,80 +2999,27 @@ solidify(AVM_Rod& rod) const
           return;
         }
 
-      case index_try_statement:
+      case index_execute_block:
         {
-          const auto& altr = this->m_stor.as<S_try_statement>();
+          const auto& altr = this->m_stor.as<S_execute_block>();
 
           struct Sparam
             {
-              AVM_Rod rod_try;
-              Source_Location sloc_catch;
-              phsh_string name_except;
-              AVM_Rod rod_catch;
+              AVM_Rod rod_body;
+              bool scoped_body;
             };
 
           Sparam sp2;
-          do_solidify_nodes(sp2.rod_try, altr.code_try);
-          sp2.sloc_catch = altr.sloc_catch;
-          sp2.name_except = altr.name_except;
-          do_solidify_nodes(sp2.rod_catch, altr.code_catch);
+          sp2.scoped_body = do_solidify_block(sp2.rod_body, altr.code_body);
 
           rod.append(
             +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
-              const auto& try_sloc = head->pv_meta->sloc;
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-              // This is almost identical to JavaScript but not to C++. Only one
-              // `catch` clause is allowed.
-              AIR_Status status;
-              try {
-                // Execute the `try` block. If no exception is thrown, this will
-                // have little overhead.
-                status = do_execute_block(sp.rod_try, ctx);
-                if(status == air_status_return_ref)
-                  ctx.stack().mut_top().check_function_result(ctx.global());
-                return status;
-              }
-              catch(Runtime_Error& except) {
-                // Append a frame due to exit of the `try` clause.
-                // Reuse the exception object. Don't bother allocating a new one.
-                except.push_frame_try(try_sloc);
-
-                // This branch must be executed inside this `catch` block.
-                // User-provided bindings may obtain the current exception using
-                // `::std::current_exception`.
-                Executive_Context ctx_catch(xtc_plain, ctx);
-                try {
-                  // Set the exception reference.
-                  auto& except_ref = ctx_catch.insert_named_reference(sp.name_except);
-                  except_ref.set_temporary(except.value());
-
-                  // Set backtrace frames.
-                  V_array backtrace;
-                  for(size_t k = 0;  k < except.count_frames();  ++k) {
-                    V_object r;
-                    r.try_emplace(&"frame", ::rocket::sref(describe_frame_type(except.frame(k).type)));
-                    r.try_emplace(&"file", except.frame(k).sloc.file());
-                    r.try_emplace(&"line", except.frame(k).sloc.line());
-                    r.try_emplace(&"column", except.frame(k).sloc.column());
-                    r.try_emplace(&"value", except.frame(k).value);
-                    backtrace.emplace_back(move(r));
-                  }
-                  auto& backtrace_ref = ctx_catch.insert_named_reference(&"__backtrace");
-                  backtrace_ref.set_temporary(move(backtrace));
-
-                  // Execute the `catch` clause.
-                  status = sp.rod_catch.execute(ctx_catch);
-                }
-                catch(Runtime_Error& nested) {
-                  ctx_catch.on_scope_exit_exceptional(nested);
-                  nested.push_frame_catch(sp.sloc_catch, except.value());
-                  throw;
-                }
-                ctx_catch.on_scope_exit_normal(status);
-                return status;
-              }
+              // Execute the block on a new context. The block may contain control
+              // statements, so the status shall be forwarded verbatim.
+              return do_execute_block(sp.rod_body, ctx, sp.scoped_body);
             }
 
             // Uparam
@@ -2108,46 +3032,56 @@ solidify(AVM_Rod& rod) const
             , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
             {
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.rod_try.collect_variables(staged, temp);
-              sp.rod_catch.collect_variables(staged, temp);
+              sp.rod_body.collect_variables(staged, temp);
             }
 
             // Symbols
-            , &(altr.sloc_try)
+            , nullptr
           );
           return;
         }
 
-      case index_throw_statement:
+      case index_declare_variable:
         {
-          const auto& altr = this->m_stor.as<S_throw_statement>();
+          const auto& altr = this->m_stor.as<S_declare_variable>();
+
+          Uparam up2;
+          up2.b0 = altr.foreign;
 
           struct Sparam
             {
-              Source_Location sloc;
+              phsh_string name;
             };
 
           Sparam sp2;
-          sp2.sloc = altr.sloc;
+          sp2.name = altr.name;
 
           rod.append(
             +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
+              const bool foreign = head->uparam.b0;
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              const auto& sloc = head->pv_meta->sloc;
 
-              // Read a value and throw it. The operand expression must not have
-              // been empty for this function.
-              auto& val = ctx.stack().mut_top().dereference_copy();
-              ctx.stack().pop();
+              // Allocate a variable and inject it into the current context. If
+              // it can't be part of a reference cycle, it is not tracked. This
+              // doesn't hold in a coroutine, as a suspended one keeps its locals.
+              const auto gcoll = ctx.global().garbage_collector();
+              const bool tracked = !foreign || ctx.global().get_coroutine_opt();
+              const auto var = tracked ? gcoll->create_variable() : gcoll->create_foreign_variable();
+              ctx.insert_named_reference(sp.name).set_variable(var);
 
               if(auto hooks = ctx.global().get_hooks_opt())
-                hooks->on_throw(sp.sloc, val);
+                hooks->on_declare(sloc, sp.name);
 
-              throw Runtime_Error(xtc_throw, val, sp.sloc);
+              // Push a copy of the reference onto the stack, which we will get
+              // back after the initializer finishes execution.
+              ctx.stack().push().set_variable(var);
+              return air_status_next;
             }
 
             // Uparam
-            , Uparam()
+            , up2
 
             // Sparam
             , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
@@ -2156,76 +3090,98 @@ solidify(AVM_Rod& rod) const
             , nullptr
 
             // Symbols
-            , nullptr
+            , &(altr.sloc)
           );
           return;
         }
 
-      case index_assert_statement:
+      case index_initialize_variable:
         {
-          const auto& altr = this->m_stor.as<S_assert_statement>();
-
-          struct Sparam
-            {
-              Source_Location sloc;
-              cow_string msg;
-            };
+          const auto& altr = this->m_stor.as<S_initialize_variable>();
 
-          Sparam sp2;
-          sp2.sloc = altr.sloc;
-          sp2.msg = altr.msg;
+          Uparam up2;
+          up2.b0 = altr.immutable;
 
           rod.append(
             +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              const bool immutable = head->uparam.b0;
 
-              // Throw an exception if the assertion fails. This cannot be disabled.
-              const auto& tval = ctx.stack().top().dereference_readonly();
+              // Read the value of the initializer. The initializer must not have
+              // been empty for this function.
+              const auto& val = ctx.stack().top().dereference_readonly();
               ctx.stack().pop();
 
-              if(ROCKET_EXPECT(tval.test()))
-                return air_status_next;
+              // Get the variable back.
+              auto var = ctx.stack().top().unphase_variable_opt();
+              ctx.stack().pop();
+              ROCKET_ASSERT(var && !var->is_initialized());
 
-              throw Runtime_Error(xtc_assert, sp.sloc, sp.msg);
+              // Initialize it with this value.
+              var->initialize(val);
+              var->set_immutable(immutable);
+              return air_status_next;
             }
 
             // Uparam
-            , Uparam()
+            , up2
 
             // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+            , 0, nullptr, nullptr, nullptr
 
             // Collector
             , nullptr
 
             // Symbols
-            , nullptr
+            , &(altr.sloc)
           );
           return;
         }
 
-      case index_simple_status:
+      case index_if_statement:
         {
-          const auto& altr = this->m_stor.as<S_simple_status>();
+          const auto& altr = this->m_stor.as<S_if_statement>();
 
           Uparam up2;
-          up2.u0 = altr.status;
+          up2.b0 = altr.negative;
+
+          struct Sparam
+            {
+              AVM_Rod rod_true;
+              AVM_Rod rod_false;
+              bool scoped_true;
+              bool scoped_false;
+            };
+
+          Sparam sp2;
+          sp2.scoped_true = do_solidify_block(sp2.rod_true, altr.code_true);
+          sp2.scoped_false = do_solidify_block(sp2.rod_false, altr.code_false);
 
           rod.append(
-            +[](Executive_Context& /*ctx*/, const Header* head) -> AIR_Status
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
-              return static_cast<AIR_Status>(head->uparam.u0);
+              const bool negative = head->uparam.b0;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+
+              // Read the condition and execute the corresponding branch as a block.
+              return (ctx.stack().top().dereference_readonly().test() != negative)
+                        ? do_execute_block(sp.rod_true, ctx, sp.scoped_true)
+                        : do_execute_block(sp.rod_false, ctx, sp.scoped_false);
             }
 
             // Uparam
             , up2
 
             // Sparam
-            , 0, nullptr, nullptr, nullptr
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
             // Collector
-            , nullptr
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              sp.rod_true.collect_variables(staged, temp);
+              sp.rod_false.collect_variables(staged, temp);
+            }
 
             // Symbols
             , nullptr
@@ -2233,132 +3189,226 @@ solidify(AVM_Rod& rod) const
           return;
         }
 
-      case index_check_argument:
+      case index_switch_statement:
         {
-          const auto& altr = this->m_stor.as<S_check_argument>();
+          const auto& altr = this->m_stor.as<S_switch_statement>();
 
-          Uparam up2;
-          up2.b0 = altr.by_ref;
+          struct Clause
+            {
+              AVM_Rod rod_label;
+              AVM_Rod rod_body;
+              cow_vector<phsh_string> names_added;
+            };
+
+          struct Sparam
+            {
+              cow_vector<Clause> clauses;
+            };
+
+          Sparam sp2;
+          for(const auto& clause : altr.clauses) {
+            auto& r = sp2.clauses.emplace_back();
+            do_solidify_nodes(r.rod_label, clause.code_label);
+            do_solidify_nodes(r.rod_body, clause.code_body);
+            r.names_added = clause.names_added;
+          }
 
           rod.append(
             +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
-              const bool by_ref = head->uparam.b0;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-              if(by_ref) {
-                // The argument is passed by reference, so check whether it is
-                // dereferenceable.
-                ctx.stack().top().dereference_readonly();
-                return air_status_next;
+              // Read the value of the condition and find the target clause for it.
+              auto cond = ctx.stack().top().dereference_readonly();
+              uint32_t target_index = UINT32_MAX;
+
+              // This is different from the `switch` statement in C, where `case` labels must
+              // have constant operands.
+              for(uint32_t i = 0;  i < sp.clauses.size();  ++i) {
+                // This is a `default` clause if the condition is empty, and a `case` clause
+                // otherwise.
+                if(sp.clauses.at(i).rod_label.empty()) {
+                  target_index = i;
+                  continue;
+                }
+
+                // Evaluate the operand and check whether it equals `cond`.
+                AIR_Status status = sp.clauses.at(i).rod_label.execute(ctx);
+                if(status != air_status_next)
+                  return status;
+
+                if(ctx.stack().top().dereference_readonly().compare_partial(cond) == compare_equal) {
+                  target_index = i;
+                  break;
+                }
               }
-              else {
-                // The argument is passed by copy, so convert it to a temporary.
-                ctx.stack().mut_top().dereference_copy();
+
+              // Skip this statement if no matching clause has been found.
+              if(target_index >= sp.clauses.size())
                 return air_status_next;
+
+              // Jump to the target clause.
+              Executive_Context ctx_body(xtc_plain, ctx);
+              AIR_Status status = air_status_next;
+              try {
+                for(size_t i = 0;  i < sp.clauses.size();  ++i)
+                  if(i < target_index) {
+                    // Inject bypassed names into the scope.
+                    for(const auto& name : sp.clauses.at(i).names_added)
+                      ctx_body.insert_named_reference(name);
+                  }
+                  else {
+                    // Execute the body of this clause.
+                    AIR_Status next_status = sp.clauses.at(i).rod_body.execute(ctx_body);
+                    if(next_status != air_status_next) {
+                      if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_switch }))
+                        status = next_status;
+                      break;
+                    }
+                  }
+              }
+              catch(Runtime_Error& except) {
+                ctx_body.on_scope_exit_exceptional(except);
+                throw;
               }
+              ctx_body.on_scope_exit_normal(status);
+              return status;
             }
 
             // Uparam
-            , up2
+            , Uparam()
 
             // Sparam
-            , 0, nullptr, nullptr, nullptr
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
             // Collector
-            , nullptr
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              for(const auto& r : sp.clauses) {
+                r.rod_label.collect_variables(staged, temp);
+                r.rod_body.collect_variables(staged, temp);
+              }
+            }
 
             // Symbols
-            , &(altr.sloc)
+            , nullptr
           );
           return;
         }
 
-      case index_push_global_reference:
+      case index_do_while_statement:
         {
-          const auto& altr = this->m_stor.as<S_push_global_reference>();
+          const auto& altr = this->m_stor.as<S_do_while_statement>();
+
+          Uparam up2;
+          up2.b0 = altr.negative;
 
           struct Sparam
             {
-              phsh_string name;
+              AVM_Rod rods_body;
+              bool scoped_body;
+              AVM_Rod rods_cond;
             };
 
           Sparam sp2;
-          sp2.name = altr.name;
+          sp2.scoped_body = do_solidify_block(sp2.rods_body, altr.code_body);
+          do_solidify_nodes(sp2.rods_cond, altr.code_cond);
 
           rod.append(
-            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
+              const bool negative = head->uparam.b0;
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-              // Look for the name in the global context.
-              auto qref = ctx.global().get_named_reference_opt(sp.name);
-              if(!qref)
-                throw Runtime_Error(xtc_format,
-                         "Undeclared identifier `$1`", sp.name);
+              // This is identical to C.
+              AIR_Status status = air_status_next;
+              for(;;) {
+                // Execute the body.
+                AIR_Status next_status = do_execute_block(sp.rods_body, ctx, sp.scoped_body);
+                if(::rocket::is_none_of(next_status, { air_status_next, air_status_continue_unspec,
+                                                       air_status_continue_while })) {
+                  if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_while }))
+                    status = next_status;
+                  break;
+                }
 
-              if(qref->is_invalid())
-                throw Runtime_Error(xtc_format,
-                         "Global reference `$1` not initialized", sp.name);
+                // Check the condition.
+                next_status = sp.rods_cond.execute(ctx);
+                if(next_status != air_status_next)
+                  return next_status;
 
-              // Push a copy of the reference onto the stack.
-              ctx.stack().push() = *qref;
-              return air_status_next;
+                if(ctx.stack().top().dereference_readonly().test() == negative)
+                  break;
+              }
+              return status;
             }
 
             // Uparam
-            , Uparam()
+            , up2
 
             // Sparam
             , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
             // Collector
-            , nullptr
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              sp.rods_body.collect_variables(staged, temp);
+              sp.rods_cond.collect_variables(staged, temp);
+            }
 
             // Symbols
-            , &(altr.sloc)
+            , nullptr
           );
           return;
         }
 
-      case index_push_local_reference:
+      case index_while_statement:
         {
-          const auto& altr = this->m_stor.as<S_push_local_reference>();
+          const auto& altr = this->m_stor.as<S_while_statement>();
 
           Uparam up2;
-          up2.u2345 = altr.depth;
+          up2.b0 = altr.negative;
 
           struct Sparam
             {
-              phsh_string name;
+              AVM_Rod rods_cond;
+              AVM_Rod rods_body;
+              bool scoped_body;
             };
 
           Sparam sp2;
-          sp2.name = altr.name;
+          do_solidify_nodes(sp2.rods_cond, altr.code_cond);
+          sp2.scoped_body = do_solidify_block(sp2.rods_body, altr.code_body);
 
           rod.append(
-            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
-              const uint32_t depth = head->uparam.u2345;
+              const bool negative = head->uparam.b0;
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-              // Locate the target context.
-              const Executive_Context* qctx = &ctx;
-              for(uint32_t k = 0;  k != depth;  ++k)
-                qctx = qctx->get_parent_opt();
-
-              // Look for the name in the target context.
-              auto qref = qctx->get_named_reference_opt(sp.name);
-              if(!qref)
-                throw Runtime_Error(xtc_format,
-                         "Undeclared identifier `$1`", sp.name);
+              // This is identical to C.
+              AIR_Status status = air_status_next;
+              for(;;) {
+                // Check the condition.
+                AIR_Status next_status = sp.rods_cond.execute(ctx);
+                if(next_status != air_status_next)
+                  return next_status;
 
-              if(qref->is_invalid())
-                throw Runtime_Error(xtc_format,
-                         "Initialization of `$1` was bypassed", sp.name);
+                if(ctx.stack().top().dereference_readonly().test() == negative)
+                  break;
 
-              // Push a copy of the reference onto the stack.
-              ctx.stack().push() = *qref;
-              return air_status_next;
+                // Execute the body.
+                next_status = do_execute_block(sp.rods_body, ctx, sp.scoped_body);
+                if(::rocket::is_none_of(next_status, { air_status_next, air_status_continue_unspec,
+                                                       air_status_continue_while })) {
+                  if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_while }))
+                    status = next_status;
+                  break;
+                }
+              }
+              return status;
             }
 
             // Uparam
@@ -2368,34 +3418,139 @@ solidify(AVM_Rod& rod) const
             , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
             // Collector
-            , nullptr
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              sp.rods_cond.collect_variables(staged, temp);
+              sp.rods_body.collect_variables(staged, temp);
+            }
 
             // Symbols
-            , &(altr.sloc)
+            , nullptr
           );
           return;
         }
 
-      case index_push_bound_reference:
+      case index_for_each_statement:
         {
-          const auto& altr = this->m_stor.as<S_push_bound_reference>();
+          const auto& altr = this->m_stor.as<S_for_each_statement>();
 
           struct Sparam
             {
-              Reference ref;
+              phsh_string name_key;
+              phsh_string name_mapped;
+              Source_Location sloc_init;
+              AVM_Rod rod_init;
+              AVM_Rod rod_body;
+              bool scoped_body;
             };
 
           Sparam sp2;
-          sp2.ref = altr.ref;
+          sp2.name_key = altr.name_key;
+          sp2.name_mapped = altr.name_mapped;
+          sp2.sloc_init = altr.sloc_init;
+          do_solidify_nodes(sp2.rod_init, altr.code_init);
+          sp2.scoped_body = do_solidify_block(sp2.rod_body, altr.code_body);
 
           rod.append(
-            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-              // Push a copy of the captured reference.
-              ctx.stack().push() = sp.ref;
-              return air_status_next;
+              // We have to create an outer context due to the fact that the key
+              // and mapped references outlast every iteration.
+              Executive_Context ctx_for(xtc_plain, ctx);
+              AIR_Status status = air_status_next;
+              try {
+                // Create key and mapped references.
+                Reference* qkey_ref = nullptr;
+                if(!sp.name_key.empty())
+                  qkey_ref = &(ctx_for.insert_named_reference(sp.name_key));
+                auto& mapped_ref = ctx_for.insert_named_reference(sp.name_mapped);
+
+                // Evaluate the range initializer and set the range up, which isn't
+                // going to change for all loops.
+                AIR_Status next_status = sp.rod_init.execute(ctx_for);
+                if(next_status != air_status_next) {
+                  ctx_for.on_scope_exit_normal(next_status);
+                  return next_status;
+                }
+
+                mapped_ref = move(ctx_for.stack().mut_top());
+
+                const auto range = mapped_ref.dereference_readonly();
+                if(range.is_array()) {
+                  const auto& arr = range.as_array();
+                  mapped_ref.push_modifier(Reference_Modifier::S_array_head());  // placeholder
+                  for(int64_t i = 0;  i < arr.ssize();  ++i) {
+                    // Set the key variable which is the subscript of the mapped
+                    // element in the array.
+                    if(qkey_ref) {
+                      auto key_var = qkey_ref->unphase_variable_opt();
+                      if(!key_var) {
+                        key_var = ctx.global().garbage_collector()->create_variable();
+                        qkey_ref->set_variable(key_var);
+                      }
+                      key_var->initialize(i);
+                      key_var->set_immutable();
+                    }
+
+                    // Set the mapped reference.
+                    mapped_ref.pop_modifier();
+                    Reference_Modifier::S_array_index xmod = { i };
+                    do_push_modifier_and_check(mapped_ref, move(xmod));
+
+                    // Execute the loop body.
+                    next_status = do_execute_block(sp.rod_body, ctx_for, sp.scoped_body);
+                    if(::rocket::is_none_of(next_status, { air_status_next, air_status_continue_unspec,
+                                                           air_status_continue_for })) {
+                      if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_for }))
+                        status = next_status;
+                      break;
+                    }
+                  }
+                }
+                else if(range.is_object()) {
+                  const auto& obj = range.as_object();
+                  mapped_ref.push_modifier(Reference_Modifier::S_array_head());  // placeholder
+                  for(auto it = obj.begin();  it != obj.end();  ++it) {
+                    // Set the key variable which is the name of the mapped element
+                    // in the object.
+                    if(qkey_ref) {
+                      auto key_var = qkey_ref->unphase_variable_opt();
+                      if(!key_var) {
+                        key_var = ctx.global().garbage_collector()->create_variable();
+                        qkey_ref->set_variable(key_var);
+                      }
+                      key_var->initialize(it->first.rdstr());
+                      key_var->set_immutable();
+                    }
+
+                    // Set the mapped reference.
+                    mapped_ref.pop_modifier();
+                    Reference_Modifier::S_object_key xmod = { it->first };
+                    do_push_modifier_and_check(mapped_ref, move(xmod));
+
+                    // Execute the loop body.
+                    next_status = do_execute_block(sp.rod_body, ctx_for, sp.scoped_body);
+                    if(::rocket::is_none_of(next_status, { air_status_next, air_status_continue_unspec,
+                                                           air_status_continue_for })) {
+                      if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_for }))
+                        status = next_status;
+                      break;
+                    }
+                  }
+                }
+                else if(!range.is_null())
+                  throw Runtime_Error(xtc_assert, sp.sloc_init,
+                            format_string("Range value not iterable (value `$1`)", range));
+              }
+              catch(Runtime_Error& except) {
+                ctx_for.on_scope_exit_exceptional(except);
+                throw;
+              }
+              ctx_for.on_scope_exit_normal(status);
+              return status;
             }
 
             // Uparam
@@ -2408,7 +3563,8 @@ solidify(AVM_Rod& rod) const
             , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
             {
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.ref.collect_variables(staged, temp);
+              sp.rod_init.collect_variables(staged, temp);
+              sp.rod_body.collect_variables(staged, temp);
             }
 
             // Symbols
@@ -2417,37 +3573,70 @@ solidify(AVM_Rod& rod) const
           return;
         }
 
-      case index_define_function:
+      case index_for_statement:
         {
-          const auto& altr = this->m_stor.as<S_define_function>();
+          const auto& altr = this->m_stor.as<S_for_statement>();
 
           struct Sparam
             {
-              Compiler_Options opts;
-              cow_string func;
-              cow_vector<phsh_string> params;
-              cow_vector<AIR_Node> code_body;
+              AVM_Rod rod_init;
+              AVM_Rod rod_cond;
+              AVM_Rod rod_step;
+              AVM_Rod rod_body;
+              bool scoped_body;
             };
 
           Sparam sp2;
-          sp2.opts = altr.opts;
-          sp2.func = altr.func;
-          sp2.params = altr.params;
-          sp2.code_body = altr.code_body;
+          do_solidify_nodes(sp2.rod_init, altr.code_init);
+          do_solidify_nodes(sp2.rod_cond, altr.code_cond);
+          do_solidify_nodes(sp2.rod_step, altr.code_step);
+          sp2.scoped_body = do_solidify_block(sp2.rod_body, altr.code_body);
 
           rod.append(
             +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              const auto& sloc = head->pv_meta->sloc;
 
-              // Instantiate the function.
-              AIR_Optimizer optmz(sp.opts);
-              optmz.rebind(&ctx, sp.params, sp.code_body);
+              // This is the same as the `for` statement in C. We have to create
+              // an outer context due to the fact that names declared in the first
+              // segment outlast every iteration.
+              Executive_Context ctx_for(xtc_plain, ctx);
+              AIR_Status status = air_status_next;
+              try {
+                // Execute the loop initializer, which shall only be a definition or
+                // an expression statement.
+                status = sp.rod_init.execute(ctx_for);
+                while(status == air_status_next) {
+                  // Check the condition. There is a special case: If the condition
+                  // is empty then the loop is infinite.
+                  AIR_Status next_status = sp.rod_cond.execute(ctx_for);
+                  if(next_status != air_status_next) {
+                    status = next_status;
+                    break;
+                  }
+
+                  if(!ctx_for.stack().empty() && !ctx_for.stack().top().dereference_readonly().test())
+                    break;
 
-              // Push the function as a temporary value.
-              ctx.stack().push().set_temporary(optmz.create_function(sloc, sp.func));
-              return air_status_next;
+                  // Execute the body.
+                  next_status = do_execute_block(sp.rod_body, ctx_for, sp.scoped_body);
+                  if(::rocket::is_none_of(next_status, { air_status_next, air_status_continue_unspec,
+                                                         air_status_continue_for })) {
+                    if(::rocket::is_none_of(next_status, { air_status_break_unspec, air_status_break_for }))
+                      status = next_status;
+                    break;
+                  }
+
+                  // Execute the increment.
+                  status = sp.rod_step.execute(ctx_for);
+                }
+              }
+              catch(Runtime_Error& except) {
+                ctx_for.on_scope_exit_exceptional(except);
+                throw;
+              }
+              ctx_for.on_scope_exit_normal(status);
+              return status;
             }
 
             // Uparam
@@ -2460,184 +3649,127 @@ solidify(AVM_Rod& rod) const
             , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
             {
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              do_collect_variables_for_each(staged, temp, sp.code_body);
+              sp.rod_init.collect_variables(staged, temp);
+              sp.rod_cond.collect_variables(staged, temp);
+              sp.rod_step.collect_variables(staged, temp);
+              sp.rod_body.collect_variables(staged, temp);
             }
 
             // Symbols
-            , &(altr.sloc)
+            , nullptr
           );
           return;
         }
 
-      case index_branch_expression:
+      case index_try_statement:
         {
-          const auto& altr = this->m_stor.as<S_branch_expression>();
-
-          Uparam up2;
-          up2.b0 = altr.assign;
+          const auto& altr = this->m_stor.as<S_try_statement>();
 
           struct Sparam
             {
-              AVM_Rod rod_true;
-              AVM_Rod rod_false;
+              AVM_Rod rod_try;
+              Source_Location sloc_catch;
+              phsh_string name_except;
+              AVM_Rod rod_catch;
             };
 
           Sparam sp2;
-          do_solidify_nodes(sp2.rod_true, altr.code_true);
-          do_solidify_nodes(sp2.rod_false, altr.code_false);
+          do_solidify_nodes(sp2.rod_try, altr.code_try);
+          sp2.sloc_catch = altr.sloc_catch;
+          sp2.name_except = altr.name_except;
+          do_solidify_nodes(sp2.rod_catch, altr.code_catch);
 
           rod.append(
             +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
-              const bool assign = head->uparam.b0;
-              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-
-              // Read the condition and evaluate the corresponding subexpression.
-              return ctx.stack().top().dereference_readonly().test()
-                       ? do_evaluate_subexpression(ctx, assign, sp.rod_true)
-                       : do_evaluate_subexpression(ctx, assign, sp.rod_false);
-            }
-
-            // Uparam
-            , up2
-
-            // Sparam
-            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
-
-            // Collector
-            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
-            {
+              const auto& try_sloc = head->pv_meta->sloc;
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
-              sp.rod_true.collect_variables(staged, temp);
-              sp.rod_false.collect_variables(staged, temp);
-            }
-
-            // Symbols
-            , &(altr.sloc)
-          );
-          return;
-        }
-
-      case index_function_call:
-        {
-          const auto& altr = this->m_stor.as<S_function_call>();
-
-          Uparam up2;
-          up2.u0 = altr.ptc;
-          up2.u2345 = altr.nargs;
 
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
-            {
-              const PTC_Aware ptc = static_cast<PTC_Aware>(head->uparam.u0);
-              const uint32_t nargs = head->uparam.u2345;
-              const auto& sloc = head->pv_meta->sloc;
-              const auto sentry = ctx.global().copy_recursion_sentry();
+              // This is almost identical to JavaScript but not to C++. Only one
+              // `catch` clause is allowed.
+              AIR_Status status;
+              try {
+                // Execute the `try` block. If no exception is thrown, this will
+                // have little overhead.
+                status = do_execute_block(sp.rod_try, ctx);
+                if(status == air_status_return_ref)
+                  ctx.stack().mut_top().check_function_result(ctx.global());
+              }
+              catch(Runtime_Error& except) {
+                // Append a frame due to exit of the `try` clause.
+                // Reuse the exception object. Don't bother allocating a new one.
+                except.push_frame_try(try_sloc);
 
-              if(auto hooks = ctx.global().get_hooks_opt())
-                hooks->on_trap(sloc, ctx);
+                // This branch must be executed inside this `catch` block.
+                // User-provided bindings may obtain the current exception using
+                // `::std::current_exception`.
+                return do_execute_catch(ctx, sp.sloc_catch, sp.name_except, sp.rod_catch, except);
+              }
 
-              // Collect arguments from left to right.
-              ctx.alt_stack().clear();
-              for(uint32_t k = 0;  k != nargs;  ++k)
-                ctx.alt_stack().push() = move(ctx.stack().mut_top(nargs - 1 - k));
-              ctx.stack().pop(nargs);
+              if(ROCKET_EXPECT(status != air_status_throw))
+                return status;
 
-              // Copy the target reference into the red zone, as we probably don't
-              // want to introduce a temporary object on the system stack.
-              ctx.stack().clear_red_zone();
-              ctx.stack().push();
-              ctx.stack().mut_top() = ctx.stack().top(1);
-              const auto& target = ctx.stack().top().dereference_readonly();
-              ctx.stack().pop();
-              ctx.stack().mut_top().pop_modifier();
-              return do_invoke_partial(ctx.stack().mut_top(), ctx, sloc, ptc, target);
+              // An exception from a `throw` statement has been propagated as a
+              // status code. Take it out and handle it the same way.
+              auto except = ctx.global().take_pending_exception();
+              except.push_frame_try(try_sloc);
+              return do_execute_catch(ctx, sp.sloc_catch, sp.name_except, sp.rod_catch, except);
             }
 
             // Uparam
-            , up2
+            , Uparam()
 
             // Sparam
-            , 0, nullptr, nullptr, nullptr
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
             // Collector
-            , nullptr
-
-            // Symbols
-            , &(altr.sloc)
-          );
-          return;
-        }
-
-      case index_push_unnamed_array:
-        {
-          const auto& altr = this->m_stor.as<S_push_unnamed_array>();
-
-          Uparam up2;
-          up2.u2345 = altr.nelems;
-
-          rod.append(
-            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
             {
-              const uint32_t nelems = head->uparam.u2345;
-
-              // Pop elements from the stack and fill them from right to left.
-              V_array arr;
-              arr.resize(nelems);
-              for(auto it = arr.mut_rbegin();  it != arr.rend();  ++it) {
-                *it = ctx.stack().top().dereference_readonly();
-                ctx.stack().pop();
-              }
-
-              // Push the array as a temporary.
-              ctx.stack().push().set_temporary(move(arr));
-              return air_status_next;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              sp.rod_try.collect_variables(staged, temp);
+              sp.rod_catch.collect_variables(staged, temp);
             }
 
-            // Uparam
-            , up2
-
-            // Sparam
-            , 0, nullptr, nullptr, nullptr
-
-            // Collector
-            , nullptr
-
             // Symbols
-            , &(altr.sloc)
+            , &(altr.sloc_try)
           );
           return;
         }
 
-      case index_push_unnamed_object:
+      case index_throw_statement:
         {
-          const auto& altr = this->m_stor.as<S_push_unnamed_object>();
+          const auto& altr = this->m_stor.as<S_throw_statement>();
 
           struct Sparam
             {
-              cow_vector<phsh_string> keys;
+              Source_Location sloc;
             };
 
           Sparam sp2;
-          sp2.keys = altr.keys;
+          sp2.sloc = altr.sloc;
 
           rod.append(
             +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-              // Pop elements from the stack and set them from right to left. In case
-              // of duplicate keys, the rightmost value takes precedence.
-              V_object obj;
-              obj.reserve(sp.keys.size());
-              for(auto it = sp.keys.rbegin();  it != sp.keys.rend();  ++it) {
-                obj.try_emplace(*it, ctx.stack().top().dereference_readonly());
-                ctx.stack().pop();
-              }
+              // Read a value and throw it. The operand expression must not have
+              // been empty for this function.
+              auto& val = ctx.stack().mut_top().dereference_copy();
+              ctx.stack().pop();
 
-              // Push the object as a temporary.
-              ctx.stack().push().set_temporary(move(obj));
-              return air_status_next;
+              if(auto hooks = ctx.global().get_hooks_opt())
+                hooks->on_throw(sp.sloc, val);
+
+              // The exception is propagated as a status code, which is much
+              // cheaper than a C++ exception. It is converted to a C++ exception
+              // only when it leaves a function whose caller can't handle it.
+              auto& global = ctx.global();
+              if(auto handled = global.get_handled_exception_opt())
+                global.set_pending_exception(Runtime_Error(xtc_throw, val, sp.sloc, *handled));
+              else
+                global.set_pending_exception(Runtime_Error(xtc_throw, val, sp.sloc));
+              return air_status_throw;
             }
 
             // Uparam
@@ -2650,1049 +3782,839 @@ solidify(AVM_Rod& rod) const
             , nullptr
 
             // Symbols
-            , &(altr.sloc)
+            , nullptr
           );
           return;
         }
 
-      case index_apply_operator:
+      case index_assert_statement:
         {
-          const auto& altr = this->m_stor.as<S_apply_operator>();
-
-          Uparam up2;
-          up2.b0 = altr.assign;
-          up2.u1 = altr.xop;
+          const auto& altr = this->m_stor.as<S_assert_statement>();
 
-          switch(altr.xop)
+          struct Sparam
             {
-            case xop_inc:
-            case xop_dec:
-            case xop_unset:
-            case xop_head:
-            case xop_tail:
-            case xop_random:
-            case xop_isvoid:
-              // unary
-              rod.append(
-                +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
-                {
-                  const bool assign = head->uparam.b0;
-                  const uint8_t uxop = head->uparam.u1;
-                  auto& top = ctx.stack().mut_top();
-
-                  switch(uxop)
-                      {
-                    case xop_inc:
-                      {
-                        // `assign` is `true` for the postfix variant and `false` for
-                        // the prefix variant.
-                        auto& rhs = top.dereference_mutable();
-
-                        if(rhs.type() == type_integer) {
-                          V_integer& val = rhs.mut_integer();
-
-                          // Increment the value with overflow checking.
-                          int64_t result;
-                          if(ROCKET_ADD_OVERFLOW(val, 1, &result))
-                            throw Runtime_Error(xtc_format,
-                                     "Integer increment overflow (operand was `$1`)", val);
-
-                          if(assign)
-                            top.set_temporary(val);
-
-                          val = result;
-                          return air_status_next;
-                        }
-
-                        if(rhs.type() == type_real) {
-                          V_real& val = rhs.mut_real();
-
-                          // Overflow will result in an infinity, so this is safe.
-                          double result = val + 1;
-
-                          if(assign)
-                            top.set_temporary(val);
+              Source_Location sloc;
+              cow_string msg;
+            };
 
-                          val = result;
-                          return air_status_next;
-                        }
+          Sparam sp2;
+          sp2.sloc = altr.sloc;
+          sp2.msg = altr.msg;
 
-                        throw Runtime_Error(xtc_format,
-                                 "Increment not applicable (operand was `$1`)", rhs);
-                      }
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-                    case xop_dec:
-                      {
-                        // `assign` is `true` for the postfix variant and `false` for
-                        // the prefix variant.
-                        auto& rhs = top.dereference_mutable();
+              // Throw an exception if the assertion fails. This cannot be disabled.
+              const auto& tval = ctx.stack().top().dereference_readonly();
+              ctx.stack().pop();
 
-                        if(rhs.type() == type_integer) {
-                          V_integer& val = rhs.mut_integer();
+              if(ROCKET_EXPECT(tval.test()))
+                return air_status_next;
 
-                          // Decrement the value with overflow checking.
-                          int64_t result;
-                          if(ROCKET_SUB_OVERFLOW(val, 1, &result))
-                            throw Runtime_Error(xtc_format,
-                                     "Integer decrement overflow (operand was `$1`)", val);
+              throw Runtime_Error(xtc_assert, sp.sloc, sp.msg);
+            }
 
-                          if(assign)
-                            top.set_temporary(val);
+            // Uparam
+            , Uparam()
 
-                          val = result;
-                          return air_status_next;
-                        }
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-                        if(rhs.type() == type_real) {
-                          V_real& val = rhs.mut_real();
+            // Collector
+            , nullptr
 
-                          // Overflow will result in an infinity, so this is safe.
-                          double result = val - 1;
+            // Symbols
+            , nullptr
+          );
+          return;
+        }
 
-                          if(assign)
-                            top.set_temporary(val);
+      case index_simple_status:
+        {
+          const auto& altr = this->m_stor.as<S_simple_status>();
 
-                          val = result;
-                          return air_status_next;
-                        }
+          Uparam up2;
+          up2.u0 = altr.status;
 
-                        throw Runtime_Error(xtc_format,
-                                 "Decrement not applicable (operand was `$1`)", rhs);
-                      }
+          rod.append(
+            +[](Executive_Context& /*ctx*/, const Header* head) -> AIR_Status
+            {
+              return static_cast<AIR_Status>(head->uparam.u0);
+            }
 
-                    case xop_unset:
-                      {
-                        // Unset the last element and return it as a temporary.
-                        // `assign` is ignored.
-                        auto val = top.dereference_unset();
-                        top.set_temporary(move(val));
-                        return air_status_next;
-                      }
+            // Uparam
+            , up2
 
-                    case xop_head:
-                      {
-                        // Push an array head modifier. `assign` is ignored.
-                        Reference_Modifier::S_array_head xmod = { };
-                        do_push_modifier_and_check(top, move(xmod));
-                        return air_status_next;
-                      }
+            // Sparam
+            , 0, nullptr, nullptr, nullptr
 
-                    case xop_tail:
-                      {
-                        // Push an array tail modifier. `assign` is ignored.
-                        Reference_Modifier::S_array_tail xmod = { };
-                        do_push_modifier_and_check(top, move(xmod));
-                        return air_status_next;
-                      }
+            // Collector
+            , nullptr
 
-                    case xop_random:
-                      {
-                        // Push a random subscript.
-                        uint32_t seed = ctx.global().random_engine()->bump();
-                        Reference_Modifier::S_array_random xmod = { seed };
-                        do_push_modifier_and_check(top, move(xmod));
-                        return air_status_next;
-                      }
+            // Symbols
+            , nullptr
+          );
+          return;
+        }
 
-                    case xop_isvoid:
-                      {
-                        // Check whether the argument is a void reference and save
-                        // the result as a temporary boolean.
-                        // `assign` is ignored.
-                        bool val = top.is_void();
-                        top.set_temporary(val);
-                        return air_status_next;
-                      }
+      case index_check_argument:
+        {
+          const auto& altr = this->m_stor.as<S_check_argument>();
 
-                    default:
-                      ROCKET_UNREACHABLE();
-                  }
-                }
+          Uparam up2;
+          up2.b0 = altr.by_ref;
 
-                // Uparam
-                , up2
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const bool by_ref = head->uparam.b0;
 
-                // Sparam
-                , 0, nullptr, nullptr, nullptr
+              if(by_ref) {
+                // The argument is passed by reference, so check whether it is
+                // dereferenceable.
+                ctx.stack().top().dereference_readonly();
+                return air_status_next;
+              }
+              else {
+                // The argument is passed by copy, so convert it to a temporary.
+                ctx.stack().mut_top().dereference_copy();
+                return air_status_next;
+              }
+            }
 
-                // Collector
-                , nullptr
+            // Uparam
+            , up2
 
-                // Symbols
-                , &(altr.sloc)
-              );
-              return;
+            // Sparam
+            , 0, nullptr, nullptr, nullptr
 
-            case xop_assign:
-            case xop_index:
-              // binary
-              rod.append(
-                +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-                {
-                  const uint8_t uxop = head->uparam.u1;
-                  auto& rhs = ctx.stack().mut_top().dereference_copy();
-                  ctx.stack().pop();
-                  auto& top = ctx.stack().mut_top();
+            // Collector
+            , nullptr
 
-                  switch(uxop)
-                      {
-                    case xop_assign:
-                      {
-                        // `assign` is ignored.
-                        top.dereference_mutable() = move(rhs);
-                        return air_status_next;
-                      }
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                    case xop_index:
-                      {
-                        // Push a subscript.
-                        if(rhs.type() == type_integer) {
-                          Reference_Modifier::S_array_index xmod = { rhs.as_integer() };
-                          do_push_modifier_and_check(top, move(xmod));
-                          return air_status_next;
-                        }
-                        else if(rhs.type() == type_string) {
-                          Reference_Modifier::S_object_key xmod = { rhs.as_string() };
-                          do_push_modifier_and_check(top, move(xmod));
-                          return air_status_next;
-                        }
-                        else
-                          throw Runtime_Error(xtc_format,
-                                   "Subscript value not valid (operand was `$1`)", rhs);
-                      }
+      case index_push_global_reference:
+        {
+          const auto& altr = this->m_stor.as<S_push_global_reference>();
 
-                    default:
-                      ROCKET_UNREACHABLE();
-                  }
-                }
+          struct Sparam
+            {
+              phsh_string name;
+            };
 
-                // Uparam
-                , up2
+          Sparam sp2;
+          sp2.name = altr.name;
 
-                // Sparam
-                , 0, nullptr, nullptr, nullptr
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-                // Collector
-                , nullptr
+              // Look for the name in the global context.
+              auto qref = ctx.global().get_named_reference_opt(sp.name);
+              if(!qref)
+                throw Runtime_Error(xtc_format,
+                         "Undeclared identifier `$1`", sp.name);
 
-                // Symbols
-                , &(altr.sloc)
-              );
-              return;
+              if(qref->is_invalid())
+                throw Runtime_Error(xtc_format,
+                         "Global reference `$1` not initialized", sp.name);
 
-            case xop_pos:
-            case xop_neg:
-            case xop_notb:
-            case xop_notl:
-            case xop_countof:
-            case xop_typeof:
-            case xop_sqrt:
-            case xop_isnan:
-            case xop_isinf:
-            case xop_abs:
-            case xop_sign:
-            case xop_round:
-            case xop_floor:
-            case xop_ceil:
-            case xop_trunc:
-            case xop_iround:
-            case xop_ifloor:
-            case xop_iceil:
-            case xop_itrunc:
-            case xop_lzcnt:
-            case xop_tzcnt:
-            case xop_popcnt:
-              // unary
-              rod.append(
-                +[](Executive_Context& ctx, const Header* head) -> AIR_Status
-                {
-                  const bool assign = head->uparam.b0;
-                  const uint8_t uxop = head->uparam.u1;
-                  auto& top = ctx.stack().mut_top();
-                  auto& rhs = assign ? top.dereference_mutable() : top.dereference_copy();
+              // Push a copy of the reference onto the stack.
+              ctx.stack().push() = *qref;
+              return air_status_next;
+            }
 
-                  switch(uxop)
-                      {
-                    case xop_pos:
-                      {
-                        // This operator does nothing.
-                        return air_status_next;
-                      }
+            // Uparam
+            , Uparam()
 
-                    case xop_neg:
-                      {
-                        // Get the additive inverse of the operand.
-                        if(rhs.type() == type_integer) {
-                          V_integer& val = rhs.mut_integer();
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-                          int64_t result;
-                          if(ROCKET_SUB_OVERFLOW(0, val, &result))
-                            throw Runtime_Error(xtc_format,
-                                     "Integer negation overflow (operand was `$1`)", val);
+            // Collector
+            , nullptr
 
-                          val = result;
-                          return air_status_next;
-                        }
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                        if(rhs.type() == type_real) {
-                          V_real& val = rhs.mut_real();
+      case index_push_local_reference:
+        {
+          const auto& altr = this->m_stor.as<S_push_local_reference>();
 
-                          int64_t bits;
-                          bcopy(bits, val);
-                          bits ^= INT64_MIN;
+          Uparam up2;
+          up2.u2345 = altr.depth;
 
-                          bcopy(val, bits);
-                          return air_status_next;
-                        }
+          struct Sparam
+            {
+              phsh_string name;
+            };
 
-                        throw Runtime_Error(xtc_format,
-                                 "Arithmetic negation not applicable (operand was `$1`)", rhs);
-                      }
+          Sparam sp2;
+          sp2.name = altr.name;
 
-                    case xop_notb:
-                      {
-                        // Flip all bits (of all bytes) in the operand.
-                        if(rhs.type() == type_boolean) {
-                          V_boolean& val = rhs.mut_boolean();
-                          val = !val;
-                          return air_status_next;
-                        }
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+            {
+              const uint32_t depth = head->uparam.u2345;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-                        if(rhs.type() == type_integer) {
-                          V_integer& val = rhs.mut_integer();
-                          val = ~val;
-                          return air_status_next;
-                        }
+              // Push a copy of the reference onto the stack.
+              ctx.stack().push() = do_get_local_reference(ctx, depth, sp.name);
+              return air_status_next;
+            }
 
-                        if(rhs.type() == type_string) {
-                          V_string& val = rhs.mut_string();
-                          for(auto it = val.mut_begin();  it != val.end();  ++it)
-                            *it = static_cast<char>(*it ^ -1);
-                          return air_status_next;
-                        }
+            // Uparam
+            , up2
 
-                        throw Runtime_Error(xtc_format,
-                                 "Bitwise NOT not applicable (operand was `$1`)", rhs);
-                      }
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-                    case xop_notl:
-                      {
-                        // Perform the builtin boolean conversion and negate the result.
-                        rhs = !rhs.test();
-                        return air_status_next;
-                      }
+            // Collector
+            , nullptr
 
-                    case xop_countof:
-                      {
-                        // Get the number of elements in the operand.
-                        if(rhs.type() == type_null) {
-                          rhs = V_integer(0);
-                          return air_status_next;
-                        }
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                        if(rhs.type() == type_string) {
-                          rhs = V_integer(rhs.as_string().size());
-                          return air_status_next;
-                        }
+      case index_push_bound_reference:
+        {
+          const auto& altr = this->m_stor.as<S_push_bound_reference>();
 
-                        if(rhs.type() == type_array) {
-                          rhs = V_integer(rhs.as_array().size());
-                          return air_status_next;
-                        }
+          struct Sparam
+            {
+              Reference ref;
+            };
 
-                        if(rhs.type() == type_object) {
-                          rhs = V_integer(rhs.as_object().size());
-                          return air_status_next;
-                        }
+          Sparam sp2;
+          sp2.ref = altr.ref;
 
-                        throw Runtime_Error(xtc_format,
-                                 "`countof` not applicable (operand was `$1`)", rhs);
-                      }
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-                    case xop_typeof:
-                      {
-                        // Ge the type of the operand as a string.
-                        rhs = ::rocket::sref(describe_type(rhs.type()));
-                        return air_status_next;
-                      }
+              // Push a copy of the captured reference.
+              ctx.stack().push() = sp.ref;
+              return air_status_next;
+            }
 
-                    case xop_sqrt:
-                      {
-                        // Get the arithmetic square root of the operand, as a real number.
-                        if(rhs.is_real()) {
-                          rhs = ::std::sqrt(rhs.as_real());
-                          return air_status_next;
-                        }
+            // Uparam
+            , Uparam()
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__sqrt` not applicable (operand was `$1`)", rhs);
-                      }
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-                    case xop_isnan:
-                      {
-                        // Checks whether the operand is a NaN. The operand must be of an
-                        // arithmetic type. An integer is never a NaN.
-                        if(rhs.type() == type_integer) {
-                          rhs = false;
-                          return air_status_next;
-                        }
+            // Collector
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              sp.ref.collect_variables(staged, temp);
+            }
 
-                        if(rhs.type() == type_real) {
-                          rhs = ::std::isnan(rhs.as_real());
-                          return air_status_next;
-                        }
+            // Symbols
+            , nullptr
+          );
+          return;
+        }
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__isnan` not applicable (operand was `$1`)", rhs);
-                      }
+      case index_define_function:
+        {
+          const auto& altr = this->m_stor.as<S_define_function>();
 
-                    case xop_isinf:
-                      {
-                        // Checks whether the operand is an infinity. The operand must be of
-                        // an arithmetic type. An integer is never an infinity.
-                        if(rhs.type() == type_integer) {
-                          rhs = false;
-                          return air_status_next;
-                        }
+          struct Sparam
+            {
+              refcnt_ptr<const Instantiated_Function::Template> templ;
+              cow_vector<Closure_Capture> captures;
+            };
 
-                        if(rhs.type() == type_real) {
-                          rhs = ::std::isinf(rhs.as_real());
-                          return air_status_next;
-                        }
+          // Replace references to the defining context with captured ones, so
+          // the body can be solidified once and shared by all instances.
+          Sparam sp2;
+          auto code_body = altr.code_body;
+          do_capture_nodes(sp2.captures, code_body);
+          if(!altr.lazy_tokens.empty()) {
+            // Keep the definition, so the body can be compiled later.
+            auto lazy = altr;
+            lazy.code_body = move(code_body);
+            sp2.templ = ::rocket::make_refcnt<Instantiated_Function::Template>(lazy);
+          }
+          else
+            sp2.templ = ::rocket::make_refcnt<Instantiated_Function::Template>(altr.sloc, altr.func,
+                                                                              altr.params, code_body);
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__isinf` not applicable (operand was `$1`)", rhs);
-                      }
+          Uparam up2;
+          up2.b0 = !altr.lazy_tokens.empty();
 
-                    case xop_abs:
-                      {
-                        // Get the absolute value of the operand.
-                        if(rhs.type() == type_integer) {
-                          V_integer& val = rhs.mut_integer();
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const bool lazy = head->uparam.b0;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-                          V_integer neg_val;
-                          if(ROCKET_SUB_OVERFLOW(0, val, &neg_val))
-                            throw Runtime_Error(xtc_format,
-                                     "Integer negation overflow (operand was `$1`)", val);
+              // Capture references from the current context.
+              cow_vector<Reference> captures;
+              captures.reserve(sp.captures.size());
+              for(const auto& cap : sp.captures)
+                captures.emplace_back(do_get_closure_capture(ctx, cap, lazy));
 
-                          val ^= (val ^ neg_val) & (val >> 63);
-                          return air_status_next;
-                        }
+              // Instantiate the function, and push it as a temporary value.
+              ctx.stack().push().set_temporary(
+                     ::rocket::make_refcnt<Instantiated_Function>(sp.templ, move(captures)));
+              return air_status_next;
+            }
 
-                        if(rhs.type() == type_real) {
-                          V_real& val = rhs.mut_real();
+            // Uparam
+            , up2
 
-                          double result = ::std::fabs(val);
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-                          val = result;
-                          return air_status_next;
-                        }
+            // Collector
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              sp.templ->collect_variables(staged, temp);
+            }
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__abs` not applicable (operand was `$1`)", rhs);
-                      }
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                    case xop_sign:
-                      {
-                        // Get the sign bit of the operand as a boolean value.
-                        if(rhs.type() == type_integer) {
-                          rhs = rhs.as_integer() < 0;
-                          return air_status_next;
-                        }
+      case index_branch_expression:
+        {
+          const auto& altr = this->m_stor.as<S_branch_expression>();
 
-                        if(rhs.type() == type_real) {
-                          rhs = ::std::signbit(rhs.as_real());
-                          return air_status_next;
-                        }
+          Uparam up2;
+          up2.b0 = altr.assign;
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__sign` not applicable (operand was `$1`)", rhs);
-                      }
+          struct Sparam
+            {
+              AVM_Rod rod_true;
+              AVM_Rod rod_false;
+            };
 
-                    case xop_round:
-                      {
-                        // Round the operand to the nearest integer of the same type.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+          Sparam sp2;
+          do_solidify_nodes(sp2.rod_true, altr.code_true);
+          do_solidify_nodes(sp2.rod_false, altr.code_false);
 
-                        if(rhs.type() == type_real) {
-                          rhs.mut_real() = ::std::round(rhs.as_real());
-                          return air_status_next;
-                        }
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const bool assign = head->uparam.b0;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__round` not applicable (operand was `$1`)", rhs);
-                      }
+              // Read the condition and evaluate the corresponding subexpression.
+              return ctx.stack().top().dereference_readonly().test()
+                       ? do_evaluate_subexpression(ctx, assign, sp.rod_true)
+                       : do_evaluate_subexpression(ctx, assign, sp.rod_false);
+            }
 
-                    case xop_floor:
-                      {
-                        // Round the operand to the nearest integer of the same type,
-                        // towards negative infinity.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+            // Uparam
+            , up2
 
-                        if(rhs.type() == type_real) {
-                          rhs.mut_real() = ::std::floor(rhs.as_real());
-                          return air_status_next;
-                        }
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__floor` not applicable (operand was `$1`)", rhs);
-                      }
+            // Collector
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              sp.rod_true.collect_variables(staged, temp);
+              sp.rod_false.collect_variables(staged, temp);
+            }
 
-                    case xop_ceil:
-                      {
-                        // Round the operand to the nearest integer of the same type,
-                        // towards positive infinity.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                        if(rhs.type() == type_real) {
-                          rhs.mut_real() = ::std::ceil(rhs.as_real());
-                          return air_status_next;
-                        }
+      case index_function_call:
+        {
+          const auto& altr = this->m_stor.as<S_function_call>();
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__ceil` not applicable (operand was `$1`)", rhs);
-                      }
+          Uparam up2;
+          up2.u0 = altr.ptc;
+          up2.u2345 = altr.nargs;
 
-                    case xop_trunc:
-                      {
-                        // Truncate the operand to the nearest integer towards zero.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+            {
+              const PTC_Aware ptc = static_cast<PTC_Aware>(head->uparam.u0);
+              const uint32_t nargs = head->uparam.u2345;
+              const auto& sloc = head->pv_meta->sloc;
+              const auto sentry = ctx.global().copy_recursion_sentry();
 
-                        if(rhs.type() == type_real) {
-                          rhs.mut_real() = ::std::trunc(rhs.as_real());
-                          return air_status_next;
-                        }
+              if(auto hooks = ctx.global().get_hooks_opt())
+                hooks->on_trap(sloc, ctx);
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__trunc` not applicable (operand was `$1`)", rhs);
-                      }
+              // Collect arguments from left to right.
+              ctx.alt_stack().clear();
+              for(uint32_t k = 0;  k != nargs;  ++k)
+                ctx.alt_stack().push() = move(ctx.stack().mut_top(nargs - 1 - k));
+              ctx.stack().pop(nargs);
 
-                    case xop_iround:
-                      {
-                        // Round the operand to the nearest integer.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+              // Copy the target reference into the red zone, as we probably don't
+              // want to introduce a temporary object on the system stack.
+              ctx.stack().clear_red_zone();
+              ctx.stack().push();
+              ctx.stack().mut_top() = ctx.stack().top(1);
+              const auto& target = ctx.stack().top().dereference_readonly();
+              ctx.stack().pop();
+              ctx.stack().mut_top().pop_modifier();
+              return do_invoke_partial(ctx.stack().mut_top(), ctx, sloc, ptc, target);
+            }
 
-                        if(rhs.type() == type_real) {
-                          rhs = safe_double_to_int64(::std::round(rhs.as_real()));
-                          return air_status_next;
-                        }
+            // Uparam
+            , up2
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__iround` not applicable (operand was `$1`)", rhs);
-                      }
+            // Sparam
+            , 0, nullptr, nullptr, nullptr
 
-                    case xop_ifloor:
-                      {
-                        // Round the operand to the nearest integer towards negative infinity.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+            // Collector
+            , nullptr
 
-                        if(rhs.type() == type_real) {
-                          rhs = safe_double_to_int64(::std::floor(rhs.as_real()));
-                          return air_status_next;
-                        }
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__ifloor` not applicable (operand was `$1`)", rhs);
-                      }
+      case index_push_unnamed_array:
+        {
+          const auto& altr = this->m_stor.as<S_push_unnamed_array>();
 
-                    case xop_iceil:
-                      {
-                        // Round the operand to the nearest integer towards positive infinity.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+          Uparam up2;
+          up2.u2345 = altr.nelems;
 
-                        if(rhs.type() == type_real) {
-                          rhs = safe_double_to_int64(::std::ceil(rhs.as_real()));
-                          return air_status_next;
-                        }
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const uint32_t nelems = head->uparam.u2345;
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__iceil` not applicable (operand was `$1`)", rhs);
-                      }
+              // Pop elements from the stack and fill them from right to left.
+              V_array arr;
+              arr.resize(nelems);
+              for(auto it = arr.mut_rbegin();  it != arr.rend();  ++it) {
+                *it = ctx.stack().top().dereference_readonly();
+                ctx.stack().pop();
+              }
 
-                    case xop_itrunc:
-                      {
-                        // Truncate the operand to the nearest integer towards zero.
-                        if(rhs.type() == type_integer) {
-                          return air_status_next;
-                        }
+              // Push the array as a temporary.
+              ctx.stack().push().set_temporary(move(arr));
+              return air_status_next;
+            }
 
-                        if(rhs.type() == type_real) {
-                          rhs = safe_double_to_int64(::std::trunc(rhs.as_real()));
-                          return air_status_next;
-                        }
+            // Uparam
+            , up2
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__itrunc` not applicable (operand was `$1`)", rhs);
-                      }
+            // Sparam
+            , 0, nullptr, nullptr, nullptr
 
-                    case xop_lzcnt:
-                      {
-                        // Get the number of leading zeroes in the operand.
-                        if(rhs.type() == type_integer) {
-                          V_integer& val = rhs.mut_integer();
+            // Collector
+            , nullptr
 
-                          val = (int64_t) ROCKET_LZCNT64((uint64_t) val);
-                          return air_status_next;
-                        }
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__lzcnt` not applicable (operand was `$1`)", rhs);
-                      }
+      case index_push_unnamed_object:
+        {
+          const auto& altr = this->m_stor.as<S_push_unnamed_object>();
 
-                    case xop_tzcnt:
-                      {
-                        // Get the number of trailing zeroes in the operand.
-                        if(rhs.type() == type_integer) {
-                          V_integer& val = rhs.mut_integer();
+          struct Sparam
+            {
+              cow_vector<phsh_string> keys;
+            };
 
-                          val = (int64_t) ROCKET_TZCNT64((uint64_t) val);
-                          return air_status_next;
-                        }
+          Sparam sp2;
+          sp2.keys = altr.keys;
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__tzcnt` not applicable (operand was `$1`)", rhs);
-                      }
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
 
-                    case xop_popcnt:
-                      {
-                        // Get the number of ones in the operand.
-                        if(rhs.type() == type_integer) {
-                          V_integer& val = rhs.mut_integer();
+              // Pop elements from the stack and set them from right to left. In case
+              // of duplicate keys, the rightmost value takes precedence.
+              V_object obj;
+              obj.reserve(sp.keys.size());
+              for(auto it = sp.keys.rbegin();  it != sp.keys.rend();  ++it) {
+                obj.try_emplace(*it, ctx.stack().top().dereference_readonly());
+                ctx.stack().pop();
+              }
 
-                          val = (int64_t) ROCKET_POPCNT64((uint64_t) val);
-                          return air_status_next;
-                        }
+              // Push the object as a temporary.
+              ctx.stack().push().set_temporary(move(obj));
+              return air_status_next;
+            }
 
-                        throw Runtime_Error(xtc_format,
-                                 "`__popcnt` not applicable (operand was `$1`)", rhs);
-                      }
+            // Uparam
+            , Uparam()
 
-                    default:
-                      ROCKET_UNREACHABLE();
-                  }
-                }
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
 
-                // Uparam
-                , up2
+            // Collector
+            , nullptr
 
-                // Sparam
-                , 0, nullptr, nullptr, nullptr
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
 
-                // Collector
-                , nullptr
+      case index_apply_operator:
+        {
+          const auto& altr = this->m_stor.as<S_apply_operator>();
 
-                // Symbols
-                , &(altr.sloc)
-              );
-              return;
+          Uparam up2;
+          up2.b0 = altr.assign;
+          up2.u1 = altr.xop;
 
-            case xop_cmp_eq:
-            case xop_cmp_ne:
-            case xop_cmp_un:
-            case xop_cmp_lt:
-            case xop_cmp_gt:
-            case xop_cmp_lte:
-            case xop_cmp_gte:
-            case xop_cmp_3way:
-            case xop_add:
-            case xop_sub:
-            case xop_mul:
-            case xop_div:
-            case xop_mod:
-            case xop_andb:
-            case xop_orb:
-            case xop_xorb:
-            case xop_addm:
-            case xop_subm:
-            case xop_mulm:
-            case xop_adds:
-            case xop_subs:
-            case xop_muls:
-              // binary
+          switch(altr.xop)
+            {
+            case xop_inc:
+            case xop_dec:
+            case xop_unset:
+            case xop_head:
+            case xop_tail:
+            case xop_random:
+            case xop_isvoid:
+              // unary
               rod.append(
                 +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
                 {
                   const bool assign = head->uparam.b0;
                   const uint8_t uxop = head->uparam.u1;
-                  const auto& rhs = ctx.stack().top().dereference_readonly();
-                  ctx.stack().pop();
-                  auto& top = ctx.stack().mut_top();
-                  auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
-
-                  // The fast path should be a proper tail call.
-                  if(rhs.type() == type_integer)
-                    return do_apply_binary_operator_with_integer(uxop, lhs, rhs.as_integer());
-
-                  switch(uxop)
-                      {
-                    case xop_cmp_eq:
-                      {
-                        // Check whether the two operands are equal. Unordered values are
-                        // considered to be unequal.
-                        lhs = lhs.compare_partial(rhs) == compare_equal;
-                        return air_status_next;
-                      }
-
-                    case xop_cmp_ne:
-                      {
-                        // Check whether the two operands are not equal. Unordered values are
-                        // considered to be unequal.
-                        lhs = lhs.compare_partial(rhs) != compare_equal;
-                        return air_status_next;
-                      }
-
-                    case xop_cmp_un:
-                      {
-                        // Check whether the two operands are unordered.
-                        lhs = lhs.compare_partial(rhs) == compare_unordered;
-                        return air_status_next;
-                      }
-
-                    case xop_cmp_lt:
-                      {
-                        // Check whether the LHS operand is less than the RHS operand. If
-                        // they are unordered, an exception shall be thrown.
-                        lhs = lhs.compare_total(rhs) == compare_less;
-                        return air_status_next;
-                      }
+                  auto& top = ctx.stack().mut_top();
 
-                    case xop_cmp_gt:
+                  switch(uxop)
                       {
-                        // Check whether the LHS operand is greater than the RHS operand. If
-                        // they are unordered, an exception shall be thrown.
-                        lhs = lhs.compare_total(rhs) == compare_greater;
-                        return air_status_next;
-                      }
-
-                    case xop_cmp_lte:
+                    case xop_inc:
                       {
-                        // Check whether the LHS operand is less than or equal to the RHS
-                        // operand. If they are unordered, an exception shall be thrown.
-                        lhs = lhs.compare_total(rhs) != compare_greater;
-                        return air_status_next;
-                      }
+                        // `assign` is `true` for the postfix variant and `false` for
+                        // the prefix variant.
+                        auto& rhs = top.dereference_mutable();
 
-                    case xop_cmp_gte:
-                      {
-                        // Check whether the LHS operand is greater than or equal to the RHS
-                        // operand. If they are unordered, an exception shall be thrown.
-                        lhs = lhs.compare_total(rhs) != compare_less;
-                        return air_status_next;
-                      }
+                        if(rhs.type() == type_integer) {
+                          V_integer& val = rhs.mut_integer();
 
-                    case xop_cmp_3way:
-                      {
-                        // Defines a partial ordering on all values. For unordered operands,
-                        // a string is returned, so `x <=> y` and `(x <=> y) <=> 0` produces
-                        // the same result.
-                        int64_t cmp = lhs.compare_partial(rhs);
-                        lhs = cmp - compare_equal;
-                        if(ROCKET_UNEXPECT(cmp == compare_unordered))
-                          lhs = &"[unordered]";
-                        return air_status_next;
-                      }
+                          // Increment the value with overflow checking.
+                          int64_t result;
+                          if(ROCKET_ADD_OVERFLOW(val, 1, &result))
+                            throw Runtime_Error(xtc_format,
+                                     "Integer increment overflow (operand was `$1`)", val);
 
-                    case xop_add:
-                      {
-                        // Perform logical OR on two boolean values, or get the sum of two
-                        // arithmetic values, or concatenate two strings.
-                        if(lhs.is_real() && rhs.is_real()) {
-                          V_real& val = lhs.mut_real();
-                          V_real other = rhs.as_real();
+                          if(assign)
+                            top.set_temporary(val);
 
-                          val += other;
+                          val = result;
                           return air_status_next;
                         }
 
-                        if(lhs.is_string() && rhs.is_string()) {
-                          V_string& val = lhs.mut_string();
-                          const V_string& other = rhs.as_string();
+                        if(rhs.type() == type_real) {
+                          V_real& val = rhs.mut_real();
 
-                          val.append(other);
-                          return air_status_next;
-                        }
+                          // Overflow will result in an infinity, so this is safe.
+                          double result = val + 1;
 
-                        if(lhs.is_boolean() && rhs.is_boolean()) {
-                          V_boolean& val = lhs.mut_boolean();
-                          V_boolean other = rhs.as_boolean();
+                          if(assign)
+                            top.set_temporary(val);
 
-                          val |= other;
+                          val = result;
                           return air_status_next;
                         }
 
                         throw Runtime_Error(xtc_format,
-                                 "Addition not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
+                                 "Increment not applicable (operand was `$1`)", rhs);
                       }
 
-                    case xop_sub:
+                    case xop_dec:
                       {
-                        // Perform logical XOR on two boolean values, or get the difference
-                        // of two arithmetic values.
-                        if(lhs.is_real() && rhs.is_real()) {
-                          V_real& val = lhs.mut_real();
-                          V_real other = rhs.as_real();
-
-                          // Overflow will result in an infinity, so this is safe.
-                          val -= other;
-                          return air_status_next;
-                        }
-
-                        if(lhs.is_boolean() && rhs.is_boolean()) {
-                          V_boolean& val = lhs.mut_boolean();
-                          V_boolean other = rhs.as_boolean();
-
-                          // Perform logical XOR of the operands.
-                          val ^= other;
-                          return air_status_next;
-                        }
+                        // `assign` is `true` for the postfix variant and `false` for
+                        // the prefix variant.
+                        auto& rhs = top.dereference_mutable();
 
-                        throw Runtime_Error(xtc_format,
-                                 "Subtraction not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+                        if(rhs.type() == type_integer) {
+                          V_integer& val = rhs.mut_integer();
 
-                    case xop_mul:
-                      {
-                         // Perform logical AND on two boolean values, or get the product of
-                         // two arithmetic values, or duplicate a string or array by a given
-                         // times.
-                        if(lhs.is_real() && rhs.is_real()) {
-                          V_real& val = lhs.mut_real();
-                          V_real other = rhs.as_real();
-
-                          val *= other;
-                          return air_status_next;
-                        }
+                          // Decrement the value with overflow checking.
+                          int64_t result;
+                          if(ROCKET_SUB_OVERFLOW(val, 1, &result))
+                            throw Runtime_Error(xtc_format,
+                                     "Integer decrement overflow (operand was `$1`)", val);
 
-                        if(lhs.is_integer() && rhs.is_string()) {
-                          V_integer count = lhs.as_integer();
-                          lhs = rhs.as_string();
-                          V_string& val = lhs.mut_string();
+                          if(assign)
+                            top.set_temporary(val);
 
-                          do_duplicate_sequence(val, count);
+                          val = result;
                           return air_status_next;
                         }
 
-                        if(lhs.is_integer() && rhs.is_array()) {
-                          V_integer count = lhs.as_integer();
-                          lhs = rhs.as_array();
-                          V_array& val = lhs.mut_array();
+                        if(rhs.type() == type_real) {
+                          V_real& val = rhs.mut_real();
 
-                          do_duplicate_sequence(val, count);
-                          return air_status_next;
-                        }
+                          // Overflow will result in an infinity, so this is safe.
+                          double result = val - 1;
 
-                        if(lhs.is_boolean() && rhs.is_boolean()) {
-                          V_boolean& val = lhs.mut_boolean();
-                          V_boolean other = rhs.as_boolean();
+                          if(assign)
+                            top.set_temporary(val);
 
-                          val &= other;
+                          val = result;
                           return air_status_next;
                         }
 
                         throw Runtime_Error(xtc_format,
-                                 "Multiplication not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
+                                 "Decrement not applicable (operand was `$1`)", rhs);
                       }
 
-                    case xop_div:
+                    case xop_unset:
                       {
-                        // Get the quotient of two arithmetic values. If both operands are
-                        // integers, the result is also an integer, truncated towards zero.
-                        if(lhs.is_real() && rhs.is_real()) {
-                          V_real& val = lhs.mut_real();
-                          V_real other = rhs.as_real();
-
-                          val /= other;
-                          return air_status_next;
-                        }
+                        // Unset the last element and return it as a temporary.
+                        // `assign` is ignored.
+                        auto val = top.dereference_unset();
+                        top.set_temporary(move(val));
+                        return air_status_next;
+                      }
 
-                        throw Runtime_Error(xtc_format,
-                                 "Division not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
+                    case xop_head:
+                      {
+                        // Push an array head modifier. `assign` is ignored.
+                        Reference_Modifier::S_array_head xmod = { };
+                        do_push_modifier_and_check(top, move(xmod));
+                        return air_status_next;
                       }
 
-                    case xop_mod:
+                    case xop_tail:
                       {
-                        // Get the remainder of two arithmetic values. The quotient is
-                        // truncated towards zero. If both operands are integers, the result
-                        // is also an integer.
-                        if(lhs.is_real() && rhs.is_real()) {
-                          V_real& val = lhs.mut_real();
-                          V_real other = rhs.as_real();
-
-                          val = ::std::fmod(val, other);
-                          return air_status_next;
-                        }
+                        // Push an array tail modifier. `assign` is ignored.
+                        Reference_Modifier::S_array_tail xmod = { };
+                        do_push_modifier_and_check(top, move(xmod));
+                        return air_status_next;
+                      }
 
-                        throw Runtime_Error(xtc_format,
-                                 "Modulo not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
+                    case xop_random:
+                      {
+                        // Push a random subscript.
+                        uint32_t seed = ctx.global().random_engine()->bump();
+                        Reference_Modifier::S_array_random xmod = { seed };
+                        do_push_modifier_and_check(top, move(xmod));
+                        return air_status_next;
                       }
 
-                    case xop_andb:
+                    case xop_isvoid:
                       {
-                        // Perform the bitwise AND operation on all bits of the operands. If
-                        // the two operands have different lengths, the result is truncated
-                        // to the same length as the shorter one.
-                        if(lhs.is_string() && rhs.is_string()) {
-                          V_string& val = lhs.mut_string();
-                          const V_string& mask = rhs.as_string();
-
-                          if(val.size() > mask.size())
-                            val.erase(mask.size());
-                          auto maskp = mask.begin();
-                          for(auto it = val.mut_begin();  it != val.end();  ++it, ++maskp)
-                            *it = static_cast<char>(*it & *maskp);
-                          return air_status_next;
-                        }
+                        // Check whether the argument is a void reference and save
+                        // the result as a temporary boolean.
+                        // `assign` is ignored.
+                        bool val = top.is_void();
+                        top.set_temporary(val);
+                        return air_status_next;
+                      }
 
-                        if(lhs.is_boolean() && rhs.is_boolean()) {
-                          V_boolean& val = lhs.mut_boolean();
-                          V_boolean other = rhs.as_boolean();
+                    default:
+                      ROCKET_UNREACHABLE();
+                  }
+                }
 
-                          val &= other;
-                          return air_status_next;
-                        }
+                // Uparam
+                , up2
 
-                        throw Runtime_Error(xtc_format,
-                                 "Bitwise AND not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+                // Sparam
+                , 0, nullptr, nullptr, nullptr
 
-                    case xop_orb:
-                      {
-                        // Perform the bitwise OR operation on all bits of the operands. If
-                        // the two operands have different lengths, the result is padded to
-                        // the same length as the longer one, with zeroes.
-                        if(lhs.is_string() && rhs.is_string()) {
-                          V_string& val = lhs.mut_string();
-                          const V_string& mask = rhs.as_string();
-
-                          if(val.size() < mask.size())
-                            val.append(mask.size() - val.size(), 0);
-                          auto valp = val.mut_begin();
-                          for(auto it = mask.begin();  it != mask.end();  ++it, ++valp)
-                            *valp = static_cast<char>(*valp | *it);
-                          return air_status_next;
-                        }
+                // Collector
+                , nullptr
 
-                        if(lhs.is_boolean() && rhs.is_boolean()) {
-                          V_boolean& val = lhs.mut_boolean();
-                          V_boolean other = rhs.as_boolean();
+                // Symbols
+                , &(altr.sloc)
+              );
+              return;
 
-                          val |= other;
-                          return air_status_next;
-                        }
+            case xop_assign:
+            case xop_index:
+              // binary
+              rod.append(
+                +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+                {
+                  const uint8_t uxop = head->uparam.u1;
+                  auto& rhs = ctx.stack().mut_top().dereference_copy();
+                  ctx.stack().pop();
+                  auto& top = ctx.stack().mut_top();
 
-                        throw Runtime_Error(xtc_format,
-                                 "Bitwise OR not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
+                  switch(uxop)
+                      {
+                    case xop_assign:
+                      {
+                        // `assign` is ignored.
+                        top.dereference_mutable() = move(rhs);
+                        return air_status_next;
                       }
 
-                    case xop_xorb:
+                    case xop_index:
                       {
-                        // Perform the bitwise XOR operation on all bits of the operands. If
-                        // the two operands have different lengths, the result is padded to
-                        // the same length as the longer one, with zeroes.
-                        if(lhs.is_string() && rhs.is_string()) {
-                          V_string& val = lhs.mut_string();
-                          const V_string& mask = rhs.as_string();
-
-                          if(val.size() < mask.size())
-                            val.append(mask.size() - val.size(), 0);
-                          auto valp = val.mut_begin();
-                          for(auto it = mask.begin();  it != mask.end();  ++it, ++valp)
-                            *valp = static_cast<char>(*valp ^ *it);
+                        // Push a subscript.
+                        if(rhs.type() == type_integer) {
+                          Reference_Modifier::S_array_index xmod = { rhs.as_integer() };
+                          do_push_modifier_and_check(top, move(xmod));
                           return air_status_next;
                         }
-
-                        if(lhs.is_boolean() && rhs.is_boolean()) {
-                          V_boolean& val = lhs.mut_boolean();
-                          V_boolean other = rhs.as_boolean();
-
-                          val ^= other;
+                        else if(rhs.type() == type_string) {
+                          Reference_Modifier::S_object_key xmod = { rhs.as_string() };
+                          do_push_modifier_and_check(top, move(xmod));
                           return air_status_next;
                         }
-
-                        throw Runtime_Error(xtc_format,
-                                 "Bitwise XOR not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
+                        else
+                          throw Runtime_Error(xtc_format,
+                                   "Subscript value not valid (operand was `$1`)", rhs);
                       }
 
-                    case xop_addm:
-                      {
-                        // This should have been redirected to the fast path.
-                        throw Runtime_Error(xtc_format,
-                                 "Modular addition not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+                    default:
+                      ROCKET_UNREACHABLE();
+                  }
+                }
 
-                    case xop_subm:
-                      {
-                        // This should have been redirected to the fast path.
-                        throw Runtime_Error(xtc_format,
-                                 "Modular subtraction not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+                // Uparam
+                , up2
 
-                    case xop_mulm:
-                      {
-                        // This should have been redirected to the fast path.
-                        throw Runtime_Error(xtc_format,
-                                 "Modular multiplication not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+                // Sparam
+                , 0, nullptr, nullptr, nullptr
 
-                    case xop_adds:
-                      {
-                        // This should have been redirected to the fast path.
-                        throw Runtime_Error(xtc_format,
-                                 "Saturating addition not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+                // Collector
+                , nullptr
 
-                    case xop_subs:
-                      {
-                        // This should have been redirected to the fast path.
-                        throw Runtime_Error(xtc_format,
-                                 "Saturating subtraction not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+                // Symbols
+                , &(altr.sloc)
+              );
+              return;
 
-                    case xop_muls:
-                      {
-                        // This should have been redirected to the fast path.
-                        throw Runtime_Error(xtc_format,
-                                 "Saturating multiplication not applicable (operands were `$1` and `$2`)",
-                                 lhs, rhs);
-                      }
+            case xop_pos:
+            case xop_neg:
+            case xop_notb:
+            case xop_notl:
+            case xop_countof:
+            case xop_typeof:
+            case xop_sqrt:
+            case xop_isnan:
+            case xop_isinf:
+            case xop_abs:
+            case xop_sign:
+            case xop_round:
+            case xop_floor:
+            case xop_ceil:
+            case xop_trunc:
+            case xop_iround:
+            case xop_ifloor:
+            case xop_iceil:
+            case xop_itrunc:
+            case xop_lzcnt:
+            case xop_tzcnt:
+            case xop_popcnt:
+              // unary
+              rod.append(
+                +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+                {
+                  const bool assign = head->uparam.b0;
+                  const uint8_t uxop = head->uparam.u1;
+                  auto& top = ctx.stack().mut_top();
+                  auto& rhs = assign ? top.dereference_mutable() : top.dereference_copy();
+
+                  return do_apply_unary_operator(uxop, rhs);
+                }
+
+                // Uparam
+                , up2
+
+                // Sparam
+                , 0, nullptr, nullptr, nullptr
+
+                // Collector
+                , nullptr
+
+                // Symbols
+                , &(altr.sloc)
+              );
+              return;
+
+            case xop_cmp_eq:
+            case xop_cmp_ne:
+            case xop_cmp_un:
+            case xop_cmp_lt:
+            case xop_cmp_gt:
+            case xop_cmp_lte:
+            case xop_cmp_gte:
+            case xop_cmp_3way:
+            case xop_add:
+            case xop_sub:
+            case xop_mul:
+            case xop_div:
+            case xop_mod:
+            case xop_andb:
+            case xop_orb:
+            case xop_xorb:
+            case xop_addm:
+            case xop_subm:
+            case xop_mulm:
+            case xop_adds:
+            case xop_subs:
+            case xop_muls:
+              // binary
+              rod.append(
+                +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+                {
+                  const bool assign = head->uparam.b0;
+                  const uint8_t uxop = head->uparam.u1;
+                  const auto& qfb = *reinterpret_cast<const Quick_Feedback*>(head->sparam);
+                  const auto& rhs = ctx.stack().top().dereference_readonly();
+                  ctx.stack().pop();
+                  auto& top = ctx.stack().mut_top();
+                  auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
 
-                    default:
-                      ROCKET_UNREACHABLE();
+                  if(ROCKET_EXPECT(qfb.count == quick_warmup_count)) {
+                    // This site has been quickened. If the guard fails, it is
+                    // deoptimized and has to warm up again.
+                    if((lhs.type() == qfb.qtype) && (rhs.type() == qfb.qtype)) {
+                      bool done;
+                      if(qfb.qtype == type_integer)
+                        done = do_apply_binary_operator_quick_integer(uxop, lhs, rhs.as_integer());
+                      else if(qfb.qtype == type_real)
+                        done = do_apply_binary_operator_quick_real(uxop, lhs, rhs.as_real());
+                      else
+                        done = do_apply_binary_operator_quick_string(uxop, lhs, rhs.as_string());
+
+                      if(ROCKET_EXPECT(done))
+                        return air_status_next;
+                    }
+                    else
+                      qfb.count = 0;
                   }
+                  else
+                    do_update_quick_feedback(qfb, uxop, lhs, rhs);
+
+                  return do_apply_binary_operator(uxop, lhs, rhs);
                 }
 
                 // Uparam
                 , up2
 
                 // Sparam
-                , 0, nullptr, nullptr, nullptr
+                , sizeof(Quick_Feedback), nullptr, nullptr, nullptr
 
                 // Collector
                 , nullptr
@@ -3752,19 +4674,7 @@ solidify(AVM_Rod& rod) const
                   auto& top = ctx.stack().mut_top();
                   auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
 
-                  // Perform floating-point fused multiply-add.
-                  if(lhs.is_real() && mid.is_real() && rhs.is_real()) {
-                    V_real& val = lhs.mut_real();
-                    V_real y_mul = mid.as_real();
-                    V_real z_add = rhs.as_real();
-
-                    val = ::std::fma(val, y_mul, z_add);
-                    return air_status_next;
-                  }
-
-                  throw Runtime_Error(xtc_format,
-                           "`__fma` not applicable (operands were `$1`, `$2` and `$3`)",
-                           lhs, mid, rhs);
+                  return do_apply_fma_operator(lhs, mid, rhs);
                 }
 
                 // Uparam
@@ -3911,6 +4821,7 @@ solidify(AVM_Rod& rod) const
 
           Uparam up2;
           up2.b0 = altr.immutable;
+          up2.b1 = altr.foreign;
 
           struct Sparam
             {
@@ -3924,12 +4835,16 @@ solidify(AVM_Rod& rod) const
             +[](Executive_Context& ctx, const Header* head) -> AIR_Status
             {
               const bool immutable = head->uparam.b0;
+              const bool foreign = head->uparam.b1;
               const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
               const auto& sloc = head->pv_meta->sloc;
 
-              // Allocate a variable and inject it into the current context.
+              // Allocate a variable and inject it into the current context. If
+              // it can't be part of a reference cycle, it is not tracked. This
+              // doesn't hold in a coroutine, as a suspended one keeps its locals.
               const auto gcoll = ctx.global().garbage_collector();
-              const auto var = gcoll->create_variable();
+              const bool tracked = !foreign || ctx.global().get_coroutine_opt();
+              const auto var = tracked ? gcoll->create_variable() : gcoll->create_foreign_variable();
               ctx.insert_named_reference(sp.name).set_variable(var);
 
               if(auto hooks = ctx.global().get_hooks_opt())
@@ -4027,7 +4942,10 @@ solidify(AVM_Rod& rod) const
                 ctx.stack().push();
                 ctx.stack().mut_top() = ctx.stack().mut_top(1);
                 ctx.alt_stack().clear();
-                do_invoke_partial(ctx.stack().mut_top(), ctx, sloc, ptc_aware_none, va_gen);
+                AIR_Status status = do_invoke_partial(ctx.stack().mut_top(), ctx, sloc, ptc_aware_none, va_gen);
+                if(status != air_status_next)
+                  return status;
+
                 temp_value = ctx.stack().top().dereference_readonly();
                 ctx.stack().pop();
 
@@ -4057,7 +4975,10 @@ solidify(AVM_Rod& rod) const
                   for(uint32_t k = 0;  k != nargs;  ++k) {
                     ctx.alt_stack().clear();
                     ctx.alt_stack().push().set_temporary(V_integer(k));
-                    do_invoke_partial(ctx.stack().mut_top(k), ctx, sloc, ptc_aware_none, va_gen);
+                    status = do_invoke_partial(ctx.stack().mut_top(k), ctx, sloc, ptc_aware_none, va_gen);
+                    if(status != air_status_next)
+                      return status;
+
                     ctx.stack().top(k).dereference_readonly();
                   }
 
@@ -4197,28 +5118,34 @@ solidify(AVM_Rod& rod) const
 
               // Load and parse the file.
               abs_path.assign(realpathp.get());
-              Source_Location script_sloc(abs_path, 0, 0);
 
               Module_Loader::Unique_Stream istrm;
               istrm.reset(ctx.global().module_loader(), realpathp);
 
-              Token_Stream tstrm(sp.opts);
-              tstrm.reload(abs_path, 1, move(istrm.get()));
-
-              Statement_Sequence stmtq(sp.opts);
-              stmtq.reload(move(tstrm));
-
-              // Instantiate the script as a variadic function.
-              cow_vector<phsh_string> script_params;
-              script_params.emplace_back(&"...");
-
-              AIR_Optimizer optmz(sp.opts);
-              optmz.reload(nullptr, script_params, ctx.global(), stmtq.get_statements());
+              cow_string source;
+              char temp[4096];
+              while(size_t n = istrm.get().getn(temp, sizeof(temp)))
+                source.append(temp, n);
+
+              // If the same source has been compiled with the same options, reuse
+              // the function. Cached code may contain inlined calls, which are
+              // invisible to hooks, so it is not used if hooks have been installed.
+              const bool use_cache = !ctx.global().get_hooks_opt();
+              cow_function target;
+              if(use_cache)
+                target = istrm.get_cached_module_opt(sp.opts, source);
+
+              if(!target) {
+                target = ctx.global().module_loader()->compile_script(ctx.global(), sp.opts,
+                                                                     abs_path, source);
+                if(use_cache)
+                  istrm.set_cached_module(sp.opts, source, target);
+              }
 
               ctx.stack().clear_red_zone();
               ctx.stack().mut_top().set_void();
               return do_invoke_partial(ctx.stack().mut_top(), ctx, sloc, ptc_aware_none,
-                                       optmz.create_function(script_sloc, &"[file scope]"));
+                                       move(target));
             }
 
             // Uparam
@@ -4336,7 +5263,10 @@ solidify(AVM_Rod& rod) const
               Value exval;
               try {
                 AIR_Status status = sp.rod_body.execute(ctx);
-                ROCKET_ASSERT(status == air_status_next);
+                if(status == air_status_throw)
+                  exval = ctx.global().take_pending_exception().value();
+                else
+                  ROCKET_ASSERT(status == air_status_next);
               }
               catch(Runtime_Error& except) {
                 exval = except.value();
@@ -4813,7 +5743,469 @@ solidify(AVM_Rod& rod) const
           );
           return;
         }
+
+      case index_push_captured_reference:
+        {
+          const auto& altr = this->m_stor.as<S_push_captured_reference>();
+
+          Uparam up2;
+          up2.u2345 = altr.index;
+
+          struct Sparam
+            {
+              phsh_string name;
+            };
+
+          Sparam sp2;
+          sp2.name = altr.name;
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+            {
+              const uint32_t index = head->uparam.u2345;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+
+              // Push a copy of the captured reference. It is unbound if the name
+              // was not declared, or its initialization was bypassed, when the
+              // closure was created.
+              const auto& ref = do_get_enclosing_function(ctx).captures()[index];
+              if(ROCKET_UNEXPECT(ref.is_invalid()))
+                throw Runtime_Error(xtc_format,
+                         "Undeclared identifier or bypassed initialization `$1`", sp.name);
+
+              ctx.stack().push() = ref;
+              return air_status_next;
+            }
+
+            // Uparam
+            , up2
+
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , nullptr
+
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
+
+      case index_inline_call:
+        {
+          const auto& altr = this->m_stor.as<S_inline_call>();
+
+          Uparam up2;
+          up2.b0 = altr.by_ref;
+
+          struct Sparam
+            {
+              cow_string func;
+              Source_Location sloc_func;
+              cow_vector<phsh_string> params;
+              AVM_Rod rod_body;
+            };
+
+          Sparam sp2;
+          sp2.func = altr.func;
+          sp2.sloc_func = altr.sloc_func;
+          sp2.params = altr.params;
+          do_solidify_nodes(sp2.rod_body, altr.code_body);
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+            {
+              const bool by_ref = head->uparam.b0;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              const uint32_t nargs = static_cast<uint32_t>(sp.params.size());
+
+              // Bind arguments to parameters from left to right. The body shares
+              // the stack with the caller, so its result is left on the top.
+              Executive_Context ctx_body(xtc_plain, ctx);
+              for(uint32_t k = 0;  k != nargs;  ++k)
+                ctx_body.insert_named_reference(sp.params[k]) = move(ctx.stack().mut_top(nargs - 1 - k));
+              ctx.stack().pop(nargs);
+
+              // Evaluate the body. Append a frame for the function, as if it
+              // were called, so backtraces are the same as those of a call.
+              AIR_Status status;
+              try {
+                status = sp.rod_body.execute(ctx_body);
+              }
+              catch(Runtime_Error& except) {
+                except.push_frame_function(sp.sloc_func, sp.func);
+                throw;
+              }
+
+              if(status == air_status_throw) {
+                ctx.global().mut_pending_exception().push_frame_function(sp.sloc_func, sp.func);
+                return status;
+              }
+
+              // Convert the result like a `return` statement.
+              ROCKET_ASSERT(status == air_status_next);
+              if(ctx.stack().top().is_void())
+                return air_status_next;
+              else if(by_ref)
+                ctx.stack().top().dereference_readonly();
+              else
+                ctx.stack().mut_top().dereference_copy();
+              return air_status_next;
+            }
+
+            // Uparam
+            , up2
+
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+            {
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+              sp.rod_body.collect_variables(staged, temp);
+            }
+
+            // Symbols
+            , &(altr.sloc)
+          );
+          return;
+        }
+    }
+  }
+
+void
+AIR_Node::
+solidify_all(AVM_Rod& rod, const cow_vector<AIR_Node>& code)
+  {
+    size_t i = 0;
+    while(i != code.size()) {
+      if((code.at(i).index() == index_push_global_reference) && (i + 1 != code.size())
+         && (code.at(i + 1).index() == index_member_access)) {
+        // global, member access, member access, ...
+        // This is typically a standard library function such as `std.string.find`.
+        const auto& altr = code.at(i).as<S_push_global_reference>();
+
+        struct Sparam
+          {
+            phsh_string name;
+            cow_vector<phsh_string> keys;
+          };
+
+        Sparam sp2;
+        sp2.name = altr.name;
+
+        size_t n = 1;
+        while((i + n != code.size()) && (code.at(i + n).index() == index_member_access)) {
+          sp2.keys.emplace_back(code.at(i + n).as<S_member_access>().key);
+          n ++;
+        }
+
+        rod.append(
+          +[](Executive_Context& ctx, const Header* head) -> AIR_Status
+          {
+            const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+
+            // Look for the name in the global context.
+            auto qref = ctx.global().get_named_reference_opt(sp.name);
+            if(!qref)
+              throw Runtime_Error(xtc_format,
+                       "Undeclared identifier `$1`", sp.name);
+
+            if(qref->is_invalid())
+              throw Runtime_Error(xtc_format,
+                       "Global reference `$1` not initialized", sp.name);
+
+            // A temporary value can't be modified through this reference, so
+            // members are read directly, and a reference to the parent of the
+            // last member is pushed. This saves checking each modifier from the
+            // root. If a member is not an object, the path is evaluated as usual,
+            // so errors are reported as before.
+            if(qref->is_temporary()) {
+              const Value* qparent = &(qref->dereference_readonly());
+              for(size_t k = 0;  qparent && (k != sp.keys.size() - 1);  ++k)
+                qparent = qparent->is_object() ? qparent->as_object().ptr(sp.keys[k]) : nullptr;
+
+              if(qparent && qparent->is_object()) {
+                auto& top = ctx.stack().push();
+                top.set_temporary(*qparent);
+                Reference_Modifier::S_object_key xmod = { sp.keys.back() };
+                top.push_modifier(move(xmod));
+                return air_status_next;
+              }
+            }
+
+            // Evaluate the path as usual.
+            auto& top = ctx.stack().push();
+            top = *qref;
+            for(const auto& key : sp.keys) {
+              Reference_Modifier::S_object_key xmod = { key };
+              do_push_modifier_and_check(top, move(xmod));
+            }
+            return air_status_next;
+          }
+
+          // Uparam
+          , Uparam()
+
+          // Sparam
+          , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+          // Collector
+          , nullptr
+
+          // Symbols
+          , &(altr.sloc)
+        );
+        i += n;
+        continue;
+      }
+
+      // Look ahead for sequences that can be fused. A local reference is
+      // always pushed by `S_push_local_reference`, so all fused executors
+      // start with it.
+      if((code.at(i).index() == index_push_local_reference) && (i + 1 != code.size())) {
+        const auto& altr = code.at(i).as<S_push_local_reference>();
+        const auto& next = code.at(i + 1);
+
+        if((next.index() == index_apply_operator_bi32)
+           && do_is_fusible_binary_operator(next.as<S_apply_operator_bi32>().xop, true)) {
+          const auto& altr2 = next.as<S_apply_operator_bi32>();
+
+          if(!altr2.assign && (i + 2 != code.size())
+             && (code.at(i + 2).index() == index_if_statement)
+             && do_is_fusible_comparison_operator(altr2.xop)) {
+            // local, bi32 comparison, if
+            const auto& altr3 = code.at(i + 2).as<S_if_statement>();
+
+            Uparam up2;
+            up2.b0 = altr3.negative;
+            up2.u1 = altr2.xop;
+            up2.u2345 = altr.depth;
+
+            struct Sparam
+              {
+                phsh_string name;
+                V_integer irhs;
+                Source_Location sloc;
+                AVM_Rod rod_true;
+                AVM_Rod rod_false;
+                bool scoped_true;
+                bool scoped_false;
+              };
+
+            Sparam sp2;
+            sp2.name = altr.name;
+            sp2.irhs = altr2.irhs;
+            sp2.sloc = altr2.sloc;
+            sp2.scoped_true = do_solidify_block(sp2.rod_true, altr3.code_true);
+            sp2.scoped_false = do_solidify_block(sp2.rod_false, altr3.code_false);
+
+            rod.append(
+              +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+              {
+                const bool negative = head->uparam.b0;
+                const uint8_t uxop = head->uparam.u1;
+                const uint32_t depth = head->uparam.u2345;
+                const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+
+                // Evaluate the condition. As there are no symbols for this
+                // executor, the frame has to be pushed here.
+                try {
+                  try {
+                    auto& top = ctx.stack().push();
+                    top = do_get_local_reference(ctx, depth, sp.name);
+                    do_apply_binary_operator_with_integer(uxop, top.dereference_copy(), sp.irhs);
+                  }
+                  catch(Runtime_Error&) { throw;  }  // forward
+                  catch(exception& e) { throw Runtime_Error(xtc_format, "$1", e);  }  // replace
+                }
+                catch(Runtime_Error& except) {
+                  except.push_frame_plain(sp.sloc);
+                  throw;
+                }
+
+                // Read the condition and execute the corresponding branch as a block.
+                return (ctx.stack().top().dereference_readonly().test() != negative)
+                          ? do_execute_block(sp.rod_true, ctx, sp.scoped_true)
+                          : do_execute_block(sp.rod_false, ctx, sp.scoped_false);
+              }
+
+              // Uparam
+              , up2
+
+              // Sparam
+              , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+              // Collector
+              , +[](Variable_HashMap& staged, Variable_HashMap& temp, const Header* head)
+              {
+                const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+                sp.rod_true.collect_variables(staged, temp);
+                sp.rod_false.collect_variables(staged, temp);
+              }
+
+              // Symbols
+              , nullptr
+            );
+            i += 3;
+            continue;
+          }
+
+          // local, bi32
+          Uparam up2;
+          up2.b0 = altr2.assign;
+          up2.u1 = altr2.xop;
+          up2.u2345 = altr.depth;
+
+          struct Sparam
+            {
+              phsh_string name;
+              V_integer irhs;
+            };
+
+          Sparam sp2;
+          sp2.name = altr.name;
+          sp2.irhs = altr2.irhs;
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+            {
+              const bool assign = head->uparam.b0;
+              const uint8_t uxop = head->uparam.u1;
+              const uint32_t depth = head->uparam.u2345;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+
+              auto& top = ctx.stack().push();
+              top = do_get_local_reference(ctx, depth, sp.name);
+              auto& lhs = assign ? top.dereference_mutable() : top.dereference_copy();
+
+              return do_apply_binary_operator_with_integer(uxop, lhs, sp.irhs);
+            }
+
+            // Uparam
+            , up2
+
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , nullptr
+
+            // Symbols
+            , &(altr2.sloc)
+          );
+          i += 2;
+          continue;
+        }
+
+        if((next.index() == index_push_local_reference) && (i + 2 != code.size())
+           && (code.at(i + 2).index() == index_apply_operator)
+           && !code.at(i + 2).as<S_apply_operator>().assign
+           && do_is_fusible_binary_operator(code.at(i + 2).as<S_apply_operator>().xop, false)) {
+          // local, local, binary
+          const auto& altr2 = next.as<S_push_local_reference>();
+          const auto& altr3 = code.at(i + 2).as<S_apply_operator>();
+
+          Uparam up2;
+          up2.u1 = altr3.xop;
+
+          struct Sparam
+            {
+              phsh_string names[2];
+              uint32_t depths[2];
+            };
+
+          Sparam sp2;
+          sp2.names[0] = altr.name;
+          sp2.depths[0] = altr.depth;
+          sp2.names[1] = altr2.name;
+          sp2.depths[1] = altr2.depth;
+
+          rod.append(
+            +[](Executive_Context& ctx, const Header* head) ROCKET_FLATTEN -> AIR_Status
+            {
+              const uint8_t uxop = head->uparam.u1;
+              const auto& sp = *reinterpret_cast<const Sparam*>(head->sparam);
+
+              // The left-hand operand is copied onto the stack, and the
+              // right-hand one is read in place. The right-hand one has to be
+              // looked up last, as a lookup may create a name and rehash the
+              // dictionary, which invalidates references into it.
+              auto& top = ctx.stack().push();
+              top = do_get_local_reference(ctx, sp.depths[0], sp.names[0]);
+              auto& lhs = top.dereference_copy();
+
+              const auto& rref = do_get_local_reference(ctx, sp.depths[1], sp.names[1]);
+              return do_apply_binary_operator(uxop, lhs, rref.dereference_readonly());
+            }
+
+            // Uparam
+            , up2
+
+            // Sparam
+            , sizeof(sp2), do_sparam_ctor<Sparam>, &sp2, do_sparam_dtor<Sparam>
+
+            // Collector
+            , nullptr
+
+            // Symbols
+            , &(altr3.sloc)
+          );
+          i += 3;
+          continue;
+        }
+      }
+
+      code.at(i).solidify(rod);
+      i ++;
     }
   }
 
+cow_vector<AIR_Node>
+AIR_Node::
+generate_lazy_body(const S_define_function& altr, const Global_Context& global)
+  {
+    // Parse the body.
+    Token_Stream tstrm(altr.opts);
+    tstrm.reload(altr.lazy_tokens);
+    Statement_Sequence stmtq(altr.opts);
+    stmtq.reload_function_body(move(tstrm));
+
+    // Names that the body may capture are declared in a context of their
+    // own, which stands for the context where the function was defined.
+    Analytic_Context ctx_caps(xtc_function, nullptr, cow_vector<phsh_string>());
+    for(const auto& name : altr.lazy_names)
+      ctx_caps.insert_named_reference(name);
+
+    AIR_Optimizer optmz(altr.opts);
+    optmz.reload(&ctx_caps, altr.params, global, stmtq.get_statements());
+    auto code = optmz.get_code();
+
+    // Replace references to that context with those from the definition,
+    // which have been captured by now.
+    do_for_each_reference(code, 1,
+      [&](AIR_Node& node, uint32_t level)
+      {
+        if(node.index() != index_push_local_reference)
+          return;
+
+        const auto& local = node.as<S_push_local_reference>();
+        if(local.depth < level)
+          return;
+
+        size_t k = 0;
+        while(altr.lazy_names.at(k) != local.name)
+          k ++;
+
+        AIR_Node xnode = altr.code_body.at(k);
+        if(xnode.index() == index_push_captured_reference)
+          xnode.mut<S_push_captured_reference>().sloc = local.sloc;
+        node = move(xnode);
+      });
+
+    return code;
+  }
+
 }  // namespace asteria
@@ -8,6 +8,7 @@
 #include "reference.hpp"
 #include "../value.hpp"
 #include "../source_location.hpp"
+#include "../compiler/token.hpp"
 namespace asteria {
 
 class AIR_Node
@@ -26,6 +27,7 @@ class AIR_Node
       {
         Source_Location sloc;
         phsh_string name;
+        bool foreign;
       };
 
     struct S_initialize_variable
@@ -140,6 +142,12 @@ class AIR_Node
         cow_string func;
         cow_vector<phsh_string> params;
         cow_vector<AIR_Node> code_body;
+
+        // If the body has not been parsed, these are its tokens, and each node
+        // in `code_body` pushes a reference that the body may capture, whose
+        // name is the corresponding one in `lazy_names`.
+        cow_vector<Token> lazy_tokens;
+        cow_vector<phsh_string> lazy_names;
       };
 
     struct S_branch_expression
@@ -195,6 +203,7 @@ class AIR_Node
         Source_Location sloc;
         bool immutable;
         phsh_string name;
+        bool foreign;
       };
 
     struct S_single_step_trap
@@ -287,6 +296,23 @@ class AIR_Node
         int32_t irhs;
       };
 
+    struct S_push_captured_reference
+      {
+        Source_Location sloc;
+        uint32_t index;
+        phsh_string name;
+      };
+
+    struct S_inline_call
+      {
+        Source_Location sloc;
+        cow_string func;
+        Source_Location sloc_func;
+        cow_vector<phsh_string> params;
+        cow_vector<AIR_Node> code_body;
+        bool by_ref;
+      };
+
     enum Index : uint8_t
       {
         index_clear_stack            =  0,
@@ -331,6 +357,8 @@ class AIR_Node
         index_member_access          = 39,
         index_apply_operator_bi32    = 40,
         index_return_statement_bi32  = 41,
+        index_push_captured_reference = 42,
+        index_inline_call            = 43,
       };
 
   private:
@@ -378,6 +406,8 @@ class AIR_Node
         , S_member_access          // 39,
         , S_apply_operator_bi32    // 40,
         , S_return_statement_bi32  // 41,
+        , S_push_captured_reference  // 42,
+        , S_inline_call            // 43,
       );
 
   public:
@@ -408,6 +438,22 @@ class AIR_Node
       }
 
   public:
+    // These are accessors of the underlying node, which are used by the
+    // optimizer.
+    Index
+    index() const noexcept
+      { return static_cast<Index>(this->m_stor.index());  }
+
+    template<typename xNode>
+    const xNode&
+    as() const
+      { return this->m_stor.as<xNode>();  }
+
+    template<typename xNode>
+    xNode&
+    mut()
+      { return this->m_stor.mut<xNode>();  }
+
     // Gets the constant value, if any.
     opt<Value>
     get_constant_opt() const noexcept;
@@ -417,6 +463,13 @@ class AIR_Node
     bool
     is_terminator() const noexcept;
 
+    // If this node applies an operator without side effects, applies it to
+    // copies of `nops` operands from `ops` and returns the result. If this is
+    // not such an operator, or if the operation fails, null is returned, and
+    // the error will be reported at run time.
+    opt<Value>
+    fold_operator_opt(const Value* ops, size_t nops) const;
+
     // If this node denotes a local reference which is allocated in an executive
     // context, replace it with a copy of the reference.
     opt<AIR_Node>
@@ -430,6 +483,20 @@ class AIR_Node
     // Compress this IR node into `rod` for execution.
     void
     solidify(AVM_Rod& rod) const;
+
+    // Compress a sequence of IR nodes into `rod` for execution. Some common
+    // sequences are fused into single executors.
+    static
+    void
+    solidify_all(AVM_Rod& rod, const cow_vector<AIR_Node>& code);
+
+    // Parse and generate code for the body of a function whose parsing has
+    // been deferred. References to names in `lazy_names` are replaced with
+    // copies of the corresponding nodes in `code_body`.
+    // This function throws a `Compiler_Error` upon failure.
+    static
+    cow_vector<AIR_Node>
+    generate_lazy_body(const S_define_function& altr, const Global_Context& global);
   };
 
 inline
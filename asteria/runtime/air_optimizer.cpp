@@ -6,11 +6,1213 @@
 #include "air_node.hpp"
 #include "analytic_context.hpp"
 #include "instantiated_function.hpp"
+#include "executive_context.hpp"
+#include "runtime_error.hpp"
+#include "global_context.hpp"
+#include "abstract_hooks.hpp"
 #include "enums.hpp"
 #include "../compiler/statement.hpp"
 #include "../compiler/expression_unit.hpp"
+#include "../compiler/compiler_statistics.hpp"
+#include "../llds/avm_rod.hpp"
+#include "../llds/reference_stack.hpp"
 #include "../utils.hpp"
 namespace asteria {
+namespace {
+
+template<typename xFunc>
+void
+do_for_each_subcode(AIR_Node& node, xFunc&& func)
+  {
+    switch(node.index())
+      {
+      case AIR_Node::index_clear_stack:
+      case AIR_Node::index_declare_variable:
+      case AIR_Node::index_initialize_variable:
+      case AIR_Node::index_throw_statement:
+      case AIR_Node::index_assert_statement:
+      case AIR_Node::index_simple_status:
+      case AIR_Node::index_check_argument:
+      case AIR_Node::index_push_global_reference:
+      case AIR_Node::index_push_local_reference:
+      case AIR_Node::index_push_bound_reference:
+      case AIR_Node::index_function_call:
+      case AIR_Node::index_push_unnamed_array:
+      case AIR_Node::index_push_unnamed_object:
+      case AIR_Node::index_apply_operator:
+      case AIR_Node::index_unpack_array:
+      case AIR_Node::index_unpack_object:
+      case AIR_Node::index_define_null_variable:
+      case AIR_Node::index_single_step_trap:
+      case AIR_Node::index_variadic_call:
+      case AIR_Node::index_import_call:
+      case AIR_Node::index_declare_reference:
+      case AIR_Node::index_initialize_reference:
+      case AIR_Node::index_return_statement:
+      case AIR_Node::index_push_constant:
+      case AIR_Node::index_alt_clear_stack:
+      case AIR_Node::index_alt_function_call:
+      case AIR_Node::index_member_access:
+      case AIR_Node::index_apply_operator_bi32:
+      case AIR_Node::index_return_statement_bi32:
+      case AIR_Node::index_push_captured_reference:
+        return;
+
+      case AIR_Node::index_define_function:
+        // The body of a closure has been optimized when it was generated.
+        return;
+
+      case AIR_Node::index_inline_call:
+        // The body of an inlined function has been optimized as that function.
+        return;
+
+      case AIR_Node::index_execute_block:
+        {
+          auto& altr = node.mut<AIR_Node::S_execute_block>();
+          func(altr.code_body);
+          return;
+        }
+
+      case AIR_Node::index_if_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_if_statement>();
+          func(altr.code_true);
+          func(altr.code_false);
+          return;
+        }
+
+      case AIR_Node::index_switch_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_switch_statement>();
+          for(size_t k = 0;  k < altr.clauses.size();  ++k) {
+            func(altr.clauses.mut(k).code_label);
+            func(altr.clauses.mut(k).code_body);
+          }
+          return;
+        }
+
+      case AIR_Node::index_do_while_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_do_while_statement>();
+          func(altr.code_body);
+          func(altr.code_cond);
+          return;
+        }
+
+      case AIR_Node::index_while_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_while_statement>();
+          func(altr.code_cond);
+          func(altr.code_body);
+          return;
+        }
+
+      case AIR_Node::index_for_each_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_for_each_statement>();
+          func(altr.code_init);
+          func(altr.code_body);
+          return;
+        }
+
+      case AIR_Node::index_for_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_for_statement>();
+          func(altr.code_init);
+          func(altr.code_cond);
+          func(altr.code_step);
+          func(altr.code_body);
+          return;
+        }
+
+      case AIR_Node::index_try_statement:
+        {
+          auto& altr = node.mut<AIR_Node::S_try_statement>();
+          func(altr.code_try);
+          func(altr.code_catch);
+          return;
+        }
+
+      case AIR_Node::index_branch_expression:
+        {
+          auto& altr = node.mut<AIR_Node::S_branch_expression>();
+          func(altr.code_true);
+          func(altr.code_false);
+          return;
+        }
+
+      case AIR_Node::index_defer_expression:
+        {
+          auto& altr = node.mut<AIR_Node::S_defer_expression>();
+          func(altr.code_body);
+          return;
+        }
+
+      case AIR_Node::index_catch_expression:
+        {
+          auto& altr = node.mut<AIR_Node::S_catch_expression>();
+          func(altr.code_body);
+          return;
+        }
+
+      case AIR_Node::index_coalesce_expression:
+        {
+          auto& altr = node.mut<AIR_Node::S_coalesce_expression>();
+          func(altr.code_null);
+          return;
+        }
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), node.index());
+    }
+  }
+
+uint32_t
+do_count_nodes(cow_vector<AIR_Node>& code)
+  {
+    uint32_t count = (uint32_t) code.size();
+    for(size_t k = 0;  k < code.size();  ++k)
+      do_for_each_subcode(code.mut(k),
+          [&](cow_vector<AIR_Node>& sub) { count += do_count_nodes(sub);  });
+    return count;
+  }
+
+uint32_t
+do_get_pure_operator_arity(const AIR_Node& node)
+  {
+    // Only operators without side effects can be evaluated at compile time.
+    // Compound assignments modify their first operands, so they are excluded.
+    if(node.index() == AIR_Node::index_apply_operator_bi32) {
+      const auto& altr = node.as<AIR_Node::S_apply_operator_bi32>();
+      if(altr.assign || ::rocket::is_any_of(altr.xop, { xop_assign, xop_index }))
+        return 0;
+
+      // The second operand is encoded in the node.
+      return 1;
+    }
+
+    if(node.index() != AIR_Node::index_apply_operator)
+      return 0;
+
+    const auto& altr = node.as<AIR_Node::S_apply_operator>();
+    if(altr.assign)
+      return 0;
+
+    switch(altr.xop)
+      {
+      case xop_inc:
+      case xop_dec:
+      case xop_unset:
+      case xop_head:
+      case xop_tail:
+      case xop_random:
+      case xop_isvoid:
+      case xop_assign:
+      case xop_index:
+        return 0;
+
+      case xop_pos:
+      case xop_neg:
+      case xop_notb:
+      case xop_notl:
+      case xop_countof:
+      case xop_typeof:
+      case xop_sqrt:
+      case xop_isnan:
+      case xop_isinf:
+      case xop_abs:
+      case xop_sign:
+      case xop_round:
+      case xop_floor:
+      case xop_ceil:
+      case xop_trunc:
+      case xop_iround:
+      case xop_ifloor:
+      case xop_iceil:
+      case xop_itrunc:
+      case xop_lzcnt:
+      case xop_tzcnt:
+      case xop_popcnt:
+        return 1;
+
+      case xop_cmp_eq:
+      case xop_cmp_ne:
+      case xop_cmp_un:
+      case xop_cmp_lt:
+      case xop_cmp_gt:
+      case xop_cmp_lte:
+      case xop_cmp_gte:
+      case xop_cmp_3way:
+      case xop_add:
+      case xop_sub:
+      case xop_mul:
+      case xop_div:
+      case xop_mod:
+      case xop_sll:
+      case xop_srl:
+      case xop_sla:
+      case xop_sra:
+      case xop_andb:
+      case xop_orb:
+      case xop_xorb:
+      case xop_addm:
+      case xop_subm:
+      case xop_mulm:
+      case xop_adds:
+      case xop_subs:
+      case xop_muls:
+        return 2;
+
+      case xop_fma:
+        return 3;
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), altr.xop);
+    }
+  }
+
+bool
+do_is_foldable_operand(const AIR_Node& node, const Value& val)
+  {
+    if(val.is_null() || val.is_boolean() || val.is_integer() || val.is_real())
+      return true;
+
+    if(!val.is_string())
+      return false;
+
+    // Strings may be duplicated or shifted by operators, whose results may be
+    // arbitrarily long. Don't fold them.
+    Xop xop = (node.index() == AIR_Node::index_apply_operator)
+                ? node.as<AIR_Node::S_apply_operator>().xop
+                : node.as<AIR_Node::S_apply_operator_bi32>().xop;
+
+    return ::rocket::is_none_of(xop, { xop_mul, xop_sll, xop_srl, xop_sla, xop_sra });
+  }
+
+void
+do_fold_constants(cow_vector<AIR_Node>& code)
+  {
+    for(size_t k = 0;  k < code.size();  ++k)
+      do_for_each_subcode(code.mut(k),
+          [&](cow_vector<AIR_Node>& sub) { do_fold_constants(sub);  });
+
+    size_t k = 0;
+    while(k < code.size()) {
+      // Check whether this is a pure operator whose operands are all constants.
+      // Folded results may be operands of subsequent operators.
+      uint32_t nops = do_get_pure_operator_arity(code.at(k));
+      if((nops == 0) || (nops > k)) {
+        k ++;
+        continue;
+      }
+
+      cow_vector<Value> ops;
+      for(size_t i = k - nops;  i != k;  ++i) {
+        auto qval = code.at(i).get_constant_opt();
+        if(!qval || !do_is_foldable_operand(code.at(k), *qval))
+          break;
+
+        ops.emplace_back(move(*qval));
+      }
+
+      if(ops.size() != nops) {
+        k ++;
+        continue;
+      }
+
+      // Operators are applied to values directly, without any context.
+      auto qres = code.at(k).fold_operator_opt(ops.data(), ops.size());
+      if(!qres) {
+        k ++;
+        continue;
+      }
+
+      // Replace the operands and the operator with the result.
+      k -= nops;
+      AIR_Node::S_push_constant xnode = { move(*qres) };
+      code.mut(k) = move(xnode);
+      code.erase(k + 1, nops);
+      k ++;
+    }
+  }
+
+void
+do_fold_branches(cow_vector<AIR_Node>& code)
+  {
+    for(size_t k = 0;  k < code.size();  ++k)
+      do_for_each_subcode(code.mut(k),
+          [&](cow_vector<AIR_Node>& sub) { do_fold_branches(sub);  });
+
+    size_t k = 1;
+    while(k < code.size()) {
+      // The condition is the value on the top of the stack.
+      auto qcond = code.at(k - 1).get_constant_opt();
+      if(!qcond) {
+        k ++;
+        continue;
+      }
+
+      if(code.at(k).index() == AIR_Node::index_if_statement) {
+        // Replace the condition and the statement with the branch that will be
+        // taken, which is still executed in its own scope.
+        const auto& altr = code.at(k).as<AIR_Node::S_if_statement>();
+        AIR_Node::S_execute_block xnode = { (qcond->test() != altr.negative)
+                                              ? altr.code_true : altr.code_false };
+        code.mut(k - 1) = move(xnode);
+        code.erase(k, 1);
+        continue;
+      }
+
+      if((code.at(k).index() == AIR_Node::index_branch_expression)
+         && !code.at(k).as<AIR_Node::S_branch_expression>().assign) {
+        // If the branch that will be taken is empty, the condition is the result.
+        // Otherwise, the condition is discarded and the branch is evaluated in
+        // place.
+        const auto& altr = code.at(k).as<AIR_Node::S_branch_expression>();
+        auto code_taken = qcond->test() ? altr.code_true : altr.code_false;
+        if(code_taken.empty()) {
+          code.erase(k, 1);
+          continue;
+        }
+
+        code.erase(k - 1, 2);
+        code.insert(k - 1, code_taken.begin(), code_taken.end());
+        k += code_taken.size() - 1;
+        continue;
+      }
+
+      k ++;
+    }
+  }
+
+void
+do_eliminate_dead_code(cow_vector<AIR_Node>& code)
+  {
+    for(size_t k = 0;  k < code.size();  ++k)
+      do_for_each_subcode(code.mut(k),
+          [&](cow_vector<AIR_Node>& sub) { do_eliminate_dead_code(sub);  });
+
+    // Nodes after a terminator are unreachable.
+    for(size_t k = 0;  k < code.size();  ++k)
+      if(code.at(k).is_terminator()) {
+        code.erase(k + 1);
+        break;
+      }
+  }
+
+void
+do_remove_empty_blocks(cow_vector<AIR_Node>& code)
+  {
+    for(size_t k = 0;  k < code.size();  ++k)
+      do_for_each_subcode(code.mut(k),
+          [&](cow_vector<AIR_Node>& sub) { do_remove_empty_blocks(sub);  });
+
+    size_t k = 0;
+    while(k < code.size()) {
+      bool empty = false;
+
+      if(code.at(k).index() == AIR_Node::index_execute_block) {
+        const auto& altr = code.at(k).as<AIR_Node::S_execute_block>();
+        empty = altr.code_body.empty();
+      }
+      else if(code.at(k).index() == AIR_Node::index_if_statement) {
+        // The condition is left on the stack either way.
+        const auto& altr = code.at(k).as<AIR_Node::S_if_statement>();
+        empty = altr.code_true.empty() && altr.code_false.empty();
+      }
+
+      if(empty)
+        code.erase(k, 1);
+      else
+        k ++;
+    }
+  }
+
+uint32_t
+do_get_operator_arity(Xop xop)
+  {
+    switch(xop)
+      {
+      case xop_inc:
+      case xop_dec:
+      case xop_pos:
+      case xop_neg:
+      case xop_notb:
+      case xop_notl:
+      case xop_unset:
+      case xop_countof:
+      case xop_typeof:
+      case xop_sqrt:
+      case xop_isnan:
+      case xop_isinf:
+      case xop_abs:
+      case xop_sign:
+      case xop_round:
+      case xop_floor:
+      case xop_ceil:
+      case xop_trunc:
+      case xop_iround:
+      case xop_ifloor:
+      case xop_iceil:
+      case xop_itrunc:
+      case xop_head:
+      case xop_tail:
+      case xop_lzcnt:
+      case xop_tzcnt:
+      case xop_popcnt:
+      case xop_random:
+      case xop_isvoid:
+        return 1;
+
+      case xop_index:
+      case xop_cmp_eq:
+      case xop_cmp_ne:
+      case xop_cmp_lt:
+      case xop_cmp_gt:
+      case xop_cmp_lte:
+      case xop_cmp_gte:
+      case xop_cmp_3way:
+      case xop_cmp_un:
+      case xop_add:
+      case xop_sub:
+      case xop_mul:
+      case xop_div:
+      case xop_mod:
+      case xop_sll:
+      case xop_srl:
+      case xop_sla:
+      case xop_sra:
+      case xop_andb:
+      case xop_orb:
+      case xop_xorb:
+      case xop_assign:
+      case xop_addm:
+      case xop_subm:
+      case xop_mulm:
+      case xop_adds:
+      case xop_subs:
+      case xop_muls:
+        return 2;
+
+      case xop_fma:
+        return 3;
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), xop);
+    }
+  }
+
+bool
+do_is_operator_result_aliased(Xop xop, bool assign)
+  {
+    // Check whether the result of an operator may be a reference to its first
+    // operand, instead of a temporary value.
+    return assign || ::rocket::is_any_of(xop, { xop_inc, xop_dec, xop_unset, xop_index,
+                                                xop_assign, xop_head, xop_tail, xop_random });
+  }
+
+// This is the maximum number of nodes in the body of a function that can be
+// inlined, including those in subexpressions.
+constexpr uint32_t inline_body_limit = 16;
+
+bool
+do_prepare_inline_body(cow_vector<AIR_Node>& code, uint32_t& count,
+                       const cow_vector<phsh_string>& params)
+  {
+    // Only expressions that refer to nothing but parameters and global names
+    // can be inlined. As the body will not be that of a function any more, no
+    // call in it can be a proper tail call.
+    count += (uint32_t) code.size();
+    if(count > inline_body_limit)
+      return false;
+
+    for(size_t k = 0;  k < code.size();  ++k) {
+      auto& node = code.mut(k);
+
+      if(node.index() == AIR_Node::index_push_local_reference) {
+        // Any other local name is either captured from an outer scope, or is
+        // a special one such as `__this`.
+        const auto& altr = node.as<AIR_Node::S_push_local_reference>();
+        if((altr.depth != 0) || !find(params, altr.name))
+          return false;
+      }
+      else if(node.index() == AIR_Node::index_function_call)
+        node.mut<AIR_Node::S_function_call>().ptc = ptc_aware_none;
+      else if(node.index() == AIR_Node::index_alt_function_call)
+        node.mut<AIR_Node::S_alt_function_call>().ptc = ptc_aware_none;
+      else if(node.index() == AIR_Node::index_variadic_call)
+        node.mut<AIR_Node::S_variadic_call>().ptc = ptc_aware_none;
+      else if(node.index() == AIR_Node::index_branch_expression) {
+        auto& altr = node.mut<AIR_Node::S_branch_expression>();
+        if(!do_prepare_inline_body(altr.code_true, count, params)
+           || !do_prepare_inline_body(altr.code_false, count, params))
+          return false;
+      }
+      else if(node.index() == AIR_Node::index_coalesce_expression) {
+        auto& altr = node.mut<AIR_Node::S_coalesce_expression>();
+        if(!do_prepare_inline_body(altr.code_null, count, params))
+          return false;
+      }
+      else if(node.index() == AIR_Node::index_catch_expression) {
+        auto& altr = node.mut<AIR_Node::S_catch_expression>();
+        if(!do_prepare_inline_body(altr.code_body, count, params))
+          return false;
+      }
+      else if(::rocket::is_none_of(node.index(),
+                   { AIR_Node::index_push_global_reference, AIR_Node::index_push_bound_reference,
+                     AIR_Node::index_push_constant, AIR_Node::index_check_argument,
+                     AIR_Node::index_member_access, AIR_Node::index_apply_operator,
+                     AIR_Node::index_apply_operator_bi32, AIR_Node::index_push_unnamed_array,
+                     AIR_Node::index_push_unnamed_object, AIR_Node::index_single_step_trap,
+                     AIR_Node::index_alt_clear_stack, AIR_Node::index_import_call }))
+        return false;
+    }
+    return true;
+  }
+
+opt<AIR_Node::S_inline_call>
+do_make_inline_call_opt(const AIR_Node::S_define_function& defn)
+  {
+    // The body must have been generated, and its parameters must be bound to
+    // arguments one by one.
+    if(!defn.lazy_tokens.empty() || defn.code_body.empty())
+      return nullopt;
+
+    for(size_t k = 0;  k < defn.params.size();  ++k) {
+      if(defn.params.at(k) == "...")
+        return nullopt;
+
+      for(size_t i = 0;  i < k;  ++i)
+        if(defn.params.at(i) == defn.params.at(k))
+          return nullopt;
+    }
+
+    AIR_Node::S_inline_call xcall = { defn.sloc, defn.func, defn.sloc, defn.params,
+                                      defn.code_body, false };
+
+    // Frames in backtraces shall look the same as those of calls.
+    Instantiated_Function::Template::append_signature(xcall.func, xcall.params);
+
+    // The body must consist of a single `return` statement with an expression,
+    // which is evaluated in place and is then left on the stack.
+    auto& ret = xcall.code_body.mut_back();
+    if(ret.index() == AIR_Node::index_return_statement) {
+      const auto& altr = ret.as<AIR_Node::S_return_statement>();
+      if(altr.is_void)
+        return nullopt;
+
+      xcall.by_ref = altr.by_ref;
+      xcall.code_body.pop_back();
+    }
+    else if(ret.index() == AIR_Node::index_return_statement_bi32) {
+      const auto& altr = ret.as<AIR_Node::S_return_statement_bi32>();
+      AIR_Node::S_push_constant xnode = { nullopt };
+      if(altr.type == type_boolean)
+        xnode.val = (altr.irhs != 0);
+      else if(altr.type == type_integer)
+        xnode.val = (V_integer) altr.irhs;
+      ret = move(xnode);
+    }
+    else if((ret.index() == AIR_Node::index_function_call)
+            && (ret.as<AIR_Node::S_function_call>().ptc != ptc_aware_void))
+      xcall.by_ref = ret.as<AIR_Node::S_function_call>().ptc == ptc_aware_by_ref;
+    else if((ret.index() == AIR_Node::index_alt_function_call)
+            && (ret.as<AIR_Node::S_alt_function_call>().ptc != ptc_aware_void))
+      xcall.by_ref = ret.as<AIR_Node::S_alt_function_call>().ptc == ptc_aware_by_ref;
+    else
+      return nullopt;
+
+    // The body shares the stack with its caller, so it must not be cleared.
+    if(!xcall.code_body.empty() && (xcall.code_body.front().index() == AIR_Node::index_clear_stack))
+      xcall.code_body.erase(0, 1);
+
+    uint32_t count = 0;
+    if(!do_prepare_inline_body(xcall.code_body, count, xcall.params))
+      return nullopt;
+
+    return move(xcall);
+  }
+
+bool
+do_get_stack_effect(uint32_t& npop, uint32_t& npush, const AIR_Node& node)
+  {
+    // Get the number of references that `node` pops from the stack, and the
+    // number of references that it pushes, if they can be determined.
+    switch(node.index())
+      {
+      case AIR_Node::index_push_global_reference:
+      case AIR_Node::index_push_local_reference:
+      case AIR_Node::index_push_bound_reference:
+      case AIR_Node::index_push_captured_reference:
+      case AIR_Node::index_push_constant:
+      case AIR_Node::index_define_function:
+      case AIR_Node::index_catch_expression:
+        npop = 0;
+        npush = 1;
+        return true;
+
+      case AIR_Node::index_check_argument:
+      case AIR_Node::index_member_access:
+      case AIR_Node::index_apply_operator_bi32:
+      case AIR_Node::index_branch_expression:
+      case AIR_Node::index_coalesce_expression:
+        npop = 1;
+        npush = 1;
+        return true;
+
+      case AIR_Node::index_single_step_trap:
+        npop = 0;
+        npush = 0;
+        return true;
+
+      case AIR_Node::index_apply_operator:
+        npop = do_get_operator_arity(node.as<AIR_Node::S_apply_operator>().xop);
+        npush = 1;
+        return true;
+
+      case AIR_Node::index_push_unnamed_array:
+        npop = node.as<AIR_Node::S_push_unnamed_array>().nelems;
+        npush = 1;
+        return true;
+
+      case AIR_Node::index_push_unnamed_object:
+        npop = (uint32_t) node.as<AIR_Node::S_push_unnamed_object>().keys.size();
+        npush = 1;
+        return true;
+
+      case AIR_Node::index_function_call:
+        npop = node.as<AIR_Node::S_function_call>().nargs + 1;
+        npush = 1;
+        return true;
+
+      case AIR_Node::index_import_call:
+        npop = node.as<AIR_Node::S_import_call>().nargs;
+        npush = 1;
+        return true;
+
+      case AIR_Node::index_inline_call:
+        npop = (uint32_t) node.as<AIR_Node::S_inline_call>().params.size();
+        npush = 1;
+        return true;
+
+      case AIR_Node::index_clear_stack:
+      case AIR_Node::index_execute_block:
+      case AIR_Node::index_declare_variable:
+      case AIR_Node::index_initialize_variable:
+      case AIR_Node::index_if_statement:
+      case AIR_Node::index_switch_statement:
+      case AIR_Node::index_do_while_statement:
+      case AIR_Node::index_while_statement:
+      case AIR_Node::index_for_each_statement:
+      case AIR_Node::index_for_statement:
+      case AIR_Node::index_try_statement:
+      case AIR_Node::index_throw_statement:
+      case AIR_Node::index_assert_statement:
+      case AIR_Node::index_simple_status:
+      case AIR_Node::index_unpack_array:
+      case AIR_Node::index_unpack_object:
+      case AIR_Node::index_define_null_variable:
+      case AIR_Node::index_variadic_call:
+      case AIR_Node::index_defer_expression:
+      case AIR_Node::index_declare_reference:
+      case AIR_Node::index_initialize_reference:
+      case AIR_Node::index_return_statement:
+      case AIR_Node::index_alt_clear_stack:
+      case AIR_Node::index_alt_function_call:
+      case AIR_Node::index_return_statement_bi32:
+        return false;
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), node.index());
+    }
+  }
+
+bool
+do_find_inline_call(size_t& kcall, uint32_t& nargs, const cow_vector<AIR_Node>& code,
+                    size_t kpush)
+  {
+    // Find the call to the function that is pushed by `code[kpush]`. `nargs`
+    // is the number of references above it on the stack.
+    nargs = 0;
+
+    if((kpush + 1 < code.size()) && (code.at(kpush + 1).index() == AIR_Node::index_alt_clear_stack)) {
+      // Arguments are evaluated on the other stack. As this is only possible
+      // if no argument contains a call, the call is the next one.
+      for(size_t k = kpush + 2;  k < code.size();  ++k) {
+        if(code.at(k).index() == AIR_Node::index_alt_function_call) {
+          kcall = k;
+          return true;
+        }
+
+        uint32_t npop, npush;
+        if(!do_get_stack_effect(npop, npush, code.at(k)) || (npop > nargs))
+          return false;
+
+        nargs = nargs - npop + npush;
+      }
+      return false;
+    }
+
+    size_t k = kpush + 1;
+    while(k < code.size()) {
+      const auto& node = code.at(k);
+      if((node.index() == AIR_Node::index_function_call)
+         && (node.as<AIR_Node::S_function_call>().nargs == nargs)) {
+        kcall = k;
+        return true;
+      }
+
+      if(node.index() == AIR_Node::index_alt_clear_stack) {
+        // This is a nested call whose arguments are evaluated on the other
+        // stack. Its result replaces its target function.
+        if(nargs == 0)
+          return false;
+
+        while((k < code.size()) && (code.at(k).index() != AIR_Node::index_alt_function_call))
+          k ++;
+
+        k ++;
+        continue;
+      }
+
+      // Any node that pops the function itself is not a call to it.
+      uint32_t npop, npush;
+      if(!do_get_stack_effect(npop, npush, node) || (npop > nargs))
+        return false;
+
+      nargs = nargs - npop + npush;
+      k ++;
+    }
+    return false;
+  }
+
+struct Inline_Candidate
+  {
+    uint32_t level;
+    phsh_string name;
+    AIR_Node::S_inline_call call;
+  };
+
+void
+do_erase_inline_candidate(cow_vector<Inline_Candidate>& cands, uint32_t level, phsh_stringR name)
+  {
+    for(size_t k = 0;  k < cands.size();  ++k)
+      if((cands.at(k).level == level) && (cands.at(k).name == name)) {
+        cands.erase(k, 1);
+        return;
+      }
+  }
+
+const Inline_Candidate*
+do_find_inline_candidate(const cow_vector<Inline_Candidate>& cands, uint32_t level, phsh_stringR name)
+  {
+    for(size_t k = 0;  k < cands.size();  ++k)
+      if((cands.at(k).level == level) && (cands.at(k).name == name))
+        return &(cands.at(k));
+    return nullptr;
+  }
+
+void
+do_inline_calls(cow_vector<AIR_Node>& code, cow_vector<Inline_Candidate>& cands, uint32_t level);
+
+void
+do_inline_calls_in_scope(cow_vector<AIR_Node>& code, cow_vector<Inline_Candidate>& cands,
+                         uint32_t level)
+  {
+    // Functions that are defined in a nested scope are not visible outside.
+    size_t mark = cands.size();
+    do_inline_calls(code, cands, level);
+    cands.erase(mark);
+  }
+
+void
+do_inline_calls(cow_vector<AIR_Node>& code, cow_vector<Inline_Candidate>& cands, uint32_t level)
+  {
+    // `level` is the number of contexts between `code` and the outermost one,
+    // and mirrors `do_for_each_reference()`. `cands` contains functions that
+    // are bound to immutable variables, and whose bodies can be inlined.
+    size_t k = 0;
+    while(k < code.size()) {
+      auto& node = code.mut(k);
+
+      if(node.index() == AIR_Node::index_declare_variable) {
+        // A name may be redeclared, so the old function is hidden. A function
+        // that is defined by `func` or `const` is a candidate.
+        const auto& altr = node.as<AIR_Node::S_declare_variable>();
+        do_erase_inline_candidate(cands, level, altr.name);
+
+        if((k + 2 < code.size()) && (code.at(k + 1).index() == AIR_Node::index_define_function)
+           && (code.at(k + 2).index() == AIR_Node::index_initialize_variable)
+           && code.at(k + 2).as<AIR_Node::S_initialize_variable>().immutable)
+          if(auto qcall = do_make_inline_call_opt(code.at(k + 1).as<AIR_Node::S_define_function>())) {
+            Inline_Candidate cand = { level, altr.name, move(*qcall) };
+            cands.emplace_back(move(cand));
+          }
+      }
+      else if(node.index() == AIR_Node::index_define_null_variable)
+        do_erase_inline_candidate(cands, level, node.as<AIR_Node::S_define_null_variable>().name);
+      else if(node.index() == AIR_Node::index_declare_reference)
+        do_erase_inline_candidate(cands, level, node.as<AIR_Node::S_declare_reference>().name);
+      else if(node.index() == AIR_Node::index_push_local_reference) {
+        // Check whether this is a call to a candidate.
+        const auto& altr = node.as<AIR_Node::S_push_local_reference>();
+        auto qcand = (altr.depth <= level)
+                       ? do_find_inline_candidate(cands, level - altr.depth, altr.name)
+                       : nullptr;
+
+        size_t kcall = 0;
+        uint32_t nargs = 0;
+        if(qcand && do_find_inline_call(kcall, nargs, code, k)
+           && (nargs == qcand->call.params.size())) {
+          // Replace the call with the body, and discard the function.
+          // Arguments are now always evaluated on the primary stack.
+          bool alt = code.at(kcall).index() == AIR_Node::index_alt_function_call;
+          AIR_Node::S_inline_call xnode = qcand->call;
+          PTC_Aware ptc;
+          if(alt) {
+            xnode.sloc = code.at(kcall).as<AIR_Node::S_alt_function_call>().sloc;
+            ptc = code.at(kcall).as<AIR_Node::S_alt_function_call>().ptc;
+          }
+          else {
+            xnode.sloc = code.at(kcall).as<AIR_Node::S_function_call>().sloc;
+            ptc = code.at(kcall).as<AIR_Node::S_function_call>().ptc;
+          }
+
+          if(ptc != ptc_aware_none) {
+            // The result of a proper tail call is returned from the enclosing
+            // function.
+            AIR_Node::S_return_statement xret = { xnode.sloc, ptc == ptc_aware_by_ref,
+                                                  ptc == ptc_aware_void };
+            code.insert(kcall + 1, move(xret));
+          }
+
+          code.mut(kcall) = move(xnode);
+          code.erase(k, alt ? 2U : 1U);
+
+          // Arguments may contain more calls.
+          continue;
+        }
+      }
+      else if(node.index() == AIR_Node::index_execute_block)
+        do_inline_calls_in_scope(node.mut<AIR_Node::S_execute_block>().code_body, cands, level + 1);
+      else if(node.index() == AIR_Node::index_if_statement) {
+        auto& altr = node.mut<AIR_Node::S_if_statement>();
+        do_inline_calls_in_scope(altr.code_true, cands, level + 1);
+        do_inline_calls_in_scope(altr.code_false, cands, level + 1);
+      }
+      else if(node.index() == AIR_Node::index_switch_statement) {
+        // Clauses share a scope, but one may be entered without the others,
+        // so names from other clauses are ignored.
+        auto& altr = node.mut<AIR_Node::S_switch_statement>();
+        for(size_t i = 0;  i < altr.clauses.size();  ++i) {
+          do_inline_calls(altr.clauses.mut(i).code_label, cands, level);
+          do_inline_calls_in_scope(altr.clauses.mut(i).code_body, cands, level + 1);
+        }
+      }
+      else if(node.index() == AIR_Node::index_do_while_statement) {
+        auto& altr = node.mut<AIR_Node::S_do_while_statement>();
+        do_inline_calls_in_scope(altr.code_body, cands, level + 1);
+        do_inline_calls(altr.code_cond, cands, level);
+      }
+      else if(node.index() == AIR_Node::index_while_statement) {
+        auto& altr = node.mut<AIR_Node::S_while_statement>();
+        do_inline_calls(altr.code_cond, cands, level);
+        do_inline_calls_in_scope(altr.code_body, cands, level + 1);
+      }
+      else if(node.index() == AIR_Node::index_for_each_statement) {
+        auto& altr = node.mut<AIR_Node::S_for_each_statement>();
+        size_t mark = cands.size();
+        do_inline_calls(altr.code_init, cands, level + 1);
+        do_inline_calls_in_scope(altr.code_body, cands, level + 2);
+        cands.erase(mark);
+      }
+      else if(node.index() == AIR_Node::index_for_statement) {
+        auto& altr = node.mut<AIR_Node::S_for_statement>();
+        size_t mark = cands.size();
+        do_inline_calls(altr.code_init, cands, level + 1);
+        do_inline_calls(altr.code_cond, cands, level + 1);
+        do_inline_calls(altr.code_step, cands, level + 1);
+        do_inline_calls_in_scope(altr.code_body, cands, level + 2);
+        cands.erase(mark);
+      }
+      else if(node.index() == AIR_Node::index_try_statement) {
+        auto& altr = node.mut<AIR_Node::S_try_statement>();
+        do_inline_calls_in_scope(altr.code_try, cands, level + 1);
+        do_inline_calls_in_scope(altr.code_catch, cands, level + 1);
+      }
+      else if(node.index() == AIR_Node::index_branch_expression) {
+        auto& altr = node.mut<AIR_Node::S_branch_expression>();
+        do_inline_calls(altr.code_true, cands, level);
+        do_inline_calls(altr.code_false, cands, level);
+      }
+      else if(node.index() == AIR_Node::index_coalesce_expression)
+        do_inline_calls(node.mut<AIR_Node::S_coalesce_expression>().code_null, cands, level);
+      else if(node.index() == AIR_Node::index_catch_expression)
+        do_inline_calls(node.mut<AIR_Node::S_catch_expression>().code_body, cands, level);
+
+      // Deferred expressions are evaluated when the scope exits, after names
+      // in it may have been redeclared, so they are left alone. Closures have
+      // been optimized when they were generated.
+      k ++;
+    }
+  }
+
+bool
+do_is_reference_escaping(const cow_vector<AIR_Node>& code, size_t kpush, bool tail_escapes)
+  {
+    // Follow the reference that is pushed by `code[kpush]` until it is read
+    // or converted to a temporary value. `depth` is its distance from the top
+    // of the stack. Anything that may bind it to another name, or pass it to
+    // another function, is considered an escape.
+    uint32_t depth = 0;
+
+    for(size_t k = kpush + 1;  k < code.size();  ++k) {
+      const auto& node = code.at(k);
+      switch(node.index())
+        {
+        case AIR_Node::index_clear_stack:
+        case AIR_Node::index_execute_block:
+        case AIR_Node::index_if_statement:
+        case AIR_Node::index_switch_statement:
+        case AIR_Node::index_do_while_statement:
+        case AIR_Node::index_while_statement:
+        case AIR_Node::index_for_each_statement:
+        case AIR_Node::index_for_statement:
+        case AIR_Node::index_try_statement:
+        case AIR_Node::index_throw_statement:
+        case AIR_Node::index_assert_statement:
+        case AIR_Node::index_simple_status:
+        case AIR_Node::index_return_statement_bi32:
+          // The stack is only read or discarded.
+          return false;
+
+        case AIR_Node::index_define_null_variable:
+        case AIR_Node::index_single_step_trap:
+        case AIR_Node::index_alt_clear_stack:
+        case AIR_Node::index_member_access:
+        case AIR_Node::index_coalesce_expression:
+          // The stack is not affected, or the reference may be left on the top.
+          continue;
+
+        case AIR_Node::index_declare_variable:
+        case AIR_Node::index_push_global_reference:
+        case AIR_Node::index_push_local_reference:
+        case AIR_Node::index_push_bound_reference:
+        case AIR_Node::index_push_captured_reference:
+        case AIR_Node::index_define_function:
+        case AIR_Node::index_catch_expression:
+        case AIR_Node::index_push_constant:
+          depth ++;
+          continue;
+
+        case AIR_Node::index_check_argument:
+          if(depth != 0)
+            continue;
+
+          return node.as<AIR_Node::S_check_argument>().by_ref;
+
+        case AIR_Node::index_initialize_variable:
+          if(depth == 0)
+            return false;
+          else if(depth == 1)
+            return true;
+
+          depth -= 2;
+          continue;
+
+        case AIR_Node::index_unpack_array:
+        case AIR_Node::index_unpack_object:
+          {
+            uint32_t nvars = (node.index() == AIR_Node::index_unpack_array)
+                               ? node.as<AIR_Node::S_unpack_array>().nelems
+                               : (uint32_t) node.as<AIR_Node::S_unpack_object>().keys.size();
+            if(depth == 0)
+              return false;
+            else if(depth <= nvars)
+              return true;
+
+            depth -= nvars + 1;
+            continue;
+          }
+
+        case AIR_Node::index_push_unnamed_array:
+        case AIR_Node::index_push_unnamed_object:
+          {
+            uint32_t nelems = (node.index() == AIR_Node::index_push_unnamed_array)
+                                ? node.as<AIR_Node::S_push_unnamed_array>().nelems
+                                : (uint32_t) node.as<AIR_Node::S_push_unnamed_object>().keys.size();
+            if(depth < nelems)
+              return false;
+
+            depth = depth + 1 - nelems;
+            continue;
+          }
+
+        case AIR_Node::index_apply_operator:
+          {
+            const auto& altr = node.as<AIR_Node::S_apply_operator>();
+            uint32_t nops = do_get_operator_arity(altr.xop);
+            if(depth >= nops) {
+              depth -= nops - 1;
+              continue;
+            }
+
+            // Operands other than the first one are always read.
+            if((depth != nops - 1) || !do_is_operator_result_aliased(altr.xop, altr.assign))
+              return false;
+
+            depth = 0;
+            continue;
+          }
+
+        case AIR_Node::index_apply_operator_bi32:
+          {
+            const auto& altr = node.as<AIR_Node::S_apply_operator_bi32>();
+            if((depth != 0) || do_is_operator_result_aliased(altr.xop, altr.assign))
+              continue;
+
+            return false;
+          }
+
+        case AIR_Node::index_branch_expression:
+          {
+            // If either branch is empty, the condition may become the result.
+            const auto& altr = node.as<AIR_Node::S_branch_expression>();
+            if(depth != 0)
+              continue;
+
+            return altr.assign || altr.code_true.empty() || altr.code_false.empty();
+          }
+
+        case AIR_Node::index_return_statement:
+          {
+            const auto& altr = node.as<AIR_Node::S_return_statement>();
+            return (depth == 0) && !altr.is_void && altr.by_ref;
+          }
+
+        case AIR_Node::index_function_call:
+          {
+            // Both the target function and arguments may be bound to parameters.
+            uint32_t nargs = node.as<AIR_Node::S_function_call>().nargs;
+            if(depth <= nargs)
+              return true;
+
+            depth -= nargs;
+            continue;
+          }
+
+        case AIR_Node::index_import_call:
+          {
+            uint32_t nargs = node.as<AIR_Node::S_import_call>().nargs;
+            if(depth < nargs)
+              return true;
+
+            depth -= nargs - 1;
+            continue;
+          }
+
+        case AIR_Node::index_inline_call:
+          {
+            // Arguments are bound to parameters.
+            uint32_t nargs = (uint32_t) node.as<AIR_Node::S_inline_call>().params.size();
+            if(depth < nargs)
+              return true;
+
+            depth -= nargs - 1;
+            continue;
+          }
+
+        case AIR_Node::index_variadic_call:
+        case AIR_Node::index_alt_function_call:
+        case AIR_Node::index_declare_reference:
+        case AIR_Node::index_initialize_reference:
+        case AIR_Node::index_defer_expression:
+          return true;
+
+        default:
+          ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), node.index());
+      }
+    }
+
+    // The reference is left on the stack. Whether it is used as a reference
+    // depends on the enclosing node.
+    return tail_escapes;
+  }
+
+void
+do_collect_referenced_names(cow_vector<phsh_string>& names, const cow_vector<AIR_Node>& code)
+  {
+    for(size_t k = 0;  k < code.size();  ++k) {
+      const auto& node = code.at(k);
+      const phsh_string* qname = nullptr;
+
+      if(node.index() == AIR_Node::index_push_local_reference)
+        qname = &(node.as<AIR_Node::S_push_local_reference>().name);
+      else if(node.index() == AIR_Node::index_push_global_reference)
+        qname = &(node.as<AIR_Node::S_push_global_reference>().name);
+      else if(node.index() == AIR_Node::index_define_function)
+        do_collect_referenced_names(names, node.as<AIR_Node::S_define_function>().code_body);
+
+      if(qname && !find(names, *qname))
+        names.emplace_back(*qname);
+
+      AIR_Node temp = node;
+      do_for_each_subcode(temp,
+          [&](const cow_vector<AIR_Node>& sub) { do_collect_referenced_names(names, sub);  });
+    }
+  }
+
+void
+do_collect_escaping_names(cow_vector<phsh_string>& names, const cow_vector<AIR_Node>& code,
+                          bool tail_escapes)
+  {
+    for(size_t k = 0;  k < code.size();  ++k) {
+      const auto& node = code.at(k);
+
+      if(node.index() == AIR_Node::index_push_local_reference) {
+        // Check whether this reference may outlive the expression.
+        const auto& altr = node.as<AIR_Node::S_push_local_reference>();
+        if(!find(names, altr.name) && do_is_reference_escaping(code, k, tail_escapes))
+          names.emplace_back(altr.name);
+      }
+      else if(node.index() == AIR_Node::index_define_function) {
+        // Everything that a closure refers to may be captured.
+        do_collect_referenced_names(names, node.as<AIR_Node::S_define_function>().code_body);
+      }
+
+      // The results of branches, null coalescence and range initializers of
+      // for-each loops are references.
+      AIR_Node temp = node;
+      do_for_each_subcode(temp,
+          [&](const cow_vector<AIR_Node>& sub) {
+            bool sub_tail = (temp.index() == AIR_Node::index_branch_expression)
+                            || (temp.index() == AIR_Node::index_coalesce_expression)
+                            || ((temp.index() == AIR_Node::index_for_each_statement)
+                                && (&sub == &(temp.as<AIR_Node::S_for_each_statement>().code_init)));
+            do_collect_escaping_names(names, sub, sub_tail);
+          });
+    }
+  }
+
+void
+do_mark_foreign_variables(cow_vector<AIR_Node>& code, const cow_vector<phsh_string>& names)
+  {
+    for(size_t k = 0;  k < code.size();  ++k)
+      do_for_each_subcode(code.mut(k),
+          [&](cow_vector<AIR_Node>& sub) { do_mark_foreign_variables(sub, names);  });
+
+    for(size_t k = 0;  k < code.size();  ++k)
+      if(code.at(k).index() == AIR_Node::index_declare_variable) {
+        auto& altr = code.mut(k).mut<AIR_Node::S_declare_variable>();
+        altr.foreign = !find(names, altr.name);
+      }
+      else if(code.at(k).index() == AIR_Node::index_define_null_variable) {
+        auto& altr = code.mut(k).mut<AIR_Node::S_define_null_variable>();
+        altr.foreign = !find(names, altr.name);
+      }
+  }
+
+}  // namespace
 
 AIR_Optimizer::
 ~AIR_Optimizer()
@@ -31,22 +1233,73 @@ reload(const Abstract_Context* ctx_opt, const cow_vector<phsh_string>& params,
   {
     this->m_code.clear();
     this->m_params = params;
+    this->m_stats = { };
 
     if(stmts.empty())
       return;
 
     // Generate code for the function body.
-    Analytic_Context ctx_func(xtc_function, ctx_opt, this->m_params);
+    uint32_t count;
+    {
+      Compiler_Phase_Meter meter(compiler_phase_generation);
+      Analytic_Context ctx_func(xtc_function, ctx_opt, this->m_params);
 
-    for(size_t i = 0;  i < stmts.size();  ++i)
-      stmts.at(i).generate_code(this->m_code, ctx_func, nullptr, global, this->m_opts,
-                           ((i != stmts.size() - 1) && !stmts.at(i + 1).is_empty_return())
-                             ? ptc_aware_none : ptc_aware_void);
+      for(size_t i = 0;  i < stmts.size();  ++i)
+        stmts.at(i).generate_code(this->m_code, ctx_func, nullptr, global, this->m_opts,
+                             ((i != stmts.size() - 1) && !stmts.at(i + 1).is_empty_return())
+                               ? ptc_aware_none : ptc_aware_void);
 
-    if(this->m_opts.optimization_level <= 0)
-      return;
+      count = do_count_nodes(this->m_code);
+      meter.add_count(count);
+    }
+
+    Compiler_Phase_Meter meter(compiler_phase_optimization);
+    this->m_stats.nodes_generated = count;
 
-    // TODO: Insert optimization passes
+    if((this->m_opts.optimization_level >= 2) && !this->m_opts.verbose_single_step_traps
+       && !global.get_hooks_opt()) {
+      // Inlined calls are invisible to hooks, so nothing is inlined if hooks
+      // have been installed, or are expected to see everything.
+      cow_vector<Inline_Candidate> cands;
+      do_inline_calls(this->m_code, cands, 0);
+      count = do_count_nodes(this->m_code);
+    }
+    this->m_stats.nodes_after_inlining = count;
+
+    if(this->m_opts.optimization_level >= 1) {
+      do_fold_constants(this->m_code);
+      count = do_count_nodes(this->m_code);
+    }
+    this->m_stats.nodes_after_constant_folding = count;
+
+    if(this->m_opts.optimization_level >= 2) {
+      do_fold_branches(this->m_code);
+      count = do_count_nodes(this->m_code);
+    }
+    this->m_stats.nodes_after_branch_folding = count;
+
+    if(this->m_opts.optimization_level >= 1) {
+      do_eliminate_dead_code(this->m_code);
+      count = do_count_nodes(this->m_code);
+    }
+    this->m_stats.nodes_after_dead_code_elimination = count;
+
+    if(this->m_opts.optimization_level >= 2) {
+      do_remove_empty_blocks(this->m_code);
+      count = do_count_nodes(this->m_code);
+    }
+    this->m_stats.nodes_after_empty_block_removal = count;
+
+    if(this->m_opts.optimization_level >= 1) {
+      // Variables whose references never escape from expressions, and which
+      // are not captured by any closure, can't be part of reference cycles, so
+      // they needn't be tracked by the garbage collector.
+      cow_vector<phsh_string> escaping;
+      do_collect_escaping_names(escaping, this->m_code, false);
+      do_mark_foreign_variables(this->m_code, escaping);
+    }
+
+    meter.add_count(count);
   }
 
 void
@@ -72,27 +1325,11 @@ cow_function
 AIR_Optimizer::
 create_function(const Source_Location& sloc, cow_stringR name)
   {
-    cow_string func = name;
-    if(is_cmask(func.front(), cmask_namei) && is_cmask(func.back(), cmask_namei | cmask_digit)) {
-      // If `name` looks like a function name, append the parameter list
-      // to form a function signature.
-      func << "(";
-      uint32_t tid = 0;
-      switch(this->m_params.size())
-        {
-          do {
-            func << ", ";  // fallthrough
-        default:
-            func << this->m_params[tid];
-          } while(++ tid != this->m_params.size());  // fallthrough
-        case 0:
-          break;
-      }
-      func << ")";
-    }
-
-    // Instantiate the function object now.
-    return ::rocket::make_refcnt<Instantiated_Function>(sloc, func, this->m_params, this->m_code);
+    // Instantiate the function object now. As nothing is captured, the
+    // template is not shared.
+    auto templ = ::rocket::make_refcnt<Instantiated_Function::Template>(sloc, name,
+                                                                      this->m_params, this->m_code);
+    return ::rocket::make_refcnt<Instantiated_Function>(templ, cow_vector<Reference>());
   }
 
 }  // namespace asteria
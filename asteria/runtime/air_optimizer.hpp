@@ -9,10 +9,24 @@ namespace asteria {
 
 class AIR_Optimizer
   {
+  public:
+    // These are numbers of nodes after each optimization pass. Passes that
+    // are not enabled by the optimization level leave their counts unchanged.
+    struct Statistics
+      {
+        uint32_t nodes_generated = 0;
+        uint32_t nodes_after_inlining = 0;
+        uint32_t nodes_after_constant_folding = 0;
+        uint32_t nodes_after_branch_folding = 0;
+        uint32_t nodes_after_dead_code_elimination = 0;
+        uint32_t nodes_after_empty_block_removal = 0;
+      };
+
   private:
     Compiler_Options m_opts;
     cow_vector<phsh_string> m_params;
     cow_vector<AIR_Node> m_code;
+    Statistics m_stats;
 
   public:
     explicit constexpr AIR_Optimizer(const Compiler_Options& opts) noexcept
@@ -54,6 +68,11 @@ class AIR_Optimizer
     void
     clear() noexcept;
 
+    // Get statistics about the last call to `reload()`.
+    const Statistics&
+    get_statistics() const noexcept
+      { return this->m_stats;  }
+
     // This function performs code generation.
     // `ctx_opt` is the parent context of this closure.
     void
@@ -0,0 +1,1231 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "../xprecompiled.hpp"
+#include "air_serializer.hpp"
+#include "air_node.hpp"
+#include "enums.hpp"
+#include "global_context.hpp"
+#include "../utils.hpp"
+#include <openssl/sha.h>
+namespace asteria {
+namespace {
+
+// This is increased whenever the format changes.
+constexpr char s_magic[8] = { '\x7F', 'A', 'S', 'T', 'A', 'I', 'R', '\n' };
+constexpr uint32_t s_format_version = 1;
+
+struct Writer
+  {
+    cow_string body;
+    cow_dictionary<uint32_t> str_index;
+    cow_vector<cow_string> strs;
+
+    void
+    put_u8(uint8_t val)
+      {
+        this->body.push_back(static_cast<char>(val));
+      }
+
+    void
+    put_uint(uint64_t val)
+      {
+        // Use LEB128 encoding.
+        while(val >= 0x80) {
+          this->put_u8(static_cast<uint8_t>(val | 0x80));
+          val >>= 7;
+        }
+        this->put_u8(static_cast<uint8_t>(val));
+      }
+
+    void
+    put_sint(int64_t val)
+      {
+        // Use zigzag encoding, so small negative numbers are short.
+        this->put_uint((static_cast<uint64_t>(val) << 1) ^ static_cast<uint64_t>(val >> 63));
+      }
+
+    void
+    put_real(double val)
+      {
+        uint64_t bits;
+        ::memcpy(&bits, &val, sizeof(bits));
+        for(uint32_t k = 0;  k != 8;  ++k)
+          this->put_u8(static_cast<uint8_t>(bits >> k * 8));
+      }
+
+    void
+    put_string(cow_stringR str)
+      {
+        uint32_t index = static_cast<uint32_t>(this->strs.size());
+        auto result = this->str_index.try_emplace(phsh_string(str), index);
+        if(result.second)
+          this->strs.emplace_back(str);
+        this->put_uint(result.first->second);
+      }
+
+    void
+    put_sloc(const Source_Location& sloc)
+      {
+        this->put_string(sloc.file());
+        this->put_sint(sloc.line());
+        this->put_sint(sloc.column());
+      }
+
+    void
+    put_opts(const Compiler_Options& opts)
+      {
+        this->put_u8(opts.version);
+        this->put_u8(opts.escapable_single_quotes);
+        this->put_u8(opts.keywords_as_identifiers);
+        this->put_u8(opts.integers_as_reals);
+        this->put_u8(opts.proper_tail_calls);
+        this->put_u8(opts.verbose_single_step_traps);
+        this->put_u8(opts.implicit_global_names);
+        this->put_u8(opts.optimization_level);
+        this->put_u8(opts.lazy_function_bodies);
+      }
+
+    void
+    put_names(const cow_vector<phsh_string>& names)
+      {
+        this->put_uint(names.size());
+        for(const auto& name : names)
+          this->put_string(name.rdstr());
+      }
+
+    bool
+    put_value(const Value& val);
+
+    bool
+    put_code(const cow_vector<AIR_Node>& code);
+
+    bool
+    put_node(const AIR_Node& node);
+  };
+
+bool
+Writer::
+put_value(const Value& val)
+  {
+    this->put_u8(val.type());
+
+    switch(val.type())
+      {
+      case type_null:
+        return true;
+
+      case type_boolean:
+        this->put_u8(val.as_boolean());
+        return true;
+
+      case type_integer:
+        this->put_sint(val.as_integer());
+        return true;
+
+      case type_real:
+        this->put_real(val.as_real());
+        return true;
+
+      case type_string:
+        this->put_string(val.as_string());
+        return true;
+
+      case type_opaque:
+      case type_function:
+        return false;
+
+      case type_array:
+        this->put_uint(val.as_array().size());
+        for(const auto& elem : val.as_array())
+          if(!this->put_value(elem))
+            return false;
+        return true;
+
+      case type_object:
+        this->put_uint(val.as_object().size());
+        for(const auto& pair : val.as_object()) {
+          this->put_string(pair.first.rdstr());
+          if(!this->put_value(pair.second))
+            return false;
+        }
+        return true;
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), val.type());
+    }
+  }
+
+bool
+Writer::
+put_code(const cow_vector<AIR_Node>& code)
+  {
+    this->put_uint(code.size());
+    for(const auto& node : code)
+      if(!this->put_node(node))
+        return false;
+    return true;
+  }
+
+bool
+Writer::
+put_node(const AIR_Node& node)
+  {
+    this->put_u8(node.index());
+
+    switch(node.index())
+      {
+      case AIR_Node::index_clear_stack:
+        return true;
+
+      case AIR_Node::index_execute_block:
+        {
+          const auto& altr = node.as<AIR_Node::S_execute_block>();
+          return this->put_code(altr.code_body);
+        }
+
+      case AIR_Node::index_declare_variable:
+        {
+          const auto& altr = node.as<AIR_Node::S_declare_variable>();
+          this->put_sloc(altr.sloc);
+          this->put_string(altr.name.rdstr());
+          this->put_u8(altr.foreign);
+          return true;
+        }
+
+      case AIR_Node::index_initialize_variable:
+        {
+          const auto& altr = node.as<AIR_Node::S_initialize_variable>();
+          this->put_sloc(altr.sloc);
+          this->put_u8(altr.immutable);
+          return true;
+        }
+
+      case AIR_Node::index_if_statement:
+        {
+          const auto& altr = node.as<AIR_Node::S_if_statement>();
+          this->put_u8(altr.negative);
+          return this->put_code(altr.code_true)
+                 && this->put_code(altr.code_false);
+        }
+
+      case AIR_Node::index_switch_statement:
+        {
+          const auto& altr = node.as<AIR_Node::S_switch_statement>();
+          this->put_uint(altr.clauses.size());
+          for(const auto& clause : altr.clauses) {
+            this->put_names(clause.names_added);
+            if(!this->put_code(clause.code_label) || !this->put_code(clause.code_body))
+              return false;
+          }
+          return true;
+        }
+
+      case AIR_Node::index_do_while_statement:
+        {
+          const auto& altr = node.as<AIR_Node::S_do_while_statement>();
+          this->put_u8(altr.negative);
+          return this->put_code(altr.code_body)
+                 && this->put_code(altr.code_cond);
+        }
+
+      case AIR_Node::index_while_statement:
+        {
+          const auto& altr = node.as<AIR_Node::S_while_statement>();
+          this->put_u8(altr.negative);
+          return this->put_code(altr.code_cond)
+                 && this->put_code(altr.code_body);
+        }
+
+      case AIR_Node::index_for_each_statement:
+        {
+          const auto& altr = node.as<AIR_Node::S_for_each_statement>();
+          this->put_string(altr.name_key.rdstr());
+          this->put_string(altr.name_mapped.rdstr());
+          this->put_sloc(altr.sloc_init);
+          return this->put_code(altr.code_init)
+                 && this->put_code(altr.code_body);
+        }
+
+      case AIR_Node::index_for_statement:
+        {
+          const auto& altr = node.as<AIR_Node::S_for_statement>();
+          return this->put_code(altr.code_init)
+                 && this->put_code(altr.code_cond)
+                 && this->put_code(altr.code_step)
+                 && this->put_code(altr.code_body);
+        }
+
+      case AIR_Node::index_try_statement:
+        {
+          const auto& altr = node.as<AIR_Node::S_try_statement>();
+          this->put_sloc(altr.sloc_try);
+          this->put_sloc(altr.sloc_catch);
+          this->put_string(altr.name_except.rdstr());
+          return this->put_code(altr.code_try)
+                 && this->put_code(altr.code_catch);
+        }
+
+      case AIR_Node::index_throw_statement:
+        {
+          const auto& altr = node.as<AIR_Node::S_throw_statement>();
+          this->put_sloc(altr.sloc);
+          return true;
+        }
+
+      case AIR_Node::index_assert_statement:
+        {
+          const auto& altr = node.as<AIR_Node::S_assert_statement>();
+          this->put_sloc(altr.sloc);
+          this->put_string(altr.msg);
+          return true;
+        }
+
+      case AIR_Node::index_simple_status:
+        {
+          const auto& altr = node.as<AIR_Node::S_simple_status>();
+          this->put_u8(altr.status);
+          return true;
+        }
+
+      case AIR_Node::index_check_argument:
+        {
+          const auto& altr = node.as<AIR_Node::S_check_argument>();
+          this->put_sloc(altr.sloc);
+          this->put_u8(altr.by_ref);
+          return true;
+        }
+
+      case AIR_Node::index_push_global_reference:
+        {
+          const auto& altr = node.as<AIR_Node::S_push_global_reference>();
+          this->put_sloc(altr.sloc);
+          this->put_string(altr.name.rdstr());
+          return true;
+        }
+
+      case AIR_Node::index_push_local_reference:
+        {
+          const auto& altr = node.as<AIR_Node::S_push_local_reference>();
+          this->put_sloc(altr.sloc);
+          this->put_uint(altr.depth);
+          this->put_string(altr.name.rdstr());
+          return true;
+        }
+
+      case AIR_Node::index_push_bound_reference:
+        // Bound references point to variables in memory.
+        return false;
+
+      case AIR_Node::index_define_function:
+        {
+          const auto& altr = node.as<AIR_Node::S_define_function>();
+          if(!altr.lazy_tokens.empty())
+            return false;  // body not parsed
+
+          this->put_opts(altr.opts);
+          this->put_sloc(altr.sloc);
+          this->put_string(altr.func);
+          this->put_names(altr.params);
+          return this->put_code(altr.code_body);
+        }
+
+      case AIR_Node::index_branch_expression:
+        {
+          const auto& altr = node.as<AIR_Node::S_branch_expression>();
+          this->put_sloc(altr.sloc);
+          this->put_u8(altr.assign);
+          return this->put_code(altr.code_true)
+                 && this->put_code(altr.code_false);
+        }
+
+      case AIR_Node::index_function_call:
+        {
+          const auto& altr = node.as<AIR_Node::S_function_call>();
+          this->put_sloc(altr.sloc);
+          this->put_uint(altr.nargs);
+          this->put_u8(altr.ptc);
+          return true;
+        }
+
+      case AIR_Node::index_push_unnamed_array:
+        {
+          const auto& altr = node.as<AIR_Node::S_push_unnamed_array>();
+          this->put_sloc(altr.sloc);
+          this->put_uint(altr.nelems);
+          return true;
+        }
+
+      case AIR_Node::index_push_unnamed_object:
+        {
+          const auto& altr = node.as<AIR_Node::S_push_unnamed_object>();
+          this->put_sloc(altr.sloc);
+          this->put_names(altr.keys);
+          return true;
+        }
+
+      case AIR_Node::index_apply_operator:
+        {
+          const auto& altr = node.as<AIR_Node::S_apply_operator>();
+          this->put_sloc(altr.sloc);
+          this->put_u8(altr.xop);
+          this->put_u8(altr.assign);
+          return true;
+        }
+
+      case AIR_Node::index_unpack_array:
+        {
+          const auto& altr = node.as<AIR_Node::S_unpack_array>();
+          this->put_sloc(altr.sloc);
+          this->put_u8(altr.immutable);
+          this->put_uint(altr.nelems);
+          return true;
+        }
+
+      case AIR_Node::index_unpack_object:
+        {
+          const auto& altr = node.as<AIR_Node::S_unpack_object>();
+          this->put_sloc(altr.sloc);
+          this->put_u8(altr.immutable);
+          this->put_names(altr.keys);
+          return true;
+        }
+
+      case AIR_Node::index_define_null_variable:
+        {
+          const auto& altr = node.as<AIR_Node::S_define_null_variable>();
+          this->put_sloc(altr.sloc);
+          this->put_u8(altr.immutable);
+          this->put_string(altr.name.rdstr());
+          this->put_u8(altr.foreign);
+          return true;
+        }
+
+      case AIR_Node::index_single_step_trap:
+        {
+          const auto& altr = node.as<AIR_Node::S_single_step_trap>();
+          this->put_sloc(altr.sloc);
+          return true;
+        }
+
+      case AIR_Node::index_variadic_call:
+        {
+          const auto& altr = node.as<AIR_Node::S_variadic_call>();
+          this->put_sloc(altr.sloc);
+          this->put_u8(altr.ptc);
+          return true;
+        }
+
+      case AIR_Node::index_defer_expression:
+        {
+          const auto& altr = node.as<AIR_Node::S_defer_expression>();
+          this->put_sloc(altr.sloc);
+          return this->put_code(altr.code_body);
+        }
+
+      case AIR_Node::index_import_call:
+        {
+          const auto& altr = node.as<AIR_Node::S_import_call>();
+          this->put_opts(altr.opts);
+          this->put_sloc(altr.sloc);
+          this->put_uint(altr.nargs);
+          return true;
+        }
+
+      case AIR_Node::index_declare_reference:
+        {
+          const auto& altr = node.as<AIR_Node::S_declare_reference>();
+          this->put_string(altr.name.rdstr());
+          return true;
+        }
+
+      case AIR_Node::index_initialize_reference:
+        {
+          const auto& altr = node.as<AIR_Node::S_initialize_reference>();
+          this->put_sloc(altr.sloc);
+          this->put_string(altr.name.rdstr());
+          return true;
+        }
+
+      case AIR_Node::index_catch_expression:
+        {
+          const auto& altr = node.as<AIR_Node::S_catch_expression>();
+          return this->put_code(altr.code_body);
+        }
+
+      case AIR_Node::index_return_statement:
+        {
+          const auto& altr = node.as<AIR_Node::S_return_statement>();
+          this->put_sloc(altr.sloc);
+          this->put_u8(altr.by_ref);
+          this->put_u8(altr.is_void);
+          return true;
+        }
+
+      case AIR_Node::index_push_constant:
+        {
+          const auto& altr = node.as<AIR_Node::S_push_constant>();
+          return this->put_value(altr.val);
+        }
+
+      case AIR_Node::index_alt_clear_stack:
+        return true;
+
+      case AIR_Node::index_alt_function_call:
+        {
+          const auto& altr = node.as<AIR_Node::S_alt_function_call>();
+          this->put_sloc(altr.sloc);
+          this->put_u8(altr.ptc);
+          return true;
+        }
+
+      case AIR_Node::index_coalesce_expression:
+        {
+          const auto& altr = node.as<AIR_Node::S_coalesce_expression>();
+          this->put_sloc(altr.sloc);
+          this->put_u8(altr.assign);
+          return this->put_code(altr.code_null);
+        }
+
+      case AIR_Node::index_member_access:
+        {
+          const auto& altr = node.as<AIR_Node::S_member_access>();
+          this->put_sloc(altr.sloc);
+          this->put_string(altr.key.rdstr());
+          return true;
+        }
+
+      case AIR_Node::index_apply_operator_bi32:
+        {
+          const auto& altr = node.as<AIR_Node::S_apply_operator_bi32>();
+          this->put_sloc(altr.sloc);
+          this->put_u8(altr.xop);
+          this->put_u8(altr.assign);
+          this->put_sint(altr.irhs);
+          return true;
+        }
+
+      case AIR_Node::index_return_statement_bi32:
+        {
+          const auto& altr = node.as<AIR_Node::S_return_statement_bi32>();
+          this->put_sloc(altr.sloc);
+          this->put_u8(altr.type);
+          this->put_sint(altr.irhs);
+          return true;
+        }
+
+      case AIR_Node::index_push_captured_reference:
+        {
+          const auto& altr = node.as<AIR_Node::S_push_captured_reference>();
+          this->put_sloc(altr.sloc);
+          this->put_uint(altr.index);
+          this->put_string(altr.name.rdstr());
+          return true;
+        }
+
+      case AIR_Node::index_inline_call:
+        {
+          const auto& altr = node.as<AIR_Node::S_inline_call>();
+          this->put_sloc(altr.sloc);
+          this->put_string(altr.func);
+          this->put_sloc(altr.sloc_func);
+          this->put_names(altr.params);
+          this->put_u8(altr.by_ref);
+          return this->put_code(altr.code_body);
+        }
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), node.index());
+    }
+  }
+
+// A reader never reads past the end of its data. If the data are malformed,
+// it sets `ok` to `false` and returns zeroes, which terminate all loops.
+struct Reader
+  {
+    const unsigned char* bptr;
+    const unsigned char* eptr;
+    bool ok = true;
+    cow_vector<cow_string> strs;
+    cow_vector<phsh_string> globals;
+
+    uint8_t
+    get_u8()
+      {
+        if(this->bptr == this->eptr)
+          return this->ok = false;
+        return *(this->bptr ++);
+      }
+
+    bool
+    get_bool()
+      {
+        uint8_t val = this->get_u8();
+        if(val > 1)
+          return this->ok = false;
+        return val;
+      }
+
+    uint64_t
+    get_uint()
+      {
+        uint64_t val = 0;
+        for(uint32_t shift = 0;  shift < 64;  shift += 7) {
+          uint8_t byte = this->get_u8();
+          val |= static_cast<uint64_t>(byte & 0x7F) << shift;
+          if(!(byte & 0x80))
+            return val;
+        }
+        return this->ok = false;
+      }
+
+    int64_t
+    get_sint()
+      {
+        uint64_t val = this->get_uint();
+        return static_cast<int64_t>((val >> 1) ^ (0 - (val & 1)));
+      }
+
+    uint32_t
+    get_u32()
+      {
+        uint64_t val = this->get_uint();
+        if(val > UINT32_MAX)
+          return this->ok = false;
+        return static_cast<uint32_t>(val);
+      }
+
+    int
+    get_int()
+      {
+        int64_t val = this->get_sint();
+        if((val < INT_MIN) || (val > INT_MAX))
+          return this->ok = false;
+        return static_cast<int>(val);
+      }
+
+    template<typename xEnum>
+    xEnum
+    get_enum(xEnum max)
+      {
+        uint8_t val = this->get_u8();
+        if(val > max)
+          return static_cast<xEnum>(this->ok = false);
+        return static_cast<xEnum>(val);
+      }
+
+    size_t
+    get_count()
+      {
+        // Each element takes at least one byte, so a count that exceeds the
+        // number of remaining bytes can't be valid.
+        uint64_t val = this->get_uint();
+        if(val > static_cast<uint64_t>(this->eptr - this->bptr))
+          return this->ok = false;
+        return static_cast<size_t>(val);
+      }
+
+    double
+    get_real()
+      {
+        uint64_t bits = 0;
+        for(uint32_t k = 0;  k != 8;  ++k)
+          bits |= static_cast<uint64_t>(this->get_u8()) << k * 8;
+
+        double val;
+        ::memcpy(&val, &bits, sizeof(val));
+        return val;
+      }
+
+    cow_string
+    get_string()
+      {
+        uint64_t index = this->get_uint();
+        if(index >= this->strs.size())
+          return (this->ok = false), cow_string();
+        return this->strs[static_cast<size_t>(index)];
+      }
+
+    phsh_string
+    get_name()
+      {
+        return phsh_string(this->get_string());
+      }
+
+    Source_Location
+    get_sloc()
+      {
+        auto file = this->get_string();
+        int line = this->get_int();
+        int column = this->get_int();
+        return Source_Location(file, line, column);
+      }
+
+    Compiler_Options
+    get_opts()
+      {
+        // Each flag is read as a byte, as other values are not valid for `bool`.
+        Compiler_Options opts;
+        if(this->get_u8() != opts.version)
+          return (this->ok = false), opts;
+
+        opts.escapable_single_quotes = this->get_bool();
+        opts.keywords_as_identifiers = this->get_bool();
+        opts.integers_as_reals = this->get_bool();
+        opts.proper_tail_calls = this->get_bool();
+        opts.verbose_single_step_traps = this->get_bool();
+        opts.implicit_global_names = this->get_bool();
+        opts.optimization_level = this->get_u8();
+        opts.lazy_function_bodies = this->get_bool();
+        return opts;
+      }
+
+    cow_vector<phsh_string>
+    get_names()
+      {
+        cow_vector<phsh_string> names;
+        size_t count = this->get_count();
+        names.reserve(count);
+        for(size_t k = 0;  k != count;  ++k)
+          names.emplace_back(this->get_name());
+        return names;
+      }
+
+    Value
+    get_value();
+
+    cow_vector<AIR_Node>
+    get_code();
+
+    AIR_Node
+    get_node();
+  };
+
+Value
+Reader::
+get_value()
+  {
+    switch(this->get_enum(type_object))
+      {
+      case type_null:
+        return nullopt;
+
+      case type_boolean:
+        return this->get_bool();
+
+      case type_integer:
+        return this->get_sint();
+
+      case type_real:
+        return this->get_real();
+
+      case type_string:
+        return this->get_string();
+
+      case type_opaque:
+      case type_function:
+        return (this->ok = false), nullopt;
+
+      case type_array:
+        {
+          V_array arr;
+          size_t count = this->get_count();
+          arr.reserve(count);
+          for(size_t k = 0;  k != count;  ++k)
+            arr.emplace_back(this->get_value());
+          return arr;
+        }
+
+      case type_object:
+        {
+          V_object obj;
+          size_t count = this->get_count();
+          obj.reserve(count);
+          for(size_t k = 0;  k != count;  ++k) {
+            auto key = this->get_name();
+            obj.insert_or_assign(move(key), this->get_value());
+          }
+          return obj;
+        }
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration"));
+    }
+  }
+
+cow_vector<AIR_Node>
+Reader::
+get_code()
+  {
+    cow_vector<AIR_Node> code;
+    size_t count = this->get_count();
+    code.reserve(count);
+    for(size_t k = 0;  k != count;  ++k)
+      code.emplace_back(this->get_node());
+    return code;
+  }
+
+AIR_Node
+Reader::
+get_node()
+  {
+    switch(this->get_enum(AIR_Node::index_inline_call))
+      {
+      case AIR_Node::index_clear_stack:
+        return AIR_Node::S_clear_stack();
+
+      case AIR_Node::index_execute_block:
+        {
+          AIR_Node::S_execute_block xnode;
+          xnode.code_body = this->get_code();
+          return xnode;
+        }
+
+      case AIR_Node::index_declare_variable:
+        {
+          AIR_Node::S_declare_variable xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.name = this->get_name();
+          xnode.foreign = this->get_bool();
+          return xnode;
+        }
+
+      case AIR_Node::index_initialize_variable:
+        {
+          AIR_Node::S_initialize_variable xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.immutable = this->get_bool();
+          return xnode;
+        }
+
+      case AIR_Node::index_if_statement:
+        {
+          AIR_Node::S_if_statement xnode;
+          xnode.negative = this->get_bool();
+          xnode.code_true = this->get_code();
+          xnode.code_false = this->get_code();
+          return xnode;
+        }
+
+      case AIR_Node::index_switch_statement:
+        {
+          AIR_Node::S_switch_statement xnode;
+          size_t count = this->get_count();
+          xnode.clauses.reserve(count);
+          for(size_t k = 0;  k != count;  ++k) {
+            auto& clause = xnode.clauses.emplace_back();
+            clause.names_added = this->get_names();
+            clause.code_label = this->get_code();
+            clause.code_body = this->get_code();
+          }
+          return xnode;
+        }
+
+      case AIR_Node::index_do_while_statement:
+        {
+          AIR_Node::S_do_while_statement xnode;
+          xnode.negative = this->get_bool();
+          xnode.code_body = this->get_code();
+          xnode.code_cond = this->get_code();
+          return xnode;
+        }
+
+      case AIR_Node::index_while_statement:
+        {
+          AIR_Node::S_while_statement xnode;
+          xnode.negative = this->get_bool();
+          xnode.code_cond = this->get_code();
+          xnode.code_body = this->get_code();
+          return xnode;
+        }
+
+      case AIR_Node::index_for_each_statement:
+        {
+          AIR_Node::S_for_each_statement xnode;
+          xnode.name_key = this->get_name();
+          xnode.name_mapped = this->get_name();
+          xnode.sloc_init = this->get_sloc();
+          xnode.code_init = this->get_code();
+          xnode.code_body = this->get_code();
+          return xnode;
+        }
+
+      case AIR_Node::index_for_statement:
+        {
+          AIR_Node::S_for_statement xnode;
+          xnode.code_init = this->get_code();
+          xnode.code_cond = this->get_code();
+          xnode.code_step = this->get_code();
+          xnode.code_body = this->get_code();
+          return xnode;
+        }
+
+      case AIR_Node::index_try_statement:
+        {
+          AIR_Node::S_try_statement xnode;
+          xnode.sloc_try = this->get_sloc();
+          xnode.sloc_catch = this->get_sloc();
+          xnode.name_except = this->get_name();
+          xnode.code_try = this->get_code();
+          xnode.code_catch = this->get_code();
+          return xnode;
+        }
+
+      case AIR_Node::index_throw_statement:
+        {
+          AIR_Node::S_throw_statement xnode;
+          xnode.sloc = this->get_sloc();
+          return xnode;
+        }
+
+      case AIR_Node::index_assert_statement:
+        {
+          AIR_Node::S_assert_statement xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.msg = this->get_string();
+          return xnode;
+        }
+
+      case AIR_Node::index_simple_status:
+        {
+          AIR_Node::S_simple_status xnode;
+          xnode.status = this->get_enum(air_status_throw);
+          return xnode;
+        }
+
+      case AIR_Node::index_check_argument:
+        {
+          AIR_Node::S_check_argument xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.by_ref = this->get_bool();
+          return xnode;
+        }
+
+      case AIR_Node::index_push_global_reference:
+        {
+          AIR_Node::S_push_global_reference xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.name = this->get_name();
+          this->globals.emplace_back(xnode.name);
+          return xnode;
+        }
+
+      case AIR_Node::index_push_local_reference:
+        {
+          AIR_Node::S_push_local_reference xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.depth = this->get_u32();
+          xnode.name = this->get_name();
+          return xnode;
+        }
+
+      case AIR_Node::index_push_bound_reference:
+        return (this->ok = false), AIR_Node::S_clear_stack();
+
+      case AIR_Node::index_define_function:
+        {
+          AIR_Node::S_define_function xnode;
+          xnode.opts = this->get_opts();
+          xnode.sloc = this->get_sloc();
+          xnode.func = this->get_string();
+          xnode.params = this->get_names();
+          xnode.code_body = this->get_code();
+          return xnode;
+        }
+
+      case AIR_Node::index_branch_expression:
+        {
+          AIR_Node::S_branch_expression xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.assign = this->get_bool();
+          xnode.code_true = this->get_code();
+          xnode.code_false = this->get_code();
+          return xnode;
+        }
+
+      case AIR_Node::index_function_call:
+        {
+          AIR_Node::S_function_call xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.nargs = this->get_u32();
+          xnode.ptc = this->get_enum(ptc_aware_void);
+          return xnode;
+        }
+
+      case AIR_Node::index_push_unnamed_array:
+        {
+          AIR_Node::S_push_unnamed_array xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.nelems = this->get_u32();
+          return xnode;
+        }
+
+      case AIR_Node::index_push_unnamed_object:
+        {
+          AIR_Node::S_push_unnamed_object xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.keys = this->get_names();
+          return xnode;
+        }
+
+      case AIR_Node::index_apply_operator:
+        {
+          AIR_Node::S_apply_operator xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.xop = this->get_enum(xop_isvoid);
+          xnode.assign = this->get_bool();
+          return xnode;
+        }
+
+      case AIR_Node::index_unpack_array:
+        {
+          AIR_Node::S_unpack_array xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.immutable = this->get_bool();
+          xnode.nelems = this->get_u32();
+          return xnode;
+        }
+
+      case AIR_Node::index_unpack_object:
+        {
+          AIR_Node::S_unpack_object xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.immutable = this->get_bool();
+          xnode.keys = this->get_names();
+          return xnode;
+        }
+
+      case AIR_Node::index_define_null_variable:
+        {
+          AIR_Node::S_define_null_variable xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.immutable = this->get_bool();
+          xnode.name = this->get_name();
+          xnode.foreign = this->get_bool();
+          return xnode;
+        }
+
+      case AIR_Node::index_single_step_trap:
+        {
+          AIR_Node::S_single_step_trap xnode;
+          xnode.sloc = this->get_sloc();
+          return xnode;
+        }
+
+      case AIR_Node::index_variadic_call:
+        {
+          AIR_Node::S_variadic_call xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.ptc = this->get_enum(ptc_aware_void);
+          return xnode;
+        }
+
+      case AIR_Node::index_defer_expression:
+        {
+          AIR_Node::S_defer_expression xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.code_body = this->get_code();
+          return xnode;
+        }
+
+      case AIR_Node::index_import_call:
+        {
+          AIR_Node::S_import_call xnode;
+          xnode.opts = this->get_opts();
+          xnode.sloc = this->get_sloc();
+          xnode.nargs = this->get_u32();
+          return xnode;
+        }
+
+      case AIR_Node::index_declare_reference:
+        {
+          AIR_Node::S_declare_reference xnode;
+          xnode.name = this->get_name();
+          return xnode;
+        }
+
+      case AIR_Node::index_initialize_reference:
+        {
+          AIR_Node::S_initialize_reference xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.name = this->get_name();
+          return xnode;
+        }
+
+      case AIR_Node::index_catch_expression:
+        {
+          AIR_Node::S_catch_expression xnode;
+          xnode.code_body = this->get_code();
+          return xnode;
+        }
+
+      case AIR_Node::index_return_statement:
+        {
+          AIR_Node::S_return_statement xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.by_ref = this->get_bool();
+          xnode.is_void = this->get_bool();
+          return xnode;
+        }
+
+      case AIR_Node::index_push_constant:
+        {
+          AIR_Node::S_push_constant xnode;
+          xnode.val = this->get_value();
+          return xnode;
+        }
+
+      case AIR_Node::index_alt_clear_stack:
+        return AIR_Node::S_alt_clear_stack();
+
+      case AIR_Node::index_alt_function_call:
+        {
+          AIR_Node::S_alt_function_call xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.ptc = this->get_enum(ptc_aware_void);
+          return xnode;
+        }
+
+      case AIR_Node::index_coalesce_expression:
+        {
+          AIR_Node::S_coalesce_expression xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.assign = this->get_bool();
+          xnode.code_null = this->get_code();
+          return xnode;
+        }
+
+      case AIR_Node::index_member_access:
+        {
+          AIR_Node::S_member_access xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.key = this->get_name();
+          return xnode;
+        }
+
+      case AIR_Node::index_apply_operator_bi32:
+        {
+          AIR_Node::S_apply_operator_bi32 xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.xop = this->get_enum(xop_isvoid);
+          xnode.assign = this->get_bool();
+          xnode.irhs = this->get_int();
+          return xnode;
+        }
+
+      case AIR_Node::index_return_statement_bi32:
+        {
+          AIR_Node::S_return_statement_bi32 xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.type = this->get_enum(type_object);
+          xnode.irhs = this->get_int();
+          return xnode;
+        }
+
+      case AIR_Node::index_push_captured_reference:
+        {
+          AIR_Node::S_push_captured_reference xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.index = this->get_u32();
+          xnode.name = this->get_name();
+          return xnode;
+        }
+
+      case AIR_Node::index_inline_call:
+        {
+          AIR_Node::S_inline_call xnode;
+          xnode.sloc = this->get_sloc();
+          xnode.func = this->get_string();
+          xnode.sloc_func = this->get_sloc();
+          xnode.params = this->get_names();
+          xnode.by_ref = this->get_bool();
+          xnode.code_body = this->get_code();
+          return xnode;
+        }
+
+      default:
+        ASTERIA_TERMINATE(("Corrupted enumeration"));
+    }
+  }
+
+void
+do_append_header(cow_string& data, const Compiler_Options& opts, cow_stringR source)
+  {
+    // The header consists of the magic number, the format version, the ABI
+    // version, compiler options, and the SHA-256 checksum of the source code.
+    data.append(s_magic, sizeof(s_magic));
+    data.push_back(static_cast<char>(s_format_version));
+    data.append(ASTERIA_ABI_VERSION_STRING, sizeof(ASTERIA_ABI_VERSION_STRING));
+    Writer opts_writer;
+    opts_writer.put_opts(opts);
+    data.append(opts_writer.body);
+
+    unsigned char checksum[SHA256_DIGEST_LENGTH];
+    ::SHA256(reinterpret_cast<const unsigned char*>(source.data()), source.size(), checksum);
+    data.append(reinterpret_cast<const char*>(checksum), sizeof(checksum));
+  }
+
+}  // namespace
+
+bool
+serialize_air(cow_string& data, const Compiler_Options& opts, cow_stringR source,
+              const cow_vector<AIR_Node>& code)
+  {
+    Writer writer;
+    if(!writer.put_code(code))
+      return false;
+
+    data.clear();
+    do_append_header(data, opts, source);
+
+    // Write the string table, followed by nodes.
+    Writer table;
+    table.put_uint(writer.strs.size());
+    for(const auto& str : writer.strs) {
+      table.put_uint(str.size());
+      table.body.append(str);
+    }
+
+    data.append(table.body);
+    data.append(writer.body);
+    return true;
+  }
+
+bool
+deserialize_air(cow_vector<AIR_Node>& code, const Compiler_Options& opts, cow_stringR source,
+                cow_stringR data, const Global_Context* global_opt)
+  {
+    // The header must match exactly.
+    cow_string header;
+    do_append_header(header, opts, source);
+    if((data.size() < header.size()) || (::memcmp(data.data(), header.data(), header.size()) != 0))
+      return false;
+
+    Reader reader;
+    reader.bptr = reinterpret_cast<const unsigned char*>(data.data()) + header.size();
+    reader.eptr = reinterpret_cast<const unsigned char*>(data.data()) + data.size();
+
+    // Read the string table.
+    size_t nstrs = reader.get_count();
+    reader.strs.reserve(nstrs);
+    for(size_t k = 0;  k != nstrs;  ++k) {
+      size_t len = reader.get_count();
+      reader.strs.emplace_back(reinterpret_cast<const char*>(reader.bptr), len);
+      reader.bptr += len;
+    }
+
+    // Read nodes. There shall be no trailing bytes.
+    auto temp = reader.get_code();
+    if(!reader.ok || (reader.bptr != reader.eptr))
+      return false;
+
+    if(global_opt && !opts.implicit_global_names)
+      for(const auto& name : reader.globals)
+        if(!global_opt->get_named_reference_opt(name))
+          return false;
+
+    code = move(temp);
+    return true;
+  }
+
+}  // namespace asteria
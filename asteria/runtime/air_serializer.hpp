@@ -0,0 +1,33 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_RUNTIME_AIR_SERIALIZER_
+#define ASTERIA_RUNTIME_AIR_SERIALIZER_
+
+#include "../fwd.hpp"
+namespace asteria {
+
+// These functions convert AIR nodes of a script to and from a binary format,
+// so compiled scripts can be saved in files and reused by other processes.
+// Strings, names and files of source locations are stored in a table, and
+// each is written only once.
+
+// Serializes `code`, which has been compiled from `source` with `opts`. The
+// hash of `source` is stored, so stale data can be detected. Code that holds
+// bound references, opaque values, functions or function bodies that have not
+// been parsed can't be serialized, in which case `false` is returned.
+bool
+serialize_air(cow_string& data, const Compiler_Options& opts, cow_stringR source,
+              const cow_vector<AIR_Node>& code);
+
+// Deserializes `code`. If `data` is corrupted, or has been produced by another
+// version, from another source or with other options, `false` is returned. If
+// `global_opt` is not null and implicit global names are disallowed, global
+// names that can't be resolved also cause `false` to be returned, so the code
+// can be compiled again to get an error.
+bool
+deserialize_air(cow_vector<AIR_Node>& code, const Compiler_Options& opts, cow_stringR source,
+                cow_stringR data, const Global_Context* global_opt);
+
+}  // namespace asteria
+#endif
@@ -7,6 +7,20 @@
 #include "../utils.hpp"
 namespace asteria {
 
+namespace {
+
+constexpr char s_param_names[][12] =
+  {
+    "",
+    "[reference]", "[value]", "[boolean]", "[integer]", "[real]", "[string]",
+    "[opaque]", "[function]", "[array]", "[object]",
+    "boolean", "integer", "real", "string", "opaque", "function", "array",
+    "object",
+    "...",
+  };
+
+}  // namespace
+
 Argument_Reader::
 ~Argument_Reader()
   {
@@ -14,15 +28,17 @@ Argument_Reader::
 
 void
 Argument_Reader::
-do_prepare_parameter(const char* param)
+do_prepare_parameter(Param param)
   {
     // Ensure `end_overload()` has not been called for this overload.
     if(this->m_state.finish)
       throw Runtime_Error(xtc_format,
                "Current overload marked ended");
 
-    // Append the parameter.
-    this->m_state.params << param << ", ";
+    // Record the parameter. It is only used for composing error messages.
+    if(this->m_state.params.size() < this->m_state.params.capacity())
+      this->m_state.params.push_back(param);
+
     this->m_state.nparams ++;
   }
 
@@ -35,10 +51,18 @@ do_terminate_parameter_list()
       throw Runtime_Error(xtc_format,
                "Current overload marked ended");
 
-    // Mark this overload complete. The terminating ", " shall be dropped.
+    // Mark this overload complete. If some of its parameters have not been
+    // recorded, or there is no room for it, it will be omitted from error
+    // messages, instead of being printed with a wrong signature.
     this->m_state.finish = true;
-    this->m_overloads.append(this->m_state.params, 0, this->m_state.params.size() - 2);
-    this->m_overloads.push_back('|');
+    if((this->m_state.nparams > this->m_state.params.size())
+       || (this->m_overloads.size() + this->m_state.params.size() >= this->m_overloads.capacity())) {
+      this->m_overloads_omitted = true;
+      return;
+    }
+
+    this->m_overloads.append(this->m_state.params.begin(), this->m_state.params.end());
+    this->m_overloads.push_back(param_end);
   }
 
 void
@@ -77,6 +101,10 @@ Argument_Reader::
 save_state(uint32_t index)
   {
     // Reserve a slot.
+    if(index >= this->m_saved_states.capacity())
+      throw Runtime_Error(xtc_format,
+               "Parser state index `$1` out of range", index);
+
     while(index >= this->m_saved_states.size())
       this->m_saved_states.emplace_back();
 
@@ -98,7 +126,7 @@ Argument_Reader::
 optional(Reference& out)
   {
     out.clear();
-    this->do_prepare_parameter("[reference]");
+    this->do_prepare_parameter(param_opt_ref);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -113,7 +141,7 @@ Argument_Reader::
 optional(Value& out)
   {
     out = nullopt;
-    this->do_prepare_parameter("[value]");
+    this->do_prepare_parameter(param_opt_val);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -128,7 +156,7 @@ Argument_Reader::
 optional(optV_boolean& out)
   {
     out = nullopt;
-    this->do_prepare_parameter("[boolean]");
+    this->do_prepare_parameter(param_opt_bool);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -150,7 +178,7 @@ Argument_Reader::
 optional(optV_integer& out)
   {
     out = nullopt;
-    this->do_prepare_parameter("[integer]");
+    this->do_prepare_parameter(param_opt_int);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -172,7 +200,7 @@ Argument_Reader::
 optional(optV_real& out)
   {
     out = nullopt;
-    this->do_prepare_parameter("[real]");
+    this->do_prepare_parameter(param_opt_real);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -194,7 +222,7 @@ Argument_Reader::
 optional(optV_string& out)
   {
     out = nullopt;
-    this->do_prepare_parameter("[string]");
+    this->do_prepare_parameter(param_opt_str);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -216,7 +244,7 @@ Argument_Reader::
 optional(optV_opaque& out)
   {
     out = nullptr;
-    this->do_prepare_parameter("[opaque]");
+    this->do_prepare_parameter(param_opt_opaq);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -238,7 +266,7 @@ Argument_Reader::
 optional(optV_function& out)
   {
     out = nullptr;
-    this->do_prepare_parameter("[function]");
+    this->do_prepare_parameter(param_opt_func);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -260,7 +288,7 @@ Argument_Reader::
 optional(optV_array& out)
   {
     out = nullopt;
-    this->do_prepare_parameter("[array]");
+    this->do_prepare_parameter(param_opt_arr);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -282,7 +310,7 @@ Argument_Reader::
 optional(optV_object& out)
   {
     out = nullopt;
-    this->do_prepare_parameter("[object]");
+    this->do_prepare_parameter(param_opt_obj);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -304,7 +332,7 @@ Argument_Reader::
 required(V_boolean& out)
   {
     out = false;
-    this->do_prepare_parameter("boolean");
+    this->do_prepare_parameter(param_req_bool);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -323,7 +351,7 @@ Argument_Reader::
 required(V_integer& out)
   {
     out = 0;
-    this->do_prepare_parameter("integer");
+    this->do_prepare_parameter(param_req_int);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -342,7 +370,7 @@ Argument_Reader::
 required(V_real& out)
   {
     out = 0.0;
-    this->do_prepare_parameter("real");
+    this->do_prepare_parameter(param_req_real);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -361,7 +389,7 @@ Argument_Reader::
 required(V_string& out)
   {
     out.clear();
-    this->do_prepare_parameter("string");
+    this->do_prepare_parameter(param_req_str);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -380,7 +408,7 @@ Argument_Reader::
 required(V_opaque& out)
   {
     out = nullptr;
-    this->do_prepare_parameter("opaque");
+    this->do_prepare_parameter(param_req_opaq);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -399,7 +427,7 @@ Argument_Reader::
 required(V_function& out)
   {
     out = nullptr;
-    this->do_prepare_parameter("function");
+    this->do_prepare_parameter(param_req_func);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -418,7 +446,7 @@ Argument_Reader::
 required(V_array& out)
   {
     out.clear();
-    this->do_prepare_parameter("array");
+    this->do_prepare_parameter(param_req_arr);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -437,7 +465,7 @@ Argument_Reader::
 required(V_object& out)
   {
     out.clear();
-    this->do_prepare_parameter("object");
+    this->do_prepare_parameter(param_req_obj);
 
     auto qref = this->do_peek_argument();
     if(!qref)
@@ -476,7 +504,7 @@ Argument_Reader::
 end_overload(cow_vector<Reference>& vargs)
   {
     vargs.clear();
-    this->do_prepare_parameter("...");
+    this->do_prepare_parameter(param_variadic);
     this->do_terminate_parameter_list();
 
     if(!this->m_state.match)
@@ -500,7 +528,7 @@ Argument_Reader::
 end_overload(cow_vector<Value>& vargs)
   {
     vargs.clear();
-    this->do_prepare_parameter("...");
+    this->do_prepare_parameter(param_variadic);
     this->do_terminate_parameter_list();
 
     if(!this->m_state.match)
@@ -542,7 +570,7 @@ throw_no_matching_function_call() const
 
     // Get the width of the overload number column.
     ::rocket::ascii_numput nump;
-    uint32_t overload_count = (uint32_t) ::rocket::count(this->m_overloads, '|');
+    uint32_t overload_count = (uint32_t) ::rocket::count(this->m_overloads, param_end);
     nump.put_DU(overload_count);
     static_vector<char, 24> sbuf(nump.size(), ' ');
     sbuf.emplace_back();
@@ -556,13 +584,18 @@ throw_no_matching_function_call() const
       ::std::copy_backward(nump.begin(), nump.end(), sbuf.mut_end() - 1);
       overloads << "\n  " << sbuf.data() << ") `" << this->m_name << "(";
 
-      size_t epos = this->m_overloads.find(offset, '|');
-      ROCKET_ASSERT(epos != cow_string::npos);
-      overloads.append(this->m_overloads, offset, epos - offset);
+      const char* comma = "";
+      while(this->m_overloads.at(offset) != param_end) {
+        overloads << comma << s_param_names[this->m_overloads.at(offset)];
+        comma = ", ";
+        offset ++;
+      }
 
       overloads << ")`";
-      offset = (uint32_t) epos + 1;
+      offset ++;
     }
+    if(this->m_overloads_omitted)
+      overloads << "\n  (more overloads omitted)";
     overloads << "\n  -- end of list of overloads]";
 
     // Compose the message and throw it.
@@ -15,17 +15,44 @@ class Argument_Reader
     cow_string m_name;
     Reference_Stack m_stack;
 
+    // Parameters are recorded as indices into a static table of names.
+    // Nothing is allocated unless an error message has to be composed.
+    enum Param : uint8_t
+      {
+        param_end       =  0,  // end of an overload
+        param_opt_ref   =  1,
+        param_opt_val   =  2,
+        param_opt_bool  =  3,
+        param_opt_int   =  4,
+        param_opt_real  =  5,
+        param_opt_str   =  6,
+        param_opt_opaq  =  7,
+        param_opt_func  =  8,
+        param_opt_arr   =  9,
+        param_opt_obj   = 10,
+        param_req_bool  = 11,
+        param_req_int   = 12,
+        param_req_real  = 13,
+        param_req_str   = 14,
+        param_req_opaq  = 15,
+        param_req_func  = 16,
+        param_req_arr   = 17,
+        param_req_obj   = 18,
+        param_variadic  = 19,
+      };
+
     struct State
       {
-        cow_string params;
+        static_vector<uint8_t, 23> params;  // truncated if `nparams` exceeds this
         uint32_t nparams = 0;
         bool finish = false;
         bool match = false;
       };
 
     State m_state;
-    cow_vector<State> m_saved_states;
-    cow_string m_overloads;
+    static_vector<State, 4> m_saved_states;
+    static_vector<uint8_t, 255> m_overloads;  // `param_end`-terminated
+    bool m_overloads_omitted = false;
 
   public:
     Argument_Reader(cow_stringR name, Reference_Stack&& stack) noexcept
@@ -36,7 +63,7 @@ class Argument_Reader
   private:
     inline
     void
-    do_prepare_parameter(const char* param);
+    do_prepare_parameter(Param param);
 
     inline
     void
@@ -67,7 +94,8 @@ class Argument_Reader
     // initial parameter sequence. We allow saving and loading parser
     // states to eliminate the overhead of re-parsing this sequence. The
     // `index` argument is a subscript of `m_saved_states`, which is
-    // resized by `save_state()` as necessary.
+    // resized by `save_state()` as necessary. At most four states can be
+    // saved.
     void
     load_state(uint32_t index);
 
@@ -0,0 +1,294 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "../xprecompiled.hpp"
+#include "coroutine.hpp"
+#include "global_context.hpp"
+#include "executive_context.hpp"
+#include "runtime_error.hpp"
+#include "reference.hpp"
+#include "../llds/reference_stack.hpp"
+#include "../utils.hpp"
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+// `<ucontext.h>` is only available with XSI extensions.
+#  define _XOPEN_SOURCE  700
+#endif
+#include <ucontext.h>
+#if defined(__SANITIZE_ADDRESS__)
+#  define ASTERIA_COROUTINE_ASAN_  1
+#elif defined(__has_feature)
+#  if __has_feature(address_sanitizer)
+#    define ASTERIA_COROUTINE_ASAN_  1
+#  endif
+#endif
+#ifdef ASTERIA_COROUTINE_ASAN_
+#  include <sanitizer/common_interface_defs.h>
+#endif
+namespace asteria {
+namespace {
+
+// This is thrown by `yield()` to unwind the stack of a coroutine that is being
+// destroyed. It is not derived from `std::exception`, so neither scripts nor
+// native functions are able to catch it.
+struct Coroutine_Unwind
+  {
+  };
+
+// These flags are not available everywhere.
+constexpr int s_stack_map_flags = 0
+#ifdef MAP_NORESERVE
+    | MAP_NORESERVE
+#endif
+#ifdef MAP_STACK
+    | MAP_STACK
+#endif
+  ;
+
+// These are machine contexts of a coroutine and its resumer. They are stored
+// at the top of the stack of the coroutine, below which the body runs.
+struct Switch_Contexts
+  {
+    ::ucontext_t self;
+    ::ucontext_t resumer;
+  };
+
+constexpr size_t s_stack_avail = (Coroutine::stack_size - sizeof(Switch_Contexts))
+                                 / alignof(Switch_Contexts) * alignof(Switch_Contexts);
+
+inline
+Switch_Contexts&
+do_contexts(char* stack) noexcept
+  {
+    return *reinterpret_cast<Switch_Contexts*>(stack + s_stack_avail);
+  }
+
+// These tell AddressSanitizer about switches of stacks. A null `fake_save`
+// denotes that the current stack will not be switched back to.
+inline
+void
+do_start_switch_fiber(void** fake_save, const void* bottom, size_t size) noexcept
+  {
+#ifdef ASTERIA_COROUTINE_ASAN_
+    ::__sanitizer_start_switch_fiber(fake_save, bottom, size);
+#else
+    (void) fake_save, (void) bottom, (void) size;
+#endif
+  }
+
+inline
+void
+do_finish_switch_fiber(void* fake_save, const void** bottom_old, size_t* size_old) noexcept
+  {
+#ifdef ASTERIA_COROUTINE_ASAN_
+    ::__sanitizer_finish_switch_fiber(fake_save, bottom_old, size_old);
+#else
+    (void) fake_save, (void) bottom_old, (void) size_old;
+#endif
+  }
+
+}  // namespace
+
+Coroutine::
+Coroutine(const cow_function& body) noexcept
+  :
+    m_body(body)
+  {
+  }
+
+Coroutine::
+~Coroutine()
+  {
+    if(this->m_state == state_suspended) {
+      // Unwind the stack, so objects on it are destroyed. This requires the
+      // global context. If it has gone, objects on the stack are leaked.
+      auto global = unerase_cast<Global_Context_Handle*>(this->m_global.get())->global_opt();
+      if(global) {
+        this->m_unwinding = true;
+        this->do_switch_in(*global);
+        ROCKET_ASSERT(this->m_state == state_finished);
+      }
+    }
+
+    if(this->m_stack)
+      ::munmap(this->m_stack, stack_size);
+  }
+
+void
+Coroutine::
+do_entry(unsigned int hi, unsigned int lo) noexcept
+  {
+    auto co = reinterpret_cast<Coroutine*>((uintptr_t) ((uint64_t) hi << 32 | lo));
+    do_finish_switch_fiber(nullptr, &(co->m_asan_resumer_bottom), &(co->m_asan_resumer_size));
+
+    try {
+      // Call the body with the first argument.
+      Reference self;
+      Reference_Stack stack;
+      stack.push().set_temporary(move(co->m_transfer));
+      auto global = unerase_cast<Global_Context_Handle*>(co->m_global.get())->global_opt();
+      co->m_body.invoke(self, *global, move(stack));
+      co->m_transfer = self.dereference_readonly();
+    }
+    catch(Coroutine_Unwind&) {
+      // The coroutine is being destroyed.
+    }
+    catch(...) {
+      co->m_except = ::std::current_exception();
+    }
+
+    // Return to the resumer by `uc_link`. This stack is not switched back to.
+    co->m_state = state_finished;
+    do_start_switch_fiber(nullptr, co->m_asan_resumer_bottom, co->m_asan_resumer_size);
+  }
+
+void
+Coroutine::
+do_switch_in(Global_Context& global)
+  {
+    // Save states of the resumer, and install those of this coroutine. The
+    // pending exception is swapped back and forth with `m_pending_except`.
+    const auto prev_co = global.exchange_coroutine(this);
+    const auto prev_base = global.get_recursion_base();
+    global.set_recursion_base(this->m_stack + s_stack_avail);
+    const auto prev_handled = global.exchange_handled_exception(this->m_handled);
+    global.swap_pending_exception(this->m_pending_except);
+    const bool prev_throw_by_status = global.exchange_throw_by_status(this->m_throw_by_status);
+    this->m_resumer_except = ::std::current_exception();
+
+    this->m_state = state_running;
+    auto& uctx = do_contexts(this->m_stack);
+    void* fake_save = nullptr;
+    do_start_switch_fiber(&fake_save, this->m_stack, s_stack_avail);
+    ::swapcontext(&(uctx.resumer), &(uctx.self));
+    do_finish_switch_fiber(fake_save, nullptr, nullptr);
+
+    // Save states of this coroutine, and restore those of the resumer.
+    this->m_resumer_except = nullptr;
+    this->m_throw_by_status = global.exchange_throw_by_status(prev_throw_by_status);
+    global.swap_pending_exception(this->m_pending_except);
+    this->m_handled = global.exchange_handled_exception(prev_handled);
+    global.set_recursion_base(prev_base);
+    global.exchange_coroutine(prev_co);
+  }
+
+tinyfmt&
+Coroutine::
+describe(tinyfmt& fmt) const
+  {
+    return format(fmt, "instance of `std.coroutine.Coroutine` at `$1`", this);
+  }
+
+void
+Coroutine::
+collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
+  {
+    this->m_body.collect_variables(staged, temp);
+    this->m_transfer.collect_variables(staged, temp);
+
+    // Local variables of a suspended coroutine live on its own stack, which is
+    // not visible elsewhere. Walk all contexts that were left behind.
+    if(this->m_state == state_suspended)
+      for(auto ctx = this->m_contexts;  ctx;  ctx = ctx->get_outer_opt())
+        ctx->collect_variables(staged, temp);
+  }
+
+Coroutine*
+Coroutine::
+clone_opt(refcnt_ptr<Abstract_Opaque>& /*out*/) const
+  {
+    // Coroutines are not copyable, so the shared instance is used.
+    return nullptr;
+  }
+
+Value
+Coroutine::
+resume(Global_Context& global, const Value& value)
+  {
+    if(this->m_state == state_running)
+      throw Runtime_Error(xtc_format,
+               "Coroutine already running");
+
+    if(this->m_state == state_finished)
+      throw Runtime_Error(xtc_format,
+               "Coroutine already finished");
+
+    if(this->m_state == state_initial) {
+      // Allocate the stack, with a guard page at the bottom.
+      size_t page_size = (size_t) ::sysconf(_SC_PAGESIZE);
+      void* base = ::mmap(nullptr, stack_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | s_stack_map_flags, -1, 0);
+      if(base == MAP_FAILED)
+        ASTERIA_THROW((
+            "Could not allocate coroutine stack",
+            "[`mmap()` failed: ${errno:full}]"));
+
+      if(::mprotect(base, page_size, PROT_NONE) != 0) {
+        int err = errno;
+        ::munmap(base, stack_size);
+        errno = err;
+        ASTERIA_THROW((
+            "Could not protect coroutine stack",
+            "[`mprotect()` failed: ${errno:full}]"));
+      }
+
+      this->m_stack = static_cast<char*>(base);
+
+      auto& uctx = *::new(&do_contexts(this->m_stack)) Switch_Contexts();
+      ::getcontext(&(uctx.self));
+      uctx.self.uc_stack.ss_sp = this->m_stack;
+      uctx.self.uc_stack.ss_size = s_stack_avail;
+      uctx.self.uc_link = &(uctx.resumer);
+
+      auto ival = (uint64_t) (uintptr_t) this;
+      ::makecontext(&(uctx.self), reinterpret_cast<void (*)(void)>(do_entry), 2,
+                    (unsigned int) (ival >> 32), (unsigned int) ival);
+    }
+
+    // Run the body until it yields or returns.
+    if(this->m_global != global.handle())
+      this->m_global = global.handle();
+
+    this->m_transfer = value;
+    this->do_switch_in(global);
+
+    if(this->m_except) {
+      // Forward the exception.
+      auto eptr = move(this->m_except);
+      this->m_except = nullptr;
+      ::std::rethrow_exception(eptr);
+    }
+    return move(this->m_transfer);
+  }
+
+Value
+Coroutine::
+yield(const Value& value)
+  {
+    if(this->m_state != state_running)
+      throw Runtime_Error(xtc_format,
+               "Coroutine not running");
+
+    // The list of caught exceptions is per thread, so it has to be the same
+    // when switching away.
+    if(::std::current_exception() != this->m_resumer_except)
+      throw Runtime_Error(xtc_format,
+               "Coroutine not suspendable inside a native exception handler");
+
+    this->m_transfer = value;
+    this->m_state = state_suspended;
+    auto& uctx = do_contexts(this->m_stack);
+    do_start_switch_fiber(&(this->m_asan_fake_stack), this->m_asan_resumer_bottom,
+                          this->m_asan_resumer_size);
+    ::swapcontext(&(uctx.self), &(uctx.resumer));
+    do_finish_switch_fiber(this->m_asan_fake_stack, &(this->m_asan_resumer_bottom),
+                           &(this->m_asan_resumer_size));
+
+    if(this->m_unwinding)
+      throw Coroutine_Unwind();
+
+    return move(this->m_transfer);
+  }
+
+}  // namespace asteria
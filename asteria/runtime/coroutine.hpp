@@ -0,0 +1,122 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_RUNTIME_COROUTINE_
+#define ASTERIA_RUNTIME_COROUTINE_
+
+#include "../fwd.hpp"
+#include "../value.hpp"
+#include "runtime_error.hpp"
+namespace asteria {
+
+class Coroutine
+  :
+    public rcfwd<Coroutine>,
+    public Abstract_Opaque
+  {
+  public:
+    enum State : uint8_t
+      {
+        state_initial    = 0,
+        state_suspended  = 1,
+        state_running    = 2,
+        state_finished   = 3,
+      };
+
+    enum : uint32_t
+      {
+        // The recursion sentry allows 1 MiB of stack; the rest is for native
+        // functions. Pages are committed on demand.
+        stack_size = 2 << 20,
+      };
+
+  private:
+    cow_function m_body;
+    State m_state = state_initial;
+    bool m_unwinding = false;
+
+    // The body runs on its own stack, so it can be suspended while there are
+    // script functions and native functions in between. Machine contexts for
+    // switching are stored at the top of the stack.
+    char* m_stack = nullptr;
+
+    // These are states of the global context that belong to this coroutine.
+    // They are swapped with those of the resumer upon each switch. As this
+    // coroutine may outlive the global context, it holds a handle instead.
+    rcfwd_ptr<Global_Context_Handle> m_global;
+    const Runtime_Error* m_handled = nullptr;
+    opt<Runtime_Error> m_pending_except;
+    bool m_throw_by_status = false;
+    ::std::exception_ptr m_resumer_except;
+
+    // These are only used by AddressSanitizer.
+    void* m_asan_fake_stack = nullptr;
+    const void* m_asan_resumer_bottom = nullptr;
+    size_t m_asan_resumer_size = 0;
+
+    // This is the innermost executive context on the stack of the body.
+    const Executive_Context* m_contexts = nullptr;
+
+    // This is the argument to, or the result of, a switch.
+    Value m_transfer;
+    ::std::exception_ptr m_except;
+
+  public:
+    explicit
+    Coroutine(const cow_function& body) noexcept;
+
+  private:
+    static
+    void
+    do_entry(unsigned int hi, unsigned int lo) noexcept;
+
+    void
+    do_switch_in(Global_Context& global);
+
+  public:
+    Coroutine(const Coroutine&) = delete;
+    Coroutine& operator=(const Coroutine&) & = delete;
+    ~Coroutine();
+
+    const cow_function&
+    body() const noexcept
+      { return this->m_body;  }
+
+    State
+    state() const noexcept
+      { return this->m_state;  }
+
+    tinyfmt&
+    describe(tinyfmt& fmt) const override;
+
+    void
+    collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const override;
+
+    Coroutine*
+    clone_opt(refcnt_ptr<Abstract_Opaque>& out) const override;
+
+    // Runs the body until it yields or returns. `value` is passed to the body
+    // as its argument the first time, and is returned by `yield()` otherwise.
+    // The value that is passed to `yield()` or returned is returned. If the
+    // body throws an exception, it is rethrown here and this coroutine finishes.
+    // The caller shall hold a reference to this coroutine. If a suspended
+    // coroutine outlives `global`, its stack is not unwound upon destruction,
+    // and objects on it are leaked.
+    Value
+    resume(Global_Context& global, const Value& value);
+
+    // Executive contexts that are created in the body are created and destroyed
+    // in a LIFO manner, so they form a chain, which is walked while this
+    // coroutine is suspended.
+    const Executive_Context*
+    exchange_innermost_context(const Executive_Context* ctx_opt) noexcept
+      { return ::rocket::exchange(this->m_contexts, ctx_opt);  }
+
+    // Suspends this coroutine, which must be running. `value` is returned by
+    // `resume()`, and the argument of the next `resume()` is returned.
+    Value
+    yield(const Value& value);
+  };
+
+}  // namespace asteria
+#endif
@@ -81,6 +81,7 @@ enum AIR_Status : uint8_t
     air_status_continue_unspec  = 7,
     air_status_continue_while   = 8,
     air_status_continue_for     = 9,
+    air_status_throw            = 10,
   };
 
 enum PTC_Aware : uint8_t
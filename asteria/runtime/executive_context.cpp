@@ -8,6 +8,8 @@
 #include "enums.hpp"
 #include "variable.hpp"
 #include "instantiated_function.hpp"
+#include "global_context.hpp"
+#include "coroutine.hpp"
 #include "../llds/avm_rod.hpp"
 #include "../llds/reference_stack.hpp"
 #include "../utils.hpp"
@@ -17,8 +19,14 @@ Executive_Context::
 Executive_Context(Uxtc_function, Global_Context& xglobal, Reference_Stack& xstack, Reference_Stack& ystack,
                   const Instantiated_Function& xfunc, Reference&& xself)
   :
-    m_parent_opt(nullptr), m_global(&xglobal), m_stack(&xstack), m_alt_stack(&ystack), m_func(&xfunc)
+    m_parent_opt(nullptr), m_global(&xglobal), m_stack(&xstack), m_alt_stack(&ystack),
+    m_coroutine(xglobal.get_coroutine_opt()), m_func(&xfunc)
   {
+    // Take a dictionary from the pool, which will be returned when this
+    // context is destroyed.
+    auto dict = this->m_global->allocate_reference_dictionary();
+    this->do_swap_named_references(dict);
+
     // Set the `this` reference, but only if it is a variable or non-null. When
     // `this` is null, it is likely that it is never referenced in the function,
     // so lazy initialization is performed to avoid the overhead here.
@@ -49,11 +57,62 @@ Executive_Context(Uxtc_function, Global_Context& xglobal, Reference_Stack& xstac
     // Move all arguments into the variadic argument getter.
     while(nargs != 0)
       this->m_lazy_args.emplace_back(move(this->m_stack->mut_top(--nargs)));
+
+    // This must come last, as the destructor will not be called if an
+    // exception is thrown above.
+    if(this->m_coroutine)
+      this->do_link_coroutine();
+  }
+
+Executive_Context::
+Executive_Context(Uxtc_defer, Global_Context& xglobal, Reference_Stack& xstack,
+                  Reference_Stack& ystack)
+  :
+    m_parent_opt(nullptr), m_global(&xglobal), m_stack(&xstack), m_alt_stack(&ystack),
+    m_coroutine(xglobal.get_coroutine_opt())
+  {
+    if(this->m_coroutine)
+      this->do_link_coroutine();
   }
 
 Executive_Context::
 ~Executive_Context()
   {
+    if(this->m_func) {
+      // Return the dictionary of a function context to the pool.
+      Reference_Dictionary dict;
+      this->do_swap_named_references(dict);
+      this->m_global->deallocate_reference_dictionary(move(dict));
+    }
+
+    if(this->m_coroutine) {
+      // Contexts are destroyed in the reverse order of creation.
+      auto ctx = this->m_coroutine->exchange_innermost_context(this->m_outer_opt);
+      ROCKET_ASSERT(ctx == this);
+      (void) ctx;
+    }
+  }
+
+void
+Executive_Context::
+do_link_coroutine() noexcept
+  {
+    this->m_outer_opt = this->m_coroutine->exchange_innermost_context(this);
+  }
+
+void
+Executive_Context::
+collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
+  {
+    this->do_collect_named_references(staged, temp);
+    this->m_stack->collect_variables(staged, temp);
+    this->m_alt_stack->collect_variables(staged, temp);
+
+    for(const auto& arg : this->m_lazy_args)
+      arg.collect_variables(staged, temp);
+
+    for(const auto& pair : this->m_defer)
+      pair.second.collect_variables(staged, temp);
   }
 
 Reference*
@@ -80,6 +139,23 @@ do_create_lazy_reference_opt(Reference* hint_opt, phsh_stringR name) const
       return &ref;
     }
 
+    if((name == "__backtrace") && this->m_except) {
+      V_array backtrace;
+      for(size_t k = 0;  k < this->m_except->count_frames();  ++k) {
+        const auto& frm = this->m_except->frame(k);
+        V_object r;
+        r.try_emplace(&"frame", ::rocket::sref(describe_frame_type(frm.type)));
+        r.try_emplace(&"file", frm.sloc.file());
+        r.try_emplace(&"line", frm.sloc.line());
+        r.try_emplace(&"column", frm.sloc.column());
+        r.try_emplace(&"value", frm.value);
+        backtrace.emplace_back(move(r));
+      }
+      auto& ref = this->do_mut_named_reference(hint_opt, name);
+      ref.set_temporary(move(backtrace));
+      return &ref;
+    }
+
     return nullptr;
   }
 
@@ -87,6 +163,16 @@ void
 Executive_Context::
 do_on_scope_exit_normal_slow(AIR_Status status)
   {
+    if(status == air_status_throw) {
+      // An exception is being propagated as a status code. Take it out, as
+      // deferred expressions may throw and catch other exceptions, and put it
+      // back after all of them have been executed.
+      Runtime_Error except = this->m_global->take_pending_exception();
+      this->do_on_scope_exit_exceptional_slow(except);
+      this->m_global->set_pending_exception(move(except));
+      return;
+    }
+
     Reference self;
     if(status == air_status_return_ref) {
       // If a PTC wrapper was returned, append all deferred expressions to it.
@@ -110,7 +196,8 @@ do_on_scope_exit_normal_slow(AIR_Status status)
       // Execute it.
       // If an exception is thrown, append a frame and rethrow it.
       try {
-        pair.second.execute(*this);
+        if(pair.second.execute(*this) == air_status_throw)
+          throw this->m_global->take_pending_exception();
       }
       catch(Runtime_Error& except) {
         except.push_frame_defer(pair.first);
@@ -128,6 +215,12 @@ void
 Executive_Context::
 do_on_scope_exit_exceptional_slow(Runtime_Error& except)
   {
+    // Exceptions from `throw` statements in deferred expressions inherit frames
+    // from `except`, which may be replaced.
+    const auto saved_handled = this->m_global->exchange_handled_exception(&except);
+    auto handled_cleanup = [&](Global_Context* qglobal) { qglobal->exchange_handled_exception(saved_handled);  };
+    unique_ptr<Global_Context, decltype(handled_cleanup)> handled_guard(this->m_global, handled_cleanup);
+
     // Execute all deferred expressions backwards.
     while(!this->m_defer.empty()) {
       auto pair = move(this->m_defer.mut_back());
@@ -136,7 +229,8 @@ do_on_scope_exit_exceptional_slow(Runtime_Error& except)
       // Execute it.
       // If an exception is thrown, replace `except` with it.
       try {
-        pair.second.execute(*this);
+        if(pair.second.execute(*this) == air_status_throw)
+          throw this->m_global->take_pending_exception();
       }
       catch(Runtime_Error& nested) {
         except = nested;
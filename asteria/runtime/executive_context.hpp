@@ -22,9 +22,15 @@ class Executive_Context
     Reference_Stack* m_stack;
     Reference_Stack* m_alt_stack;  // for nested calls
 
+    // Contexts that are created in the body of a coroutine are linked on the
+    // coroutine, so their variables can be found while it is suspended.
+    Coroutine* m_coroutine;
+    const Executive_Context* m_outer_opt = nullptr;
+
     cow_bivector<Source_Location, AVM_Rod> m_defer;
     const Instantiated_Function* m_func = nullptr;
     cow_vector<Reference> m_lazy_args;
+    const Runtime_Error* m_except = nullptr;
 
   public:
     // A plain context must have a parent context.
@@ -32,18 +38,29 @@ class Executive_Context
     Executive_Context(Uxtc_plain, const Executive_Context& parent)
       :
         m_parent_opt(&parent), m_global(parent.m_global), m_stack(parent.m_stack),
-        m_alt_stack(parent.m_alt_stack)
-      { }
+        m_alt_stack(parent.m_alt_stack), m_coroutine(parent.m_coroutine)
+      {
+        if(this->m_coroutine)
+          this->do_link_coroutine();
+      }
+
+    // A catch context is a plain context for a `catch` clause. `__backtrace`
+    // is created from `except` only when it is requested, so the exception
+    // shall outlast this context.
+    Executive_Context(Uxtc_plain, const Executive_Context& parent, const Runtime_Error& except)
+      :
+        m_parent_opt(&parent), m_global(parent.m_global), m_stack(parent.m_stack),
+        m_alt_stack(parent.m_alt_stack), m_coroutine(parent.m_coroutine), m_except(&except)
+      {
+        if(this->m_coroutine)
+          this->do_link_coroutine();
+      }
 
     // A defer context is used to evaluate deferred expressions.
     // They are evaluated in separated contexts, as in case of proper tail calls,
     // contexts of enclosing function will have been destroyed.
-    ASTERIA_INCOMPLET(AVM_Rod)
     Executive_Context(Uxtc_defer, Global_Context& xglobal, Reference_Stack& xstack,
-                      Reference_Stack& ystack)
-      :
-        m_parent_opt(nullptr), m_global(&xglobal), m_stack(&xstack), m_alt_stack(&ystack)
-      { }
+                      Reference_Stack& ystack);
 
     // A function context has no parent.
     // The caller shall define a global context and evaluation stack, both of which
@@ -52,6 +69,10 @@ class Executive_Context
                       Reference_Stack& ystack, const Instantiated_Function& xfunc,
                       Reference&& xself);
 
+  private:
+    void
+    do_link_coroutine() noexcept;
+
   protected:
     Reference*
     do_create_lazy_reference_opt(Reference* hint_opt, phsh_stringR name) const override;
@@ -79,6 +100,13 @@ class Executive_Context
     get_parent_opt() const noexcept
       { return this->m_parent_opt;  }
 
+    // Get the context that was innermost in the same coroutine when this one
+    // was created. This may belong to another function. This is always null
+    // outside coroutines.
+    const Executive_Context*
+    get_outer_opt() const noexcept
+      { return this->m_outer_opt;  }
+
     Global_Context&
     global() const noexcept
       { return *(this->m_global);  }
@@ -95,6 +123,11 @@ class Executive_Context
     swap_stacks() noexcept
       { ::std::swap(this->m_stack, this->m_alt_stack);  }
 
+    // Get the enclosing function. This is only set for a function context.
+    const Instantiated_Function*
+    func_opt() const noexcept
+      { return this->m_func;  }
+
     // Get the defer expression list.
     const cow_bivector<Source_Location, AVM_Rod>&
     defer() const noexcept
@@ -120,6 +153,11 @@ class Executive_Context
         if(!this->m_defer.empty())
           this->do_on_scope_exit_exceptional_slow(except);
       }
+
+    // Collect variables that are referenced by this context, including those
+    // on its stacks. This is used for contexts of suspended coroutines.
+    void
+    collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const;
   };
 
 }  // namespace asteria
@@ -5,7 +5,19 @@
 #include "garbage_collector.hpp"
 #include "variable.hpp"
 #include "../utils.hpp"
+#include <time.h>  // ::clock_gettime(), ::timespec
 namespace asteria {
+namespace {
+
+int64_t
+do_get_monotonic_ns() noexcept
+  {
+    ::timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+  }
+
+}  // namespace
 
 Garbage_Collector::
 Garbage_Collector() noexcept
@@ -19,22 +31,15 @@ Garbage_Collector::
 
 size_t
 Garbage_Collector::
-do_collect_generation(uint32_t gen)
+do_collect_variables(Variable_HashMap& tracked, Variable_HashMap* next_opt, size_t* count_opt)
   {
-    // Ignore recursive requests.
-    if(this->m_recur > 0)
-      return 0;
-
-    this->m_recur ++;
-    const ::rocket::unique_ptr<int, void (int*)> rguard(&(this->m_recur), *[](int* ptr) { -- *ptr;  });
-
     // This algorithm is described at
     //   https://pythoninternal.wordpress.com/2014/08/04/the-garbage-collector/
+    // Variables that are referenced by `tracked` are examined, but only those
+    // in `tracked` may be collected. Any subset of a generation can be passed,
+    // as references from variables outside the subset are considered external.
     size_t nvars = 0;
     refcnt_ptr<Variable> var;
-    auto& tracked = this->m_tracked.at(gMax - gen);
-    const auto next_opt = (gen >= gMax) ? nullptr : &(this->m_tracked.at(gMax - gen - 1));
-    const auto count_opt = (gen >= gMax) ? nullptr : &(this->m_counts.at(gMax - gen - 1));
 
     this->m_staged.clear();
     this->m_temp_1.clear();
@@ -126,6 +131,47 @@ do_collect_generation(uint32_t gen)
 
     this->m_unreach.clear();
 
+    // Return the number of variables that have been collected.
+    return nvars;
+  }
+
+size_t
+Garbage_Collector::
+do_collect_generation(uint32_t gen)
+  {
+    // Ignore recursive requests.
+    if(this->m_recur > 0)
+      return 0;
+
+    this->m_recur ++;
+    const ::rocket::unique_ptr<int, void (int*)> rguard(&(this->m_recur), *[](int* ptr) { -- *ptr;  });
+
+    refcnt_ptr<Variable> var;
+    auto& tracked = this->m_tracked.at(gMax - gen);
+    const auto next_opt = (gen >= gMax) ? nullptr : &(this->m_tracked.at(gMax - gen - 1));
+    const auto count_opt = (gen >= gMax) ? nullptr : &(this->m_counts.at(gMax - gen - 1));
+
+    // Take back variables that have been swept incrementally.
+    if(gen >= gMax)
+      while(this->m_swept.extract_variable(var))
+        tracked.insert(var.get(), var);
+
+    auto& st = this->m_stats[gMax-gen];
+    int64_t start_ns = this->m_adaptive ? do_get_monotonic_ns() : 0;
+    st.nexamined += tracked.size();
+
+    size_t nvars = this->do_collect_variables(tracked, next_opt, count_opt);
+
+    if(this->m_adaptive) {
+      st.ncollected += nvars;
+      st.cost_ns += do_get_monotonic_ns() - start_ns;
+      this->do_adapt_threshold(gen);
+    }
+
+    // Remember how many variables are alive, which limits incremental growth.
+    if(!next_opt)
+      this->m_oldest_live = tracked.size();
+
     // Reset the GC counter to zero only if the operation completes
     // normally i.e. don't reset it if an exception is thrown.
     this->m_counts[gMax-gen] = 0;
@@ -134,14 +180,155 @@ do_collect_generation(uint32_t gen)
     return nvars;
   }
 
+size_t
+Garbage_Collector::
+do_collect_slice(uint32_t gen)
+  {
+    // Ignore recursive requests.
+    if(this->m_recur > 0)
+      return 0;
+
+    this->m_recur ++;
+    const ::rocket::unique_ptr<int, void (int*)> rguard(&(this->m_recur), *[](int* ptr) { -- *ptr;  });
+
+    refcnt_ptr<Variable> var;
+    auto& tracked = this->m_tracked.at(gMax - gen);
+    const auto next_opt = (gen >= gMax) ? nullptr : &(this->m_tracked.at(gMax - gen - 1));
+    const auto count_opt = (gen >= gMax) ? nullptr : &(this->m_counts.at(gMax - gen - 1));
+
+    // Take a slice of variables from this generation.
+    this->m_slice.clear();
+    while((this->m_slice.size() < this->m_slice_size) && tracked.extract_variable(var))
+      try {
+        this->m_slice.insert(var.get(), var);
+      }
+      catch(...) {
+        tracked.insert(var.get(), var);
+        throw;
+      }
+
+    auto& st = this->m_stats[gMax-gen];
+    int64_t start_ns = this->m_adaptive ? do_get_monotonic_ns() : 0;
+    st.nexamined += this->m_slice.size();
+
+    // Variables outside this slice are considered external references, so a
+    // cycle that spans multiple slices survives. Such cycles are collected by
+    // full passes; see `create_variable()`.
+    size_t nvars = this->do_collect_variables(this->m_slice, next_opt, count_opt);
+
+    if(this->m_adaptive) {
+      st.ncollected += nvars;
+      st.cost_ns += do_get_monotonic_ns() - start_ns;
+    }
+
+    // Variables that survive in the oldest generation are set aside, so the
+    // next slice will consist of different variables. Survivors in younger
+    // generations will have been moved to the next generation.
+    auto& survivors = next_opt ? tracked : this->m_swept;
+    while(this->m_slice.extract_variable(var))
+      survivors.insert(var.get(), var);
+
+    if(tracked.empty()) {
+      // All variables of this generation have been examined, so reset the GC
+      // counter to zero.
+      if(!next_opt)
+        tracked.swap(this->m_swept);
+
+      if(this->m_adaptive)
+        this->do_adapt_threshold(gen);
+
+      this->m_counts[gMax-gen] = 0;
+    }
+
+    // Return the number of variables that have been collected.
+    return nvars;
+  }
+
+void
+Garbage_Collector::
+do_adapt_threshold(uint32_t gen)
+  {
+    auto& st = this->m_stats[gMax-gen];
+    int64_t now_ns = do_get_monotonic_ns();
+    int64_t period_ns = now_ns - st.last_ns;
+    st.last_ns = now_ns;
+
+    // The statistics of a complete pass are consumed here.
+    size_t nexamined = ::rocket::exchange(st.nexamined, 0U);
+    size_t nsurvived = nexamined - ::rocket::min(::rocket::exchange(st.ncollected, 0U), nexamined);
+    int64_t cost_ns = ::rocket::exchange(st.cost_ns, 0);
+
+    // A zero threshold requests collection on every allocation, which is not
+    // subject to tuning.
+    size_t base = this->m_thres[gMax-gen];
+    if(base == 0)
+      return;
+
+    size_t thres = st.thres ? st.thres : base;
+
+    if((cost_ns > period_ns / 20) || (nsurvived > nexamined / 2)) {
+      // Either more than 5% of time has been spent on this generation, or
+      // most variables have survived, so collections are too frequent.
+      thres = (thres > SIZE_MAX / 2) ? SIZE_MAX : thres * 2;
+    }
+    else if((cost_ns < period_ns / 100) && (nsurvived < nexamined / 4)) {
+      // Collection is cheap and most variables are garbage, so perform it
+      // more often to release memory earlier.
+      thres /= 2;
+    }
+
+    size_t thres_min = ::rocket::max(base / 8, 1U);
+    size_t thres_max = (base > SIZE_MAX / 64) ? SIZE_MAX : base * 64;
+    st.thres = ::rocket::clamp(thres, thres_min, thres_max);
+  }
+
+bool
+Garbage_Collector::
+do_oldest_overgrown() const noexcept
+  {
+    // Slices leave garbage cycles that span them behind, which accumulate in
+    // the oldest generation. Allow it to grow by its live size plus threshold
+    // before a full pass, so the cost of full passes is proportional to the
+    // number of allocations, like without slices.
+    size_t count = this->m_tracked[0].size() + this->m_swept.size();
+    size_t live = this->m_oldest_live;
+    size_t thres = this->get_effective_threshold(gc_generation_oldest);
+    return (count > live) && (count - live > live + thres);
+  }
+
+size_t
+Garbage_Collector::
+do_count_all_tracked() const noexcept
+  {
+    size_t count = this->m_swept.size();
+    for(const auto& tracked : this->m_tracked)
+      count += tracked.size();
+    return count;
+  }
+
 refcnt_ptr<Variable>
 Garbage_Collector::
 create_variable(GC_Generation gen_hint)
   {
+    // Force garbage collection if the ceiling has been reached.
+    if((this->m_ceiling != 0) && (this->do_count_all_tracked() >= this->m_ceiling_next)) {
+      for(uint32_t gen = 0;  gen <= gMax;  ++gen)
+        this->do_collect_generation(gen);
+
+      size_t count = this->do_count_all_tracked();
+      this->m_ceiling_next = ::rocket::max(this->m_ceiling, count + count / 2);
+    }
+
     // Perform automatic garbage collection.
     for(uint32_t gen = 0;  gen <= gMax;  ++gen)
-      if(this->m_counts[gMax-gen] >= this->m_thres[gMax-gen])
-        this->do_collect_generation(gen);
+      if(this->m_counts[gMax-gen] >= this->get_effective_threshold(static_cast<GC_Generation>(gen))) {
+        if(this->m_slice_size == 0)
+          this->do_collect_generation(gen);
+        else if((gen == gMax) && this->do_oldest_overgrown())
+          this->do_collect_generation(gen);
+        else
+          this->do_collect_slice(gen);
+      }
 
     // Get a cached variable.
     refcnt_ptr<Variable> var;
@@ -156,6 +343,18 @@ create_variable(GC_Generation gen_hint)
     return var;
   }
 
+refcnt_ptr<Variable>
+Garbage_Collector::
+create_foreign_variable()
+  {
+    // Get a cached variable. It is not tracked.
+    refcnt_ptr<Variable> var;
+    this->m_pool.extract_variable(var);
+    if(!var)
+      var = ::rocket::make_refcnt<Variable>();
+    return var;
+  }
+
 size_t
 Garbage_Collector::
 collect_variables(GC_Generation gen_limit)
@@ -186,6 +385,12 @@ finalize() noexcept
     this->m_temp_1.clear();
     this->m_temp_2.clear();
     this->m_unreach.clear();
+    this->m_slice.clear();
+
+    while(this->m_swept.extract_variable(var)) {
+      nvars += 1;
+      var->uninitialize();
+    }
 
     for(size_t gen = 0;  gen <= gMax;  ++gen)
       nvars += this->m_tracked.at(gMax-gen).size();
@@ -22,6 +22,25 @@ class Garbage_Collector
     ::std::array<size_t, gMax+1> m_thres = { 10, 70, 500 };
     ::std::array<Variable_HashMap, gMax+1> m_tracked;
 
+    size_t m_slice_size = 0;  // zero means stop-the-world
+    Variable_HashMap m_slice;
+    Variable_HashMap m_swept;  // survivors of the oldest generation
+    size_t m_oldest_live = 0;  // size of the oldest generation after a full pass
+
+    struct Gen_Stats
+      {
+        size_t thres;  // effective threshold; zero means unset
+        size_t nexamined;
+        size_t ncollected;
+        int64_t cost_ns;
+        int64_t last_ns;
+      };
+
+    bool m_adaptive = false;
+    ::std::array<Gen_Stats, gMax+1> m_stats = { };
+    size_t m_ceiling = 0;  // zero means no limit
+    size_t m_ceiling_next = 0;
+
     Variable_HashMap m_staged;  // key is address of the owner of a `Variable`
     Variable_HashMap m_temp_1;  // key is address to a `Variable`
     Variable_HashMap m_temp_2;
@@ -32,10 +51,30 @@ class Garbage_Collector
     Garbage_Collector() noexcept;
 
   private:
+    inline
+    size_t
+    do_collect_variables(Variable_HashMap& tracked, Variable_HashMap* next_opt, size_t* count_opt);
+
     inline
     size_t
     do_collect_generation(uint32_t gen);
 
+    inline
+    size_t
+    do_collect_slice(uint32_t gen);
+
+    inline
+    void
+    do_adapt_threshold(uint32_t gen);
+
+    inline
+    bool
+    do_oldest_overgrown() const noexcept;
+
+    inline
+    size_t
+    do_count_all_tracked() const noexcept;
+
   public:
     Garbage_Collector(const Garbage_Collector&) = delete;
     Garbage_Collector& operator=(const Garbage_Collector&) & = delete;
@@ -48,11 +87,68 @@ class Garbage_Collector
 
     void
     set_threshold(GC_Generation gen, size_t thres)
-      { this->m_thres.at(gMax-gen) = thres;  }
+      {
+        this->m_thres.at(gMax-gen) = thres;
+        this->m_stats.at(gMax-gen).thres = 0;
+      }
+
+    // If adaptive thresholds are enabled, the threshold of each generation is
+    // tuned after each collection from its survival ratio and the fraction of
+    // time that has been spent on collection since the previous one. The
+    // configured threshold serves as a base, and effective thresholds are kept
+    // within [base/8, base*64].
+    bool
+    is_adaptive() const noexcept
+      { return this->m_adaptive;  }
+
+    void
+    set_adaptive(bool adaptive) noexcept
+      {
+        this->m_adaptive = adaptive;
+        this->m_stats = { };
+      }
+
+    size_t
+    get_effective_threshold(GC_Generation gen) const
+      {
+        const auto& st = this->m_stats.at(gMax-gen);
+        return (this->m_adaptive && st.thres) ? st.thres : this->m_thres.at(gMax-gen);
+      }
+
+    // If the ceiling is non-zero and the total number of tracked variables
+    // reaches it, all generations are collected before a new variable is
+    // created. If too many variables are still alive afterwards, the next
+    // forced collection is postponed until the live set has grown by half.
+    size_t
+    get_variable_ceiling() const noexcept
+      { return this->m_ceiling;  }
+
+    void
+    set_variable_ceiling(size_t nvars) noexcept
+      {
+        this->m_ceiling = nvars;
+        this->m_ceiling_next = nvars;
+      }
 
     size_t
     count_tracked_variables(GC_Generation gen) const
-      { return this->m_tracked.at(gMax-gen).size();  }
+      { return this->m_tracked.at(gMax-gen).size() + ((gen == gMax) ? this->m_swept.size() : 0);  }
+
+    // If the slice size is non-zero, automatic garbage collection is performed
+    // incrementally. Each time a generation exceeds its threshold, at most this
+    // number of variables are examined, and pauses are bounded accordingly. As
+    // variables that are referenced by them are also visited, this is not a
+    // strict limit. Cycles that span multiple slices can't be collected this
+    // way, so once the oldest generation has grown to twice its size after the
+    // previous full pass plus its threshold, it is collected in full. Explicit
+    // calls to `collect_variables()` are not affected.
+    size_t
+    get_slice_size() const noexcept
+      { return this->m_slice_size;  }
+
+    void
+    set_slice_size(size_t nvars) noexcept
+      { this->m_slice_size = nvars;  }
 
     size_t
     count_pooled_variables() const noexcept
@@ -68,6 +164,11 @@ class Garbage_Collector
     refcnt_ptr<Variable>
     create_variable(GC_Generation gen_hint = gc_generation_newest);
 
+    // This function creates a foreign variable, reusing a cached one if any.
+    // The caller shall ensure that it will never be part of a reference cycle.
+    refcnt_ptr<Variable>
+    create_foreign_variable();
+
     size_t
     collect_variables(GC_Generation gen_limit = gc_generation_oldest);
 
@@ -6,6 +6,7 @@
 #include "garbage_collector.hpp"
 #include "random_engine.hpp"
 #include "module_loader.hpp"
+#include "ptc_arguments.hpp"
 #include "abstract_hooks.hpp"
 #include "../library/version.hpp"
 #include "../library/gc.hpp"
@@ -23,6 +24,7 @@
 #include "../library/zlib.hpp"
 #include "../library/ini.hpp"
 #include "../library/csv.hpp"
+#include "../library/coroutine.hpp"
 #include "../utils.hpp"
 namespace asteria {
 namespace {
@@ -52,8 +54,14 @@ constexpr s_modules[] =
     { api_version_0001_0000,  "zlib",        create_bindings_zlib        },
     { api_version_0001_0000,  "ini",         create_bindings_ini         },
     { api_version_0001_0000,  "csv",         create_bindings_csv         },
+    { api_version_0001_0000,  "coroutine",   create_bindings_coroutine   },
   };
 
+// These are limits of pools of storage for function calls.
+constexpr uint32_t s_pool_size = 64;
+constexpr uint32_t s_max_pooled_stack_capacity = 1024;
+constexpr uint32_t s_max_pooled_dict_bucket_count = 256;
+
 struct Module_Comparator
   {
     bool
@@ -76,7 +84,8 @@ Global_Context(API_Version api_version_req)
   :
     m_gcoll(::rocket::make_refcnt<Garbage_Collector>()),
     m_prng(::rocket::make_refcnt<Random_Engine>()),
-    m_ldrlk(::rocket::make_refcnt<Module_Loader>())
+    m_ldrlk(::rocket::make_refcnt<Module_Loader>()),
+    m_handle(::rocket::make_refcnt<Global_Context_Handle>(this))
   {
     // Get the range of modules to initialize.
     // This also determines the maximum version number of the library, which
@@ -98,6 +107,11 @@ Global_Context(API_Version api_version_req)
       });
 
     this->do_mut_named_reference(nullptr, &"std").set_temporary(move(ostd));
+
+    // Reserve storage for pools, so returning storage to them never allocates.
+    this->m_stack_pool.reserve(s_pool_size);
+    this->m_dict_pool.reserve(s_pool_size);
+    this->m_ptc_pool.reserve(s_pool_size);
   }
 
 Global_Context::
@@ -106,7 +120,13 @@ Global_Context::
     // Perform the final garbage collection. Note if there are still cyclic
     // references afterwards, they are left uncollected!
     this->do_clear_named_references();
+    this->m_stack_pool.clear();
+    this->m_dict_pool.clear();
+    this->m_ptc_pool.clear();
     unerase_cast<Garbage_Collector*>(this->m_gcoll.get())->finalize();
+
+    // Coroutines that are still alive shall not access this context any more.
+    this->m_handle->clear();
   }
 
 API_Version
@@ -116,4 +136,98 @@ max_api_version() const noexcept
     return end(s_modules)[-1].api_version;
   }
 
+Reference_Stack
+Global_Context::
+allocate_reference_stack() noexcept
+  {
+    Reference_Stack stack;
+    if(this->m_stack_pool.empty())
+      return stack;
+
+    stack.swap(this->m_stack_pool.mut_back());
+    this->m_stack_pool.pop_back();
+    return stack;
+  }
+
+void
+Global_Context::
+deallocate_reference_stack(Reference_Stack&& stack) noexcept
+  {
+    // Destroy all references, which may own variables.
+    stack.clear();
+    stack.clear_red_zone();
+
+    // Stacks that have no storage are not worth pooling. Stacks that are very
+    // large are released, to avoid holding too much memory.
+    if((stack.capacity() == 0) || (stack.capacity() > s_max_pooled_stack_capacity))
+      return;
+
+    if(this->m_stack_pool.size() >= this->m_stack_pool.capacity())
+      return;
+
+    this->m_stack_pool.emplace_back(move(stack));
+  }
+
+Reference_Dictionary
+Global_Context::
+allocate_reference_dictionary() noexcept
+  {
+    Reference_Dictionary dict;
+    if(this->m_dict_pool.empty())
+      return dict;
+
+    dict.swap(this->m_dict_pool.mut_back());
+    this->m_dict_pool.pop_back();
+    return dict;
+  }
+
+void
+Global_Context::
+deallocate_reference_dictionary(Reference_Dictionary&& dict) noexcept
+  {
+    // Destroy all references, which may own variables.
+    dict.clear();
+
+    // Dictionaries that have no storage are not worth pooling. Dictionaries
+    // that are very large are released, to avoid holding too much memory.
+    if((dict.bucket_count() == 0) || (dict.bucket_count() > s_max_pooled_dict_bucket_count))
+      return;
+
+    if(this->m_dict_pool.size() >= this->m_dict_pool.capacity())
+      return;
+
+    this->m_dict_pool.emplace_back(move(dict));
+  }
+
+refcnt_ptr<PTC_Arguments>
+Global_Context::
+allocate_ptc_arguments(const Source_Location& sloc, PTC_Aware ptc, const cow_function& target,
+                       Reference&& self, Reference_Stack&& stack)
+  {
+    if(this->m_ptc_pool.empty())
+      return ::rocket::make_refcnt<PTC_Arguments>(sloc, ptc, target, move(self), move(stack));
+
+    auto ptca = move(this->m_ptc_pool.mut_back());
+    this->m_ptc_pool.pop_back();
+    ptca->reset(sloc, ptc, target, move(self), move(stack));
+    return ptca;
+  }
+
+void
+Global_Context::
+deallocate_ptc_arguments(refcnt_ptr<PTC_Arguments>&& ptca) noexcept
+  {
+    // Destroy all references, which may own variables. A record that is
+    // still shared can't be reused.
+    if(!ptca.unique())
+      return;
+
+    ptca->clear();
+
+    if(this->m_ptc_pool.size() >= this->m_ptc_pool.capacity())
+      return;
+
+    this->m_ptc_pool.emplace_back(move(ptca));
+  }
+
 }  // namespace asteria
@@ -6,9 +6,39 @@
 
 #include "../fwd.hpp"
 #include "abstract_context.hpp"
+#include "../llds/reference_stack.hpp"
+#include "runtime_error.hpp"
 #include "../recursion_sentry.hpp"
 namespace asteria {
 
+// This is shared with objects that may outlive a global context, such as
+// suspended coroutines, so they can tell whether it is still alive.
+class Global_Context_Handle
+  :
+    public rcfwd<Global_Context_Handle>
+  {
+  private:
+    Global_Context* m_global;
+
+  public:
+    explicit Global_Context_Handle(Global_Context* global) noexcept
+      :
+        m_global(global)
+      { }
+
+  public:
+    Global_Context_Handle(const Global_Context_Handle&) = delete;
+    Global_Context_Handle& operator=(const Global_Context_Handle&) & = delete;
+
+    Global_Context*
+    global_opt() const noexcept
+      { return this->m_global;  }
+
+    void
+    clear() noexcept
+      { this->m_global = nullptr;  }
+  };
+
 class Global_Context
   :
     public Abstract_Context
@@ -20,6 +50,20 @@ class Global_Context
     rcfwd_ptr<Random_Engine> m_prng;
     rcfwd_ptr<Module_Loader> m_ldrlk;
 
+    // These are storage of function calls which can be reused.
+    cow_vector<Reference_Stack> m_stack_pool;
+    cow_vector<Reference_Dictionary> m_dict_pool;
+    cow_vector<refcnt_ptr<PTC_Arguments>> m_ptc_pool;
+
+    // This is the exception that is being propagated as `air_status_throw`.
+    opt<Runtime_Error> m_pending_except;
+    const Runtime_Error* m_handled_except = nullptr;
+    bool m_throw_by_status = false;
+
+    // This is the innermost coroutine that is running.
+    Coroutine* m_coroutine = nullptr;
+    refcnt_ptr<Global_Context_Handle> m_handle;
+
   public:
     // Creates a global context, with the standard library initialized according
     // to `api_version_req`.
@@ -65,6 +109,8 @@ class Global_Context
     get_hooks_opt() const noexcept
       { return unerase_pointer_cast<Abstract_Hooks>(this->m_qhooks);  }
 
+    // Hooks should be installed before scripts are compiled, as calls to small
+    // functions are inlined into code that is compiled without hooks.
     ASTERIA_INCOMPLET(Abstract_Hooks)
     void
     set_hooks(refcnt_ptr<Abstract_Hooks> hooks_opt) noexcept
@@ -85,6 +131,103 @@ class Global_Context
     refcnt_ptr<Module_Loader>
     module_loader() const noexcept
       { return unerase_pointer_cast<Module_Loader>(this->m_ldrlk);  }
+
+    // These functions provide storage for function calls. A stack or dictionary
+    // that is no longer needed may be returned to the pool, and will be handed
+    // out again with all references cleared, but storage retained.
+    Reference_Stack
+    allocate_reference_stack() noexcept;
+
+    void
+    deallocate_reference_stack(Reference_Stack&& stack) noexcept;
+
+    Reference_Dictionary
+    allocate_reference_dictionary() noexcept;
+
+    void
+    deallocate_reference_dictionary(Reference_Dictionary&& dict) noexcept;
+
+    // These functions provide storage for proper tail calls. Arguments are
+    // moved into the PTC record. A record that has been unpacked may be
+    // returned to the pool.
+    refcnt_ptr<PTC_Arguments>
+    allocate_ptc_arguments(const Source_Location& sloc, PTC_Aware ptc, const cow_function& target,
+                           Reference&& self, Reference_Stack&& stack);
+
+    void
+    deallocate_ptc_arguments(refcnt_ptr<PTC_Arguments>&& ptca) noexcept;
+
+    // These functions allow exceptions from `throw` statements to be propagated
+    // as `air_status_throw` instead of C++ exceptions. The exception is stored
+    // here until it is caught. Before calling a script function, a caller that
+    // is able to check the status may request it, and the callee consumes the
+    // request upon entry; otherwise, the callee throws the exception instead.
+    bool
+    has_pending_exception() const noexcept
+      { return this->m_pending_except.has_value();  }
+
+    Runtime_Error&
+    mut_pending_exception() noexcept
+      { return *(this->m_pending_except);  }
+
+    void
+    set_pending_exception(Runtime_Error&& except) noexcept
+      {
+        ROCKET_ASSERT(!this->m_pending_except);
+        this->m_pending_except.emplace(move(except));
+      }
+
+    Runtime_Error
+    take_pending_exception() noexcept
+      {
+        Runtime_Error except = move(*(this->m_pending_except));
+        this->m_pending_except.reset();
+        return except;
+      }
+
+    // This is the exception that is being handled by a `catch` clause or by
+    // deferred expressions. As it may not have been thrown as a C++ exception,
+    // `throw` statements copy its frames from here.
+    const Runtime_Error*
+    get_handled_exception_opt() const noexcept
+      { return this->m_handled_except;  }
+
+    const Runtime_Error*
+    exchange_handled_exception(const Runtime_Error* except_opt) noexcept
+      { return ::rocket::exchange(this->m_handled_except, except_opt);  }
+
+    // These functions are used by coroutines. The running coroutine is the one
+    // that `std.coroutine.yield()` suspends.
+    Coroutine*
+    get_coroutine_opt() const noexcept
+      { return this->m_coroutine;  }
+
+    Coroutine*
+    exchange_coroutine(Coroutine* co_opt) noexcept
+      { return ::rocket::exchange(this->m_coroutine, co_opt);  }
+
+    // A coroutine that has been suspended may outlive this context, so it keeps
+    // this handle instead of a pointer.
+    const refcnt_ptr<Global_Context_Handle>&
+    handle() const noexcept
+      { return this->m_handle;  }
+
+    // A coroutine saves these when switching, as it has its own stack of calls.
+    void
+    swap_pending_exception(opt<Runtime_Error>& except) noexcept
+      { this->m_pending_except.swap(except);  }
+
+    bool
+    exchange_throw_by_status(bool value) noexcept
+      { return ::rocket::exchange(this->m_throw_by_status, value);  }
+
+    void
+    request_throw_by_status() noexcept
+      { this->m_throw_by_status = true;  }
+
+    bool
+    consume_throw_by_status() noexcept
+      { return ::rocket::exchange(this->m_throw_by_status, false);  }
   };
 
 }  // namespace asteria
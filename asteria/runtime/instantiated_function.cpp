@@ -10,18 +10,97 @@
 #include "runtime_error.hpp"
 #include "ptc_arguments.hpp"
 #include "enums.hpp"
+#include "../compiler/compiler_error.hpp"
+#include "../compiler/compiler_statistics.hpp"
 #include "../llds/reference_stack.hpp"
 #include "../utils.hpp"
 namespace asteria {
 
-Instantiated_Function::
-Instantiated_Function(const Source_Location& xsloc, const cow_string& xfunc,
-                      const cow_vector<phsh_string>& xparams, const cow_vector<AIR_Node>& code)
+Instantiated_Function::Template::
+Template(const Source_Location& xsloc, const cow_string& xname,
+         const cow_vector<phsh_string>& xparams, const cow_vector<AIR_Node>& code)
   :
-    m_sloc(xsloc), m_func(xfunc), m_params(xparams)
+    m_sloc(xsloc), m_func(xname), m_params(xparams)
   {
-    ::rocket::for_each(code, [&](const AIR_Node& node) { node.solidify(this->m_rod);  });
+    append_signature(this->m_func, this->m_params);
+
+    Compiler_Phase_Meter meter(compiler_phase_solidification);
+    AIR_Node::solidify_all(this->m_rod, code);
     this->m_rod.finalize();
+    meter.add_count(this->m_rod.size_in_bytes());
+  }
+
+Instantiated_Function::Template::
+Template(const AIR_Node::S_define_function& xlazy)
+  :
+    m_sloc(xlazy.sloc), m_func(xlazy.func), m_params(xlazy.params), m_lazy_opt(xlazy)
+  {
+    append_signature(this->m_func, this->m_params);
+  }
+
+Instantiated_Function::Template::
+~Template()
+  {
+  }
+
+void
+Instantiated_Function::Template::
+append_signature(cow_string& func, const cow_vector<phsh_string>& params)
+  {
+    if(is_cmask(func.front(), cmask_namei) && is_cmask(func.back(), cmask_namei | cmask_digit)) {
+      // If `func` looks like a function name, append the parameter list
+      // to form a function signature.
+      func << "(";
+      uint32_t tid = 0;
+      switch(params.size())
+        {
+          do {
+            func << ", ";  // fallthrough
+        default:
+            func << params[tid];
+          } while(++ tid != params.size());  // fallthrough
+        case 0:
+          break;
+      }
+      func << ")";
+    }
+  }
+
+void
+Instantiated_Function::Template::
+do_compile_lazy_body(const Global_Context& global) const
+  {
+    ROCKET_ASSERT(this->m_lazy_opt);
+
+    cow_vector<AIR_Node> code;
+    try {
+      code = AIR_Node::generate_lazy_body(*(this->m_lazy_opt), global);
+    }
+    catch(Compiler_Error& except) {
+      // Make the error catchable by scripts.
+      throw Runtime_Error(xtc_format,
+               "Could not compile function `$1`: $2", this->m_func, except.what());
+    }
+
+    Compiler_Phase_Meter meter(compiler_phase_solidification);
+    AIR_Node::solidify_all(this->m_rod, code);
+    this->m_rod.finalize();
+    meter.add_count(this->m_rod.size_in_bytes());
+    this->m_lazy_opt.reset();
+  }
+
+void
+Instantiated_Function::Template::
+collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
+  {
+    if(this->m_lazy_opt) {
+      // Captured references may have been bound into the definition.
+      for(const auto& node : this->m_lazy_opt->code_body)
+        node.collect_variables(staged, temp);
+      return;
+    }
+
+    this->m_rod.collect_variables(staged, temp);
   }
 
 Instantiated_Function::
@@ -33,22 +112,36 @@ tinyfmt&
 Instantiated_Function::
 describe(tinyfmt& fmt) const
   {
-    return format(fmt, "`$1` at '$2'", this->m_func, this->m_sloc);
+    return format(fmt, "`$1` at '$2'", this->m_templ->func(), this->m_templ->sloc());
   }
 
 void
 Instantiated_Function::
 collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const
   {
-    this->m_rod.collect_variables(staged, temp);
+    this->m_templ->collect_variables(staged, temp);
+
+    for(const auto& ref : this->m_captures)
+      ref.collect_variables(staged, temp);
   }
 
 Reference&
 Instantiated_Function::
 invoke_ptc_aware(Reference& self, Global_Context& global, Reference_Stack&& stack) const
   {
-    // Create the stack and context for this function.
-    Reference_Stack alt_stack;
+    // Check whether the caller is able to handle `air_status_throw`. This has to
+    // be done before anything else, as the request is not meant for nested calls.
+    const bool throw_by_status = global.consume_throw_by_status();
+
+    // Parse the body upon the first call, if this has been deferred.
+    this->m_templ->compile_lazy_body(global);
+
+    // Create the stack and context for this function. The stack is taken from
+    // the pool of the global context, and is returned after the call.
+    Reference_Stack alt_stack = global.allocate_reference_stack();
+    auto stack_cleanup = [&](Global_Context* qglobal) { qglobal->deallocate_reference_stack(move(alt_stack));  };
+    unique_ptr<Global_Context, decltype(stack_cleanup)> stack_guard(&global, stack_cleanup);
+
     Executive_Context ctx_func(xtc_function, global, stack, alt_stack, *this, move(self));
 
     // Set the hooks up.
@@ -63,11 +156,11 @@ invoke_ptc_aware(Reference& self, Global_Context& global, Reference_Stack&& stac
     // Execute the function body.
     AIR_Status status;
     try {
-      status = this->m_rod.execute(ctx_func);
+      status = this->m_templ->rod().execute(ctx_func);
     }
     catch(Runtime_Error& except) {
       ctx_func.on_scope_exit_exceptional(except);
-      except.push_frame_function(this->m_sloc, this->m_func);
+      except.push_frame_function(this->m_templ->sloc(), this->m_templ->func());
       throw;
     }
     ctx_func.on_scope_exit_normal(status);
@@ -94,6 +187,16 @@ invoke_ptc_aware(Reference& self, Global_Context& global, Reference_Stack&& stac
       case air_status_continue_for:
         throw Runtime_Error(xtc_format, "Stray `continue` statement");
 
+      case air_status_throw:
+        // Append a frame due to exit of this function. If the caller is unable
+        // to handle the status code, throw the exception as a C++ exception.
+        global.mut_pending_exception().push_frame_function(this->m_templ->sloc(), this->m_templ->func());
+        if(!throw_by_status)
+          throw global.take_pending_exception();
+
+        self.set_void();
+        return self;
+
       default:
         ASTERIA_TERMINATE(("Corrupted enumeration `$1`"), status);
     }
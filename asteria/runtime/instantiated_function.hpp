@@ -5,6 +5,8 @@
 #define ASTERIA_RUNTIME_INSTANTIATED_FUNCTION_
 
 #include "../fwd.hpp"
+#include "reference.hpp"
+#include "air_node.hpp"
 #include "../llds/avm_rod.hpp"
 namespace asteria {
 
@@ -12,15 +14,90 @@ class Instantiated_Function
   :
     public Abstract_Function
   {
+  public:
+    // This is the part of a function that does not depend on the context
+    // where it is defined. It is solidified only once, and is shared by all
+    // closures that are created from the same function definition.
+    class Template
+      :
+        public rcfwd<Template>
+      {
+      private:
+        Source_Location m_sloc;
+        cow_string m_func;
+        cow_vector<phsh_string> m_params;
+        mutable AVM_Rod m_rod;
+
+        // If the body has not been parsed, this is the definition, and the body
+        // is parsed and solidified when the function is called for the first
+        // time. This is shared by all closures, so it happens only once.
+        mutable opt<AIR_Node::S_define_function> m_lazy_opt;
+
+      public:
+        Template(const Source_Location& xsloc, const cow_string& xname,
+                 const cow_vector<phsh_string>& xparams, const cow_vector<AIR_Node>& code);
+
+        explicit
+        Template(const AIR_Node::S_define_function& xlazy);
+
+      private:
+        void
+        do_compile_lazy_body(const Global_Context& global) const;
+
+      public:
+        // If `func` looks like a function name, this function appends the
+        // parameter list to form a function signature.
+        static
+        void
+        append_signature(cow_string& func, const cow_vector<phsh_string>& params);
+
+        Template(const Template&) = delete;
+        Template& operator=(const Template&) & = delete;
+        ~Template();
+
+        const Source_Location&
+        sloc() const noexcept
+          { return this->m_sloc;  }
+
+        const cow_string&
+        func() const noexcept
+          { return this->m_func;  }
+
+        const cow_vector<phsh_string>&
+        params() const noexcept
+          { return this->m_params;  }
+
+        bool
+        is_lazy() const noexcept
+          { return this->m_lazy_opt.has_value();  }
+
+        // If the body has not been parsed, this function parses and solidifies
+        // it. This function throws a `Runtime_Error` upon failure.
+        void
+        compile_lazy_body(const Global_Context& global) const
+          {
+            if(ROCKET_UNEXPECT(this->m_lazy_opt))
+              this->do_compile_lazy_body(global);
+          }
+
+        const AVM_Rod&
+        rod() const noexcept
+          { return this->m_rod;  }
+
+        void
+        collect_variables(Variable_HashMap& staged, Variable_HashMap& temp) const;
+      };
+
   private:
-    Source_Location m_sloc;
-    cow_string m_func;
-    cow_vector<phsh_string> m_params;
-    AVM_Rod m_rod;
+    refcnt_ptr<const Template> m_templ;
+    cow_vector<Reference> m_captures;
 
   public:
-    Instantiated_Function(const Source_Location& xsloc, const cow_string& xfunc,
-                          const cow_vector<phsh_string>& xparams, const cow_vector<AIR_Node>& code);
+    Instantiated_Function(const refcnt_ptr<const Template>& xtempl,
+                          cow_vector<Reference>&& xcaptures) noexcept
+      :
+        m_templ(xtempl), m_captures(move(xcaptures))
+      { }
 
   public:
     Instantiated_Function(const Instantiated_Function&) = delete;
@@ -29,15 +106,21 @@ class Instantiated_Function
 
     const Source_Location&
     sloc() const noexcept
-      { return this->m_sloc;  }
+      { return this->m_templ->sloc();  }
 
     const cow_string&
     func() const noexcept
-      { return this->m_func;  }
+      { return this->m_templ->func();  }
 
     const cow_vector<phsh_string>&
     params() const noexcept
-      { return this->m_params;  }
+      { return this->m_templ->params();  }
+
+    // These are references that have been captured from the context where
+    // this function was defined, in the order they are numbered in the code.
+    const cow_vector<Reference>&
+    captures() const noexcept
+      { return this->m_captures;  }
 
     tinyfmt&
     describe(tinyfmt& fmt) const override;
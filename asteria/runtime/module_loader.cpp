@@ -4,11 +4,88 @@
 #include "../xprecompiled.hpp"
 #include "module_loader.hpp"
 #include "runtime_error.hpp"
+#include "air_optimizer.hpp"
+#include "air_serializer.hpp"
+#include "global_context.hpp"
+#include "abstract_hooks.hpp"
+#include "../compiler/token_stream.hpp"
+#include "../compiler/statement_sequence.hpp"
 #include "../utils.hpp"
+#include <openssl/sha.h>
 #include <sys/stat.h>
 #include <sys/file.h>  // ::flock()
 #include <unistd.h>  // ::fstat()
 namespace asteria {
+namespace {
+
+bool
+do_read_cache_file(cow_string& data, cow_stringR path)
+  {
+    ::rocket::unique_posix_file file(::fopen(path.c_str(), "rb"));
+    if(!file)
+      return false;
+
+    data.clear();
+    char temp[4096];
+    while(size_t n = ::fread(temp, 1, sizeof(temp), file))
+      data.append(temp, n);
+    return !::ferror(file);
+  }
+
+void
+do_write_cache_file(cow_stringR path, cow_stringR data)
+  {
+    // Create the directory, if it doesn't exist.
+    size_t pos = path.rfind('/');
+    for(size_t k = path.find(1, '/');  k <= pos;  k = path.find(k + 1, '/'))
+      ::mkdir(path.substr(0, k).c_str(), 0777);
+
+    // Write data to a temporary file, then move it into place, so others will
+    // never see a partial file. The name of the temporary file is unique, as
+    // other threads may be writing the same file.
+    auto temp_path = format_string("$1.XXXXXX", path);
+    int fd = ::mkstemp(temp_path.mut_data());
+    if(fd == -1)
+      return;
+
+    ::rocket::unique_posix_file file(::fdopen(fd, "wb"));
+    if(!file) {
+      ::close(fd);
+      ::unlink(temp_path.c_str());
+      return;
+    }
+
+    bool ok = ::fwrite(data.data(), 1, data.size(), file) == data.size();
+    ok &= ::fclose(file.release()) == 0;
+    if(!ok || (::rename(temp_path.c_str(), path.c_str()) != 0))
+      ::unlink(temp_path.c_str());
+  }
+
+bool
+do_options_equal(const Compiler_Options& lhs, const Compiler_Options& rhs) noexcept
+  {
+    // Compare members one by one, as the struct may contain padding bytes.
+    return (lhs.version == rhs.version)
+           && (lhs.escapable_single_quotes == rhs.escapable_single_quotes)
+           && (lhs.keywords_as_identifiers == rhs.keywords_as_identifiers)
+           && (lhs.integers_as_reals == rhs.integers_as_reals)
+           && (lhs.proper_tail_calls == rhs.proper_tail_calls)
+           && (lhs.verbose_single_step_traps == rhs.verbose_single_step_traps)
+           && (lhs.implicit_global_names == rhs.implicit_global_names)
+           && (lhs.optimization_level == rhs.optimization_level)
+           && (lhs.lazy_function_bodies == rhs.lazy_function_bodies);
+  }
+
+void
+do_get_checksum(uint8_t (&checksum)[32], cow_stringR source) noexcept
+  {
+    static_assert(sizeof(checksum) == SHA256_DIGEST_LENGTH, "");
+    ::SHA256(reinterpret_cast<const unsigned char*>(source.data()), source.size(), checksum);
+  }
+
+constexpr size_t s_max_cached_modules = 256;
+
+}  // namespace
 
 Module_Loader::
 Module_Loader() noexcept
@@ -39,11 +116,16 @@ do_lock_stream(const char* path)
 
     // Mark the stream locked.
     auto skey = format_string("dev:$1/ino:$2", info.st_dev, info.st_ino);
-    auto result = this->m_strms.try_emplace(move(skey), move(file));
+    auto result = this->m_strms.try_emplace(skey);
     if(!result.second)
       throw Runtime_Error(xtc_format,
                "Recursive import denied (loading '$1', file ID `$2`)", path, skey);
 
+    // Save the file, as well as its path. This must not throw exceptions.
+    auto& locked = result.first->second;
+    locked.strm.reset(move(file));
+    locked.path = cow_string(path);
+
     // Lock the file. It will be automatically unlocked when it is closed later.
     // This has to come last because we want user-friendly error messages.
     // Keep in mind that `file` is now null.
@@ -64,4 +146,108 @@ do_unlock_stream(locked_pair* qstrm) noexcept
     ROCKET_ASSERT(count == 1);
   }
 
+cow_function
+Module_Loader::
+do_get_cached_module_opt(const locked_pair* qstrm, const Compiler_Options& opts,
+                         cow_stringR source) const
+  {
+    ROCKET_ASSERT(qstrm);
+    auto qmod = this->m_modules.ptr(qstrm->second.path);
+    if(!qmod)
+      return nullptr;
+
+    // Check whether the module is up to date. Timestamps of files may be too
+    // coarse to tell modifications, so the source is compared instead. If it
+    // has been modified, or different options have been requested, it shall
+    // be compiled again.
+    uint8_t checksum[32];
+    do_get_checksum(checksum, source);
+    if(::memcmp(qmod->checksum, checksum, sizeof(checksum)) != 0)
+      return nullptr;
+
+    if(!do_options_equal(qmod->opts, opts))
+      return nullptr;
+
+    return qmod->func;
+  }
+
+void
+Module_Loader::
+do_set_cached_module(const locked_pair* qstrm, const Compiler_Options& opts,
+                     cow_stringR source, const cow_function& func)
+  {
+    ROCKET_ASSERT(qstrm);
+    cached_module mod;
+    do_get_checksum(mod.checksum, source);
+    mod.opts = opts;
+    mod.func = func;
+
+    // If there are too many modules, discard an arbitrary one.
+    if((this->m_modules.size() >= s_max_cached_modules)
+       && !this->m_modules.ptr(qstrm->second.path))
+      this->m_modules.erase(this->m_modules.begin());
+
+    this->m_modules.insert_or_assign(qstrm->second.path, move(mod));
+  }
+
+cow_string
+Module_Loader::
+do_get_cache_file_path(cow_stringR path) const
+  {
+    // Files are named after the SHA-256 checksums of paths to scripts.
+    unsigned char checksum[SHA256_DIGEST_LENGTH];
+    ::SHA256(reinterpret_cast<const unsigned char*>(path.data()), path.size(), checksum);
+
+    cow_string file_path = this->m_cache_dir;
+    file_path.push_back('/');
+    for(unsigned char byte : checksum) {
+      file_path.push_back("0123456789abcdef"[byte >> 4]);
+      file_path.push_back("0123456789abcdef"[byte & 15]);
+    }
+    file_path.append(".air");
+    return file_path;
+  }
+
+cow_function
+Module_Loader::
+compile_script(const Global_Context& global, const Compiler_Options& opts, cow_stringR path,
+               cow_stringR source) const
+  {
+    // Instantiate the script as a variadic function.
+    cow_vector<phsh_string> script_params;
+    script_params.emplace_back(&"...");
+
+    Source_Location script_sloc(path, 0, 0);
+    AIR_Optimizer optmz(opts);
+
+    // Try loading code from the cache directory first. Cached code may contain
+    // inlined calls, which are invisible to hooks, so it is not used if hooks
+    // have been installed.
+    cow_string cache_path, data;
+    if(!this->m_cache_dir.empty() && !global.get_hooks_opt()) {
+      cache_path = this->do_get_cache_file_path(path);
+
+      cow_vector<AIR_Node> code;
+      if(do_read_cache_file(data, cache_path)
+         && deserialize_air(code, opts, source, data, &global)) {
+        optmz.rebind(nullptr, script_params, code);
+        return optmz.create_function(script_sloc, &"[file scope]");
+      }
+    }
+
+    // Compile the script and save the code.
+    Token_Stream tstrm(opts);
+    tstrm.reload(path, 1, source.data(), source.size());
+
+    Statement_Sequence stmtq(opts);
+    stmtq.reload(move(tstrm));
+
+    optmz.reload(nullptr, script_params, global, stmtq.get_statements());
+
+    if(!cache_path.empty() && serialize_air(data, opts, source, optmz.get_code()))
+      do_write_cache_file(cache_path, data);
+
+    return optmz.create_function(script_sloc, &"[file scope]");
+  }
+
 }  // namespace asteria
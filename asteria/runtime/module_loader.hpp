@@ -16,8 +16,29 @@ class Module_Loader
     class Unique_Stream;  // RAII wrapper
 
   private:
-    cow_dictionary<::rocket::tinybuf_file> m_strms;
-    using locked_pair = pair<const phsh_string, ::rocket::tinybuf_file>;
+    struct locked_file
+      {
+        ::rocket::tinybuf_file strm;
+        phsh_string path;
+      };
+
+    struct cached_module
+      {
+        uint8_t checksum[32];  // SHA-256 of source
+        Compiler_Options opts;
+        cow_function func;
+      };
+
+    cow_dictionary<locked_file> m_strms;
+    using locked_pair = pair<const phsh_string, locked_file>;
+
+    // Compiled modules are keyed by their absolute paths. The number of them
+    // is limited, as each one keeps its code alive.
+    cow_dictionary<cached_module> m_modules;
+
+    // Compiled scripts are also saved in this directory, so they can be
+    // reused by other processes. If this is empty, nothing is saved.
+    cow_string m_cache_dir;
 
   public:
     // Creates an empty module loader.
@@ -30,10 +51,45 @@ class Module_Loader
     void
     do_unlock_stream(locked_pair* qstrm) noexcept;
 
+    cow_function
+    do_get_cached_module_opt(const locked_pair* qstrm, const Compiler_Options& opts,
+                             cow_stringR source) const;
+
+    void
+    do_set_cached_module(const locked_pair* qstrm, const Compiler_Options& opts,
+                         cow_stringR source, const cow_function& func);
+
+    cow_string
+    do_get_cache_file_path(cow_stringR path) const;
+
   public:
     Module_Loader(const Module_Loader&) = delete;
     Module_Loader& operator=(const Module_Loader&) & = delete;
     ~Module_Loader();
+
+    // Discard all compiled modules.
+    void
+    clear_cached_modules() noexcept
+      { this->m_modules.clear();  }
+
+    // Get and set the directory where compiled scripts are saved. Setting an
+    // empty path disables saving.
+    const cow_string&
+    cache_directory() const noexcept
+      { return this->m_cache_dir;  }
+
+    void
+    set_cache_directory(cow_stringR dir)
+      { this->m_cache_dir = dir;  }
+
+    // Compiles `source`, which has been read from `path`, as a variadic
+    // function. `path` shall be absolute. If a cache directory has been set
+    // and it contains code that has been compiled from the same source and
+    // with the same options, that code is loaded instead; otherwise the result
+    // is saved there. Errors about the cache directory are ignored.
+    cow_function
+    compile_script(const Global_Context& global, const Compiler_Options& opts, cow_stringR path,
+                   cow_stringR source) const;
   };
 
 class Module_Loader::Unique_Stream
@@ -83,7 +139,27 @@ class Module_Loader::Unique_Stream
     get() const noexcept
       {
         ROCKET_ASSERT_MSG(this->m_strm, "no stream");
-        return this->m_strm->second;
+        return this->m_strm->second.strm;
+      }
+
+    // Get the module that has been compiled from `source`, which has been read
+    // from this file, with `opts`. If there is no such module, a null pointer
+    // is returned.
+    cow_function
+    get_cached_module_opt(const Compiler_Options& opts, cow_stringR source) const
+      {
+        ROCKET_ASSERT_MSG(this->m_strm, "no stream");
+        return this->m_loader->do_get_cached_module_opt(this->m_strm, opts, source);
+      }
+
+    // Save a module that has been compiled from `source`, which has been read
+    // from this file, with `opts`.
+    void
+    set_cached_module(const Compiler_Options& opts, cow_stringR source,
+                      const cow_function& func) const
+      {
+        ROCKET_ASSERT_MSG(this->m_strm, "no stream");
+        this->m_loader->do_set_cached_module(this->m_strm, opts, source, func);
       }
 
     Unique_Stream&
@@ -11,4 +11,28 @@ PTC_Arguments::
   {
   }
 
+void
+PTC_Arguments::
+clear() noexcept
+  {
+    this->m_target.reset();
+    this->m_self.clear();
+    this->m_stack.clear();
+    this->m_stack.clear_red_zone();
+    this->m_caller_opt.reset();
+    this->m_defer.clear();
+  }
+
+void
+PTC_Arguments::
+reset(const Source_Location& sloc, PTC_Aware ptc, const cow_function& target,
+      Reference&& self, Reference_Stack&& stack) noexcept
+  {
+    this->m_sloc = sloc;
+    this->m_ptc = ptc;
+    this->m_target = target;
+    this->m_self = move(self);
+    this->m_stack = move(stack);
+  }
+
 }  // namespace asteria
@@ -41,6 +41,16 @@ class PTC_Arguments
     PTC_Arguments& operator=(const PTC_Arguments&) & = delete;
     virtual ~PTC_Arguments();
 
+    // These functions are used by pools. `clear()` destroys all references,
+    // and `reset()` initializes this object for another call. Storage of the
+    // stack is swapped, not copied.
+    void
+    clear() noexcept;
+
+    void
+    reset(const Source_Location& sloc, PTC_Aware ptc, const cow_function& target,
+          Reference&& self, Reference_Stack&& stack) noexcept;
+
     // accessors
     const Source_Location&
     sloc() const noexcept
@@ -203,7 +203,8 @@ Reference::
 do_use_function_result_slow(Global_Context& global)
   {
     refcnt_ptr<PTC_Arguments> ptcg;
-    cow_vector<refcnt_ptr<PTC_Arguments>> frames;
+    cow_bivector<refcnt_ptr<PTC_Arguments>, uint32_t> frames;
+    PTC_Aware last_ptc = ptc_aware_none;
     opt<Value> result_value;
     Reference_Stack defer_stack, defer_alt_stack;
     Executive_Context defer_ctx(xtc_defer, global, defer_stack, defer_alt_stack);
@@ -213,26 +214,50 @@ do_use_function_result_slow(Global_Context& global)
       while(this->m_xref == xref_ptc) {
         ptcg.reset(unerase_cast<PTC_Arguments*>(this->m_ptc.release()));
         ROCKET_ASSERT(ptcg.use_count() == 1);
+        last_ptc = ptcg->ptc_aware();
 
         if(auto hooks= global.get_hooks_opt())
           hooks->on_call(ptcg->sloc(), ptcg->target());
 
-        frames.emplace_back(ptcg);
-        *this = move(ptcg->self());
+        // A frame that has the same location, the same caller and no deferred
+        // expressions as its predecessor does exactly the same things when it
+        // returns, and yields the same frames in backtraces, so it is merged
+        // into it. Tail-recursive loops therefore run in constant memory.
+        bool merged = false;
+        if(!frames.empty() && ptcg->defer().empty()) {
+          const auto& prev = *(frames.back().first);
+          merged = prev.defer().empty()
+                   && (prev.ptc_aware() == ptcg->ptc_aware())
+                   && (prev.caller_opt() == ptcg->caller_opt())
+                   && (prev.sloc().line() == ptcg->sloc().line())
+                   && (prev.sloc().column() == ptcg->sloc().column())
+                   && (prev.sloc().file() == ptcg->sloc().file());
+        }
+
+        if(merged)
+          frames.mut_back().second ++;
+        else
+          frames.emplace_back(ptcg, 1U);
+
+        *this = move(ptcg->mut_self());
         ptcg->target().invoke_ptc_aware(*this, global, move(ptcg->mut_stack()));
+
+        // Recycle the frame that has been merged.
+        if(merged)
+          global.deallocate_ptc_arguments(move(ptcg));
       }
 
       // Check the result.
-      if(ptcg->ptc_aware() == ptc_aware_void)
+      if(last_ptc == ptc_aware_void)
         this->m_xref = xref_void;
       else if(this->m_xref != xref_void)
         result_value = this->dereference_readonly();
 
       // This is the normal return path.
       while(!frames.empty()) {
-        ptcg = move(frames.mut_back());
+        ptcg = move(frames.mut_back().first);
+        uint32_t count = frames.back().second;
         frames.pop_back();
-        const auto caller = ptcg->caller_opt();
 
         if((ptcg->ptc_aware() == ptc_aware_by_val) && result_value) {
           // Convert the result.
@@ -243,33 +268,40 @@ do_use_function_result_slow(Global_Context& global)
         }
 
         if(auto hooks = global.get_hooks_opt())
-          hooks->on_return(ptcg->sloc(), ptcg->ptc_aware());
+          for(uint32_t k = 0;  k != count;  ++k)
+            hooks->on_return(ptcg->sloc(), ptcg->ptc_aware());
 
         // Evaluate deferred expressions.
         defer_ctx.stack() = move(ptcg->mut_stack());
         defer_ctx.mut_defer() = move(ptcg->mut_defer());
         defer_ctx.on_scope_exit_normal(air_status_next);
+        global.deallocate_ptc_arguments(move(ptcg));
       }
     }
     catch(Runtime_Error& except) {
       // This is the exceptional path.
       while(!frames.empty()) {
-        ptcg = move(frames.mut_back());
+        ptcg = move(frames.mut_back().first);
+        uint32_t count = frames.back().second;
         frames.pop_back();
         const auto caller = ptcg->caller_opt();
 
         // Note that if we arrive here, there must have been an exception thrown
         // when unpacking the last frame (i.e. the last call did not return), so
-        // the last frame does not have its enclosing function set.
-        except.push_frame_plain(ptcg->sloc(), &"[proper tail call]");
+        // the last frame does not have its enclosing function set. Frames that
+        // have been merged had identical locations and callers.
+        for(uint32_t k = 0;  k != count;  ++k) {
+          except.push_frame_plain(ptcg->sloc(), &"[proper tail call]");
 
-        if(caller)
-          except.push_frame_function(caller->sloc(), caller->func());
+          if(caller)
+            except.push_frame_function(caller->sloc(), caller->func());
+        }
 
         // Evaluate deferred expressions.
         defer_ctx.stack() = move(ptcg->mut_stack());
         defer_ctx.mut_defer() = move(ptcg->mut_defer());
         defer_ctx.on_scope_exit_exceptional(except);
+        global.deallocate_ptc_arguments(move(ptcg));
       }
 
       // The exception object has been updated, so rethrow it.
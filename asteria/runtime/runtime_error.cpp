@@ -36,46 +36,61 @@ do_insert_frame(Frame_Type type, const Source_Location* sloc_opt, const Value& v
     this->m_frames.insert(this->m_frame_ins, move(xfrm));
     this->m_frame_ins ++;
 
-    // Rebuild the message using new frames. The storage may be reused.
-    // Strings are written verbatim. All the others are formatted.
-    this->m_fmt.clear_string();
-    this->m_fmt << "runtime error: ";
+    // Invalidate the message. It will be rebuilt using new frames.
+    this->m_what.clear();
+  }
 
-    if(this->m_value.is_string())
-      this->m_fmt << this->m_value.as_string();
-    else
-      this->m_fmt << this->m_value;
+void
+Runtime_Error::
+do_compose_message() const noexcept
+  {
+    try {
+      // Strings are written verbatim. All the others are formatted.
+      ::rocket::tinyfmt_str fmt;
+      fmt << "runtime error: ";
 
-    // Get the width of the frame number column.
-    ::rocket::ascii_numput nump;
-    nump.put_DU(this->m_frames.size());
-    static_vector<char, 24> sbuf(nump.size(), ' ');
-    sbuf.emplace_back();
+      if(this->m_value.is_string())
+        fmt << this->m_value.as_string();
+      else
+        fmt << this->m_value;
+
+      // Get the width of the frame number column.
+      ::rocket::ascii_numput nump;
+      nump.put_DU(this->m_frames.size());
+      static_vector<char, 24> sbuf(nump.size(), ' ');
+      sbuf.emplace_back();
 
-    // Append stack frames.
-    this->m_fmt << "\n[backtrace frames:";
-    for(size_t k = 0;  k < this->m_frames.size();  ++k) {
-      const auto& r = this->m_frames.at(k);
+      // Append stack frames.
+      ::rocket::tinyfmt_str tempf;
+      fmt << "\n[backtrace frames:";
+      for(size_t k = 0;  k < this->m_frames.size();  ++k) {
+        const auto& r = this->m_frames.at(k);
 
-      // Write frame information.
-      nump.put_DU(k + 1);
-      ::std::copy_backward(nump.begin(), nump.end(), sbuf.mut_end() - 1);
-      const char* ftype = describe_frame_type(r.type);
-      format(this->m_fmt, "\n  $1) $2 at '$3': ", sbuf.data(), ftype, r.sloc);
+        // Write frame information.
+        nump.put_DU(k + 1);
+        ::std::copy_backward(nump.begin(), nump.end(), sbuf.mut_end() - 1);
+        const char* ftype = describe_frame_type(r.type);
+        format(fmt, "\n  $1) $2 at '$3': ", sbuf.data(), ftype, r.sloc);
 
-      // Write the value in this frame.
-      this->m_tempf.clear_string();
-      this->m_tempf << r.value;
+        // Write the value in this frame.
+        tempf.clear_string();
+        tempf << r.value;
 
-      if(this->m_tempf.size() > 80) {
-        // Truncate the message.
-        this->m_fmt.putn(this->m_tempf.data(), 60);
-        format(this->m_fmt, " ... ($1 characters omitted)", this->m_tempf.size() - 60);
+        if(tempf.size() > 80) {
+          // Truncate the message.
+          fmt.putn(tempf.data(), 60);
+          format(fmt, " ... ($1 characters omitted)", tempf.size() - 60);
+        }
+        else
+          fmt.putn(tempf.data(), tempf.size());
       }
-      else
-        this->m_fmt.putn(this->m_tempf.data(), this->m_tempf.size());
+      fmt << "\n  -- end of backtrace frames]";
+      this->m_what = fmt.extract_string();
+    }
+    catch(exception&) {
+      // The message could not be composed, probably due to lack of memory.
+      this->m_what = ::rocket::sref("runtime error: [message unavailable]");
     }
-    this->m_fmt << "\n  -- end of backtrace frames]";
   }
 
 }  // namespace asteria
@@ -27,9 +27,10 @@ class Runtime_Error
     Value m_value;
     cow_vector<Frame> m_frames;
     size_t m_frame_ins = 0;
-    ::rocket::tinyfmt_str m_tempf;
 
-    ::rocket::tinyfmt_str m_fmt;  // human-readable message
+    // The human-readable message is composed when it is first requested, as
+    // most exceptions that are caught by scripts are never printed.
+    mutable cow_string m_what;
 
   public:
     template<typename xValue>
@@ -41,6 +42,17 @@ class Runtime_Error
         this->do_insert_frame(frame_type_throw, &xsloc, this->m_value);
       }
 
+    // This is used when the exception being handled has not been thrown as a
+    // C++ exception, so frames are copied from `nested` explicitly.
+    template<typename xValue>
+    Runtime_Error(Uxtc_throw, xValue&& xval, const Source_Location& xsloc,
+                  const Runtime_Error& nested)
+      :
+        m_value(forward<xValue>(xval)), m_frames(nested.m_frames)
+      {
+        this->do_insert_frame(frame_type_throw, &xsloc, this->m_value);
+      }
+
     Runtime_Error(Uxtc_assert, const Source_Location& xsloc, cow_stringR msg)
       :
         m_value("assertion failure: " + msg)
@@ -54,9 +66,9 @@ class Runtime_Error
       :
         m_value()
       {
-        format(this->m_fmt, templ, params...);
-        ROCKET_ASSERT(this->m_value.type() == type_null);
-        this->m_value = this->m_fmt.extract_string();
+        ::rocket::tinyfmt_str fmt;
+        format(fmt, templ, params...);
+        this->m_value = fmt.extract_string();
 
         this->do_backtrace();
         this->do_insert_frame(frame_type_native, nullptr, this->m_value);
@@ -69,6 +81,9 @@ class Runtime_Error
     void
     do_insert_frame(Frame_Type type, const Source_Location* sloc_opt, const Value& val);
 
+    void
+    do_compose_message() const noexcept;
+
   public:
     Runtime_Error(const Runtime_Error&) noexcept = default;
     Runtime_Error(Runtime_Error&&) noexcept = default;
@@ -79,7 +94,11 @@ class Runtime_Error
     // accessors
     const char*
     what() const noexcept override
-      { return this->m_fmt.c_str();  }
+      {
+        if(this->m_what.empty())
+          this->do_compose_message();
+        return this->m_what.c_str();
+      }
 
     const Value&
     value() const noexcept
@@ -7,6 +7,7 @@
 #include "compiler/statement_sequence.hpp"
 #include "compiler/expression_unit.hpp"
 #include "runtime/air_optimizer.hpp"
+#include "runtime/module_loader.hpp"
 #include "runtime/variable.hpp"
 #include "runtime/garbage_collector.hpp"
 #include "llds/reference_stack.hpp"
@@ -51,6 +52,8 @@ void
 Simple_Script::
 reload(cow_stringR name, Statement_Sequence&& stmtq)
   {
+    Compiler_Statistics_Collector collector(this->m_stats_enabled ? &(this->m_stats) : nullptr);
+
     // Instantiate the function.
     cow_vector<phsh_string> script_params;
     script_params.emplace_back(&"...");
@@ -66,6 +69,7 @@ void
 Simple_Script::
 reload(cow_stringR name, Token_Stream&& tstrm)
   {
+    Compiler_Statistics_Collector collector(this->m_stats_enabled ? &(this->m_stats) : nullptr);
     Statement_Sequence stmtq(this->m_opts);
     stmtq.reload(move(tstrm));
     this->reload(name, move(stmtq));
@@ -75,6 +79,7 @@ void
 Simple_Script::
 reload(cow_stringR name, int line, tinybuf&& cbuf)
   {
+    Compiler_Statistics_Collector collector(this->m_stats_enabled ? &(this->m_stats) : nullptr);
     Token_Stream tstrm(this->m_opts);
     tstrm.reload(name, line, move(cbuf));
     this->reload(name, move(tstrm));
@@ -84,9 +89,10 @@ void
 Simple_Script::
 reload_string(cow_stringR name, int line, cow_stringR code)
   {
-    ::rocket::tinybuf_str cbuf;
-    cbuf.set_string(code, tinybuf::open_read);
-    this->reload(name, line, move(cbuf));
+    Compiler_Statistics_Collector collector(this->m_stats_enabled ? &(this->m_stats) : nullptr);
+    Token_Stream tstrm(this->m_opts);
+    tstrm.reload(name, line, code.data(), code.size());
+    this->reload(name, move(tstrm));
   }
 
 void
@@ -125,7 +131,16 @@ reload_file(const char* path)
 
     ::rocket::tinybuf_file cbuf;
     cbuf.open(abspath, tinybuf::open_read);
-    this->reload(cow_string(abspath), 1, move(cbuf));
+
+    cow_string source;
+    char temp[4096];
+    while(size_t n = cbuf.getn(temp, sizeof(temp)))
+      source.append(temp, n);
+
+    // Compiled code may be saved and loaded by the module loader.
+    Compiler_Statistics_Collector collector(this->m_stats_enabled ? &(this->m_stats) : nullptr);
+    this->m_func = this->m_global.module_loader()->compile_script(this->m_global, this->m_opts,
+                                                                  cow_string(abspath), source);
   }
 
 void
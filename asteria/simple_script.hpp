@@ -8,6 +8,7 @@
 #include "runtime/global_context.hpp"
 #include "runtime/reference.hpp"
 #include "llds/reference_stack.hpp"
+#include "compiler/compiler_statistics.hpp"
 namespace asteria {
 
 class Simple_Script
@@ -17,6 +18,9 @@ class Simple_Script
     Global_Context m_global;
     cow_function m_func;
 
+    bool m_stats_enabled = false;
+    Compiler_Statistics m_stats;
+
   public:
     explicit Simple_Script(API_Version version = api_version_latest)
       :
@@ -32,6 +36,21 @@ class Simple_Script
     mut_options() noexcept
       { return this->m_opts;  }
 
+    // If this is enabled, statistics about compilation are collected when a
+    // script is loaded, which can be retrieved afterwards. Collection slows
+    // compilation down, so it is disabled by default.
+    bool
+    compiler_statistics_enabled() const noexcept
+      { return this->m_stats_enabled;  }
+
+    void
+    set_compiler_statistics_enabled(bool enabled) noexcept
+      { this->m_stats_enabled = enabled;  }
+
+    const Compiler_Statistics&
+    compiler_statistics() const noexcept
+      { return this->m_stats;  }
+
     const Global_Context&
     mut_global() const noexcept
       { return this->m_global;  }
@@ -354,6 +354,45 @@ struct Handler_again : Handler
       }
   };
 
+struct Handler_stats : Handler
+  {
+    const char*
+    cmd() const override
+      { return "stats";  }
+
+    const char*
+    oneline() const override
+      { return "print compiler statistics of last snippet";  }
+
+    const char*
+    help() const override
+      { return
+//       1         2         3         4         5         6         7      |
+// 4567890123456789012345678901234567890123456789012345678901234567890123456|
+"""""""""""""""""""""""""""""""""""""""""""""""""""""""""" R"'''''''''''''''(
+  stats
+
+  Print time and memory that each phase of the compiler took, and numbers of
+  tokens, statements, AIR nodes and bytes that were produced, when the last
+  snippet was compiled successfully.
+)'''''''''''''''" """"""""""""""""""""""""""""""""""""""""""""""""""""""""+3;
+// 4567890123456789012345678901234567890123456789012345678901234567890123456|
+//       1         2         3         4         5         6         7      |
+      }
+
+    void
+    handle(cow_vector<cow_string>&& args) override
+      {
+        if(repl_last_source.empty())
+          return repl_printf("! no previous snippet");
+
+        if(!args.empty())
+          repl_printf("! warning: excess arguments ignored");
+
+        repl_print_compiler_statistics(repl_last_stats);
+      }
+  };
+
 }  // namespace
 
 void
@@ -369,6 +408,7 @@ prepare_repl_commands()
     do_add_handler<Handler_help>();
     do_add_handler<Handler_heredoc>();
     do_add_handler<Handler_source>();
+    do_add_handler<Handler_stats>();
   }
 
 void
@@ -6,6 +6,7 @@
 
 #include "../asteria/fwd.hpp"
 #include "../asteria/value.hpp"
+#include "../asteria/compiler/compiler_statistics.hpp"
 namespace asteria {
 
 // These are process exit status codes.
@@ -27,6 +28,7 @@ constexpr int repl_history_size = 1000;
 // These are global variables defined in 'globals.cpp'.
 extern bool repl_verbose;
 extern bool repl_interactive;
+extern bool repl_compile_stats;
 extern Simple_Script repl_script;
 extern atomic_relaxed<int> repl_signal;
 
@@ -38,6 +40,7 @@ extern cow_string repl_heredoc;  // heredoc terminator
 
 extern cow_string repl_last_source;
 extern cow_string repl_last_file;
+extern Compiler_Statistics repl_last_stats;  // of last snippet
 
 // These functions are defined in 'globals.cpp'.
 void
@@ -46,6 +49,9 @@ repl_vprintf(const char* fmt, ::va_list ap) noexcept;
 void
 repl_printf(const char* fmt, ...) noexcept;
 
+void
+repl_print_compiler_statistics(const Compiler_Statistics& stats);
+
 [[noreturn]]
 void
 quick_exit(Exit_Status stat = exit_success) noexcept;
@@ -82,6 +82,7 @@ struct Verbose_Hooks
 
 bool repl_verbose;
 bool repl_interactive;
+bool repl_compile_stats;
 Simple_Script repl_script;
 atomic_relaxed<int> repl_signal;
 
@@ -93,6 +94,7 @@ cow_string repl_heredoc;  // heredoc terminator
 
 cow_string repl_last_source;
 cow_string repl_last_file;
+Compiler_Statistics repl_last_stats;
 
 void
 repl_vprintf(const char* fmt, ::va_list ap) noexcept
@@ -113,6 +115,14 @@ repl_printf(const char* fmt, ...) noexcept
     va_end(ap);
   }
 
+void
+repl_print_compiler_statistics(const Compiler_Statistics& stats)
+  {
+    ::rocket::tinyfmt_str fmt;
+    fmt << stats;
+    repl_printf("* compiler statistics:\n%s", fmt.c_str());
+  }
+
 [[noreturn]]
 void
 quick_exit(Exit_Status stat) noexcept
@@ -128,9 +128,11 @@ read_execute_print_single()
 
     Reference ref;
     ::rocket::tinyfmt_str fmt;
+    Compiler_Statistics stats;
 
     try {
       // Try parsing the snippet as an expression.
+      Compiler_Statistics_Collector collector(&stats);
       real_name = repl_file;
       if(ROCKET_EXPECT(real_name.empty())) {
         char strbuf[64];
@@ -151,6 +153,7 @@ read_execute_print_single()
 
       try {
         // Try parsing it as a sequence of statements instead.
+        Compiler_Statistics_Collector collector(&stats);
         real_name = repl_file;
         if(ROCKET_EXPECT(real_name.empty())) {
           char strbuf[64];
@@ -174,6 +177,10 @@ read_execute_print_single()
     // Save the accepted snippet.
     repl_last_source.assign(repl_source.begin(), repl_source.end());
     repl_last_file.assign(repl_file.begin(), repl_file.end());
+    repl_last_stats = stats;
+
+    if(repl_compile_stats)
+      repl_print_compiler_statistics(repl_last_stats);
 
     try {
       // Execute the script.
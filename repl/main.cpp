@@ -4,9 +4,11 @@
 #include "../asteria/xprecompiled.hpp"
 #include "fwd.hpp"
 #include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/module_loader.hpp"
 #include <locale.h>  // setlocale()
 #include <unistd.h>  // isatty()
 #include <signal.h>  // sigaction()
+#include <getopt.h>  // getopt_long()
 namespace {
 using namespace ::asteria;
 
@@ -30,6 +32,8 @@ Usage: %s [OPTIONS] [[--] FILE [ARGUMENTS]...]
   -O[n]   set optimization level to `n` [default = 2]
   -V      show version information then exit
   -v      enable verbose mode
+  --compile-stats
+          print time and memory of each compiler phase
 
 Source code is read from standard input if no FILE is specified or `-` is
 given as FILE, and otherwise from FILE. ARGUMENTS following FILE are passed
@@ -50,6 +54,17 @@ In verbose mode, execution details are printed to standard error. It also
 prevents quick termination, which enables some tools such as valgrind to
 discover memory leaks upon exit.
 
+With `--compile-stats`, statistics about compilation are printed to standard
+error after a script has been compiled. In interactive mode, statistics of
+the last snippet are also available via the `:stats` command. Heap figures
+are net growth in each phase; peak usage is not measured.
+
+Compiled scripts are saved in `$XDG_CACHE_HOME/asteria`, or in
+`$HOME/.cache/asteria` if `XDG_CACHE_HOME` is not set, and are reused when
+neither the source nor options have changed. This directory can be changed
+by setting `ASTERIA_CACHE_DIR`; setting it to an empty string disables
+saving.
+
 Visit the homepage at <%s>.
 Report bugs to <%s>.
 )'''''''''''''''" """"""""""""""""""""""""""""""""""""""""""""""""""""""""+1,
@@ -90,7 +105,7 @@ do_parse_command_line(int argc, char** argv)
     bool help = false;
     bool version = false;
 
-    opt<bool> verbose, interactive;
+    opt<bool> verbose, interactive, compile_stats;
     opt<int> optimize;
 
     opt<cow_string> path;
@@ -105,9 +120,16 @@ do_parse_command_line(int argc, char** argv)
         do_print_version_and_exit();
     }
 
-    // Parse command-line options.
+    // Parse command-line options. Long options have no short forms, so they
+    // are assigned values that are not characters.
+    static constexpr ::option long_opts[] =
+      {
+        { "compile-stats", no_argument, nullptr, 0x100 },
+        { nullptr, 0, nullptr, 0 },
+      };
+
     int ch;
-    while((ch = ::getopt(argc, argv, "+hIiO::Vv")) != -1) {
+    while((ch = ::getopt_long(argc, argv, "+hIiO::Vv", long_opts, nullptr)) != -1) {
       // Identify a single option.
       switch(ch) {
         case 'h':
@@ -137,6 +159,10 @@ do_parse_command_line(int argc, char** argv)
         case 'v':
           verbose = true;
           continue;
+
+        case 0x100:
+          compile_stats = true;
+          continue;
       }
 
       // `getopt()` will have written an error message to standard error.
@@ -165,6 +191,10 @@ do_parse_command_line(int argc, char** argv)
     if(verbose)
       repl_verbose = *verbose;
 
+    // Compiler statistics are not collected by default.
+    if(compile_stats)
+      repl_compile_stats = *compile_stats;
+
     // Interactive mode is enabled when no FILE is given (not even `-`) and
     // standard input is connected to a terminal.
     if(interactive)
@@ -184,6 +214,20 @@ do_parse_command_line(int argc, char** argv)
     repl_args = move(args);
   }
 
+void
+do_set_cache_directory()
+  {
+    cow_string dir;
+    if(const char* env = ::getenv("ASTERIA_CACHE_DIR"))
+      dir = cow_string(env);
+    else if(const char* xdg = ::getenv("XDG_CACHE_HOME"))
+      dir = cow_string(xdg) + "/asteria";
+    else if(const char* home = ::getenv("HOME"))
+      dir = cow_string(home) + "/.cache/asteria";
+
+    repl_script.global().module_loader()->set_cache_directory(dir);
+  }
+
 }  // namespace
 
 int
@@ -197,6 +241,7 @@ main(int argc, char** argv)
 
     // Note that this function shall not return in case of errors.
     do_parse_command_line(argc, argv);
+    do_set_cache_directory();
 
     // Set up signal handlers and runtime hooks.
     // In non-interactive mode, we would like to run as fast as possible,
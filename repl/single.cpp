@@ -11,6 +11,7 @@ void
 load_and_execute_single_noreturn()
   {
     // Load and parse the script.
+    repl_script.set_compiler_statistics_enabled(repl_compile_stats);
     try {
       if(repl_file == "-")
         repl_script.reload_stdin();
@@ -22,6 +23,9 @@ load_and_execute_single_noreturn()
       exit_printf(exit_compiler_error, "! exception: %s", stdex.what());
     }
 
+    if(repl_compile_stats)
+      repl_print_compiler_statistics(repl_script.compiler_statistics());
+
     // Execute the script, passing all command-line arguments to it. If the
     // script exits without returning a value, success is assumed.
     auto ref = repl_script.execute(move(repl_args));
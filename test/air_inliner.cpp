@@ -0,0 +1,165 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/compiler/statement_sequence.hpp"
+#include "../asteria/compiler/statement.hpp"
+#include "../asteria/compiler/token_stream.hpp"
+#include "../asteria/runtime/air_optimizer.hpp"
+#include "../asteria/runtime/abstract_hooks.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+static const char source[] = R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func max(a, b) { return a > b ? a : b;  }
+        const sq = func(x) { return x * x;  };
+        func one() { return 1;  }
+        func neg(x) { return std.numeric.abs(x) * -1;  }
+        func big(x) { return std.numeric.max(x, 100);  }
+        func elem(a, i) { return ref a[i];  }
+        func bad(x) { return x / 0;  }
+
+        // These are not inlined.
+        func fib(n) { return n <= 1 ? n : fib(n - 1) + fib(n - 2);  }
+        var k = 10;
+        func addk(x) { return x + k;  }
+
+        func outer(n) {
+          func half(x) { return x / 2;  }
+          return half(n);
+        }
+
+        var r = [];
+        r[$] = max(3, sq(max(one(), 2)));
+        r[$] = neg(sq(4)) + big(7);
+        r[$] = elem([ 5, 6, 7 ], one());
+        r[$] = fib(10);
+        r[$] = addk(sq(3));
+        r[$] = outer(42);
+
+        var s = 0;
+        for(var i = 0;  i < 10;  ++i)
+          s += sq(i);
+        r[$] = s;
+
+        // A name that is declared in a nested scope hides the function.
+        {
+          var max = func(a, b) { return a;  };
+          r[$] = max(1, 2);
+        }
+        r[$] = max(1, 2);
+
+        func dbl(x) { return x * 2;  }
+        r[$] = dbl(3);
+        func dbl(x) { return x * 3;  }
+        r[$] = dbl(3);
+
+        // Backtraces are the same as those of calls.
+        try
+          bad(1);
+        catch(e)
+          for(each _, v -> __backtrace)
+            r[$] = [ v.frame, v.line, v.value ];
+
+        return r;
+
+///////////////////////////////////////////////////////////////////////////////
+  )__";
+
+static
+AIR_Optimizer::Statistics
+do_optimize(int level)
+  {
+    Compiler_Options opts;
+    opts.optimization_level = (uint8_t) level;
+
+    ::rocket::tinybuf_str cbuf;
+    cbuf.set_string(&source, tinybuf::open_read);
+    Token_Stream tstrm(opts);
+    tstrm.reload(&__FILE__, __LINE__, move(cbuf));
+    Statement_Sequence stmtq(opts);
+    stmtq.reload(move(tstrm));
+
+    Global_Context global;
+    AIR_Optimizer optmz(opts);
+    optmz.reload(nullptr, { }, global, stmtq.get_statements());
+    return optmz.get_statistics();
+  }
+
+static
+Value
+do_execute(int level)
+  {
+    Simple_Script code;
+    code.mut_options().optimization_level = (uint8_t) level;
+    code.reload_string(&__FILE__, __LINE__, &source);
+    return code.execute().dereference_readonly();
+  }
+
+int main()
+  {
+    // Each call that is inlined removes the function.
+    auto st1 = do_optimize(1);
+    ASTERIA_TEST_CHECK(st1.nodes_after_inlining == st1.nodes_generated);
+
+    auto st2 = do_optimize(2);
+    ASTERIA_TEST_CHECK(st2.nodes_after_inlining < st2.nodes_generated);
+
+    // Inlined code shall behave identically.
+    auto res0 = do_execute(0);
+    auto res2 = do_execute(2);
+    auto str0 = format_string("$1", res0);
+    auto str2 = format_string("$1", res2);
+    ::fprintf(stderr, "res0 = %s\nres2 = %s\n", str0.c_str(), str2.c_str());
+
+    const auto& arr = res2.as_array();
+    ASTERIA_TEST_CHECK(arr.at(0).as_integer() == 4);
+    ASTERIA_TEST_CHECK(arr.at(1).as_integer() == 84);
+    ASTERIA_TEST_CHECK(arr.at(2).as_integer() == 6);
+    ASTERIA_TEST_CHECK(arr.at(3).as_integer() == 55);
+    ASTERIA_TEST_CHECK(arr.at(4).as_integer() == 19);
+    ASTERIA_TEST_CHECK(arr.at(5).as_integer() == 21);
+    ASTERIA_TEST_CHECK(arr.at(6).as_integer() == 285);
+    ASTERIA_TEST_CHECK(arr.at(7).as_integer() == 1);
+    ASTERIA_TEST_CHECK(arr.at(8).as_integer() == 2);
+    ASTERIA_TEST_CHECK(arr.at(9).as_integer() == 6);
+    ASTERIA_TEST_CHECK(arr.at(10).as_integer() == 9);
+
+    // The backtrace contains the function, and the call to it.
+    ASTERIA_TEST_CHECK(arr.size() > 11);
+    ASTERIA_TEST_CHECK(str0 == str2);
+    bool has_func = false;
+    for(size_t k = 11;  k < arr.size();  ++k)
+      if(arr.at(k).as_array().at(0).as_string().find("function") != cow_string::npos)
+        has_func = arr.at(k).as_array().at(2).as_string() == "bad(x)";
+    ASTERIA_TEST_CHECK(has_func);
+
+    // Nothing is inlined if hooks have been installed, so hooks see all calls.
+    struct Test_Hooks : Abstract_Hooks
+      {
+        uint32_t ncalls = 0;
+        uint32_t nreturns = 0;
+
+        void
+        on_call(const Source_Location& /*sloc*/, const cow_function& /*target*/) override
+          { this->ncalls ++;  }
+
+        void
+        on_return(const Source_Location& /*sloc*/, PTC_Aware /*ptc*/) override
+          { this->nreturns ++;  }
+      };
+
+    const auto hooks = ::rocket::make_refcnt<Test_Hooks>();
+    Simple_Script code;
+    code.global().set_hooks(hooks);
+    code.reload_string(&__FILE__, __LINE__, &R"__(
+      func sq(x) { return x * x;  }
+      return sq(3) + sq(4);
+    )__");
+    ASTERIA_TEST_CHECK(code.execute().dereference_readonly().as_integer() == 25);
+    ASTERIA_TEST_CHECK(hooks->ncalls == 2);
+    ASTERIA_TEST_CHECK(hooks->nreturns == 3);  // including the script itself
+  }
@@ -0,0 +1,88 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/compiler/statement_sequence.hpp"
+#include "../asteria/compiler/statement.hpp"
+#include "../asteria/compiler/token_stream.hpp"
+#include "../asteria/runtime/air_optimizer.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+static const char source[] = R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var x = 1 + 2 * 3;
+        var s = "a" + "b";
+        var t = (4 > 3) ? "yes" : "no";
+
+        if(x == 7)
+          x = x + 1;
+        else
+          x = x - 1;
+
+        if(!true) { }
+        { }
+
+        var z = 1 / 0;   // must not be folded
+        return [ x, s, t, __isnan(0.0 / 0.0) ];
+        x = 42;
+
+///////////////////////////////////////////////////////////////////////////////
+  )__";
+
+static
+AIR_Optimizer::Statistics
+do_optimize(int level)
+  {
+    Compiler_Options opts;
+    opts.optimization_level = (uint8_t) level;
+
+    ::rocket::tinybuf_str cbuf;
+    cbuf.set_string(&source, tinybuf::open_read);
+    Token_Stream tstrm(opts);
+    tstrm.reload(&__FILE__, __LINE__, move(cbuf));
+    Statement_Sequence stmtq(opts);
+    stmtq.reload(move(tstrm));
+
+    Global_Context global;
+    AIR_Optimizer optmz(opts);
+    optmz.reload(nullptr, { }, global, stmtq.get_statements());
+    return optmz.get_statistics();
+  }
+
+int main()
+  {
+    auto st0 = do_optimize(0);
+    ASTERIA_TEST_CHECK(st0.nodes_generated != 0);
+    ASTERIA_TEST_CHECK(st0.nodes_after_constant_folding == st0.nodes_generated);
+    ASTERIA_TEST_CHECK(st0.nodes_after_empty_block_removal == st0.nodes_generated);
+
+    auto st1 = do_optimize(1);
+    ASTERIA_TEST_CHECK(st1.nodes_after_constant_folding < st1.nodes_generated);
+    ASTERIA_TEST_CHECK(st1.nodes_after_branch_folding == st1.nodes_after_constant_folding);
+    ASTERIA_TEST_CHECK(st1.nodes_after_dead_code_elimination == st1.nodes_after_branch_folding);
+    ASTERIA_TEST_CHECK(st1.nodes_after_empty_block_removal == st1.nodes_after_dead_code_elimination);
+
+    auto st2 = do_optimize(2);
+    ASTERIA_TEST_CHECK(st2.nodes_after_constant_folding == st1.nodes_after_constant_folding);
+    ASTERIA_TEST_CHECK(st2.nodes_after_branch_folding < st2.nodes_after_constant_folding);
+    ASTERIA_TEST_CHECK(st2.nodes_after_empty_block_removal < st2.nodes_after_branch_folding);
+
+    // Optimized code shall behave identically.
+    for(int level = 0;  level <= 2;  ++level) {
+      Simple_Script code;
+      code.mut_options().optimization_level = (uint8_t) level;
+      code.reload_string(&__FILE__, __LINE__, &source);
+      ASTERIA_TEST_CHECK_CATCH(code.execute());
+
+      code.reload_string(&__FILE__, __LINE__,
+          cow_string(source).replace(cow_string(source).find("1 / 0"), 5, "1"));
+      auto res = code.execute().dereference_readonly();
+      ASTERIA_TEST_CHECK(res.as_array().at(0).as_integer() == 8);
+      ASTERIA_TEST_CHECK(res.as_array().at(1).as_string() == "ab");
+      ASTERIA_TEST_CHECK(res.as_array().at(2).as_string() == "yes");
+      ASTERIA_TEST_CHECK(res.as_array().at(3).as_boolean() == true);
+    }
+  }
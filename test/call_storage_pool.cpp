@@ -0,0 +1,56 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/global_context.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Global_Context global;
+
+    // A dictionary that has been used is handed out again, cleared, with its
+    // storage retained.
+    auto dict = global.allocate_reference_dictionary();
+    ASTERIA_TEST_CHECK(dict.bucket_count() == 0);
+    dict.insert(::rocket::sref("meow"), nullptr).set_temporary(42);
+    uint32_t nbkt = dict.bucket_count();
+    ASTERIA_TEST_CHECK(nbkt != 0);
+    global.deallocate_reference_dictionary(move(dict));
+
+    dict = global.allocate_reference_dictionary();
+    ASTERIA_TEST_CHECK(dict.bucket_count() == nbkt);
+    ASTERIA_TEST_CHECK(dict.size() == 0);
+
+    // A dictionary that has grown is kept, as long as it is not too large.
+    for(int k = 0;  k < 20;  ++k)
+      dict.insert(phsh_string(format_string("n$1", k)), nullptr);
+    nbkt = dict.bucket_count();
+    global.deallocate_reference_dictionary(move(dict));
+
+    dict = global.allocate_reference_dictionary();
+    ASTERIA_TEST_CHECK(dict.bucket_count() == nbkt);
+    ASTERIA_TEST_CHECK(dict.size() == 0);
+
+    for(int k = 0;  k < 1000;  ++k)
+      dict.insert(phsh_string(format_string("n$1", k)), nullptr);
+    global.deallocate_reference_dictionary(move(dict));
+    ASTERIA_TEST_CHECK(global.allocate_reference_dictionary().bucket_count() == 0);
+
+    // The same applies to stacks.
+    auto stack = global.allocate_reference_stack();
+    stack.push().set_temporary(1);
+    global.deallocate_reference_stack(move(stack));
+    stack = global.allocate_reference_stack();
+    ASTERIA_TEST_CHECK(stack.size() == 0);
+
+    // Calls to script functions return their dictionaries to the pool.
+    Simple_Script code;
+    code.reload_string(&__FILE__, __LINE__, &R"__(
+      func add(a, b) { var c = a + b;  return c;  }
+      return add(1, 2);
+    )__");
+    ASTERIA_TEST_CHECK(code.execute().dereference_readonly().as_integer() == 3);
+    ASTERIA_TEST_CHECK(code.global().allocate_reference_dictionary().bucket_count() != 0);
+  }
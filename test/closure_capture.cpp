@@ -0,0 +1,67 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+      // Closures created in a loop share code, but not captured variables.
+      var fs = [];
+      for(var i = 0;  i < 5;  ++i) {
+        var k = i * 10;
+        fs[$] = func() { return k + i;  };
+      }
+      assert fs[0]() == 5;
+      assert fs[3]() == 35;
+
+      // Captured references are references, not copies.
+      func make_counter() {
+        var n = 0;
+        return [ func() { return ++n;  }, func() { return n;  } ];
+      }
+      var c1 = make_counter();
+      var c2 = make_counter();
+      c1[0]();
+      c1[0]();
+      c2[0]();
+      assert c1[1]() == 2;
+      assert c2[1]() == 1;
+
+      // Names from multiple enclosing functions are captured through each
+      // level of nesting.
+      func outer(a) {
+        var b = a + 1;
+        return func(c) {
+          var d = c + 1;
+          return func(e) {
+            return [ a, b, c, d, e ];
+          };
+        };
+      }
+      assert outer(1)(10)(100) == [ 1, 2, 10, 11, 100 ];
+      assert outer(2)(20)(200) == [ 2, 3, 20, 21, 200 ];
+
+      // Captured references in deferred expressions and closures that they
+      // create are bound when the expression is deferred.
+      var log = [];
+      func with_defer(x) {
+        var y = x * 2;
+        return func() {
+          defer log[$] = (func() { return x + y;  })();
+          return y;
+        };
+      }
+      assert with_defer(4)() == 8;
+      assert log == [ 12 ];
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
@@ -0,0 +1,55 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    const cow_string source = &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        func fib(n) { return n <= 1 ? n : fib(n - 1) + fib(n - 2);  }
+
+        var sum = 0;
+        for(var i = 0;  i < 10;  ++i)
+          sum += fib(i);
+
+        return sum;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__";
+
+    // Statistics are not collected by default.
+    Simple_Script code;
+    code.reload_string(&"stats", 1, source);
+    for(size_t k = 0;  k != compiler_phase_count;  ++k)
+      ASTERIA_TEST_CHECK(code.compiler_statistics().phases[k].runs == 0);
+
+    code.set_compiler_statistics_enabled(true);
+    code.reload_string(&"stats", 1, source);
+    const auto& stats = code.compiler_statistics();
+    for(size_t k = 0;  k != compiler_phase_count;  ++k) {
+      ASTERIA_TEST_CHECK(stats.phases[k].runs != 0);
+      ASTERIA_TEST_CHECK(stats.phases[k].count != 0);
+      ASTERIA_TEST_CHECK(stats.phases[k].time_ms >= 0);
+    }
+
+    // Both the script and `fib` are solidified. There is an implicit return
+    // statement at the end of the script.
+    ASTERIA_TEST_CHECK(stats.phase(compiler_phase_lexing).runs == 1);
+    ASTERIA_TEST_CHECK(stats.phase(compiler_phase_parsing).runs == 1);
+    ASTERIA_TEST_CHECK(stats.phase(compiler_phase_solidification).runs == 2);
+    ASTERIA_TEST_CHECK(stats.phase(compiler_phase_parsing).count == 5);
+    ASTERIA_TEST_CHECK(code.execute().dereference_readonly().as_integer() == 88);
+
+    // Statistics are reset upon each reload.
+    code.reload_string(&"stats", 1, &"return 42;");
+    ASTERIA_TEST_CHECK(stats.phase(compiler_phase_lexing).count == 3);
+    ASTERIA_TEST_CHECK(stats.phase(compiler_phase_solidification).runs == 1);
+
+    auto str = format_string("$1", stats);
+    ASTERIA_TEST_CHECK(str.find("solidification") != cow_string::npos);
+    ASTERIA_TEST_CHECK(str.find("peak usage is not measured") != cow_string::npos);
+  }
@@ -0,0 +1,196 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        const co = std.coroutine;
+
+        // generator
+        var gen = co.Coroutine(func(n) {
+          for(var i = 0;  i < n;  ++i)
+            co.yield(i * 10);
+          return "end";
+        });
+        var r = [];
+        var x = gen.resume(4);
+        while(!gen.done()) {
+          r[$] = x;
+          x = gen.resume();
+        }
+        assert r == [ 0, 10, 20, 30 ];
+        assert x == "end";
+        try { gen.resume();  assert false;  }
+          catch(e) assert std.string.find(e, "finished") != null;
+
+        // values in both directions, with native functions in between
+        var acc = co.Coroutine(func(x) {
+          var sum = x;
+          std.array.sort([3,2,1], func(a, b) {
+            sum += co.yield(sum);
+            return a <=> b;
+          });
+          return sum;
+        });
+        assert acc.resume(1) == 1;
+        assert acc.resume(2) == 3;
+        var last;
+        for(var k = 3;  !acc.done();  ++k)
+          last = acc.resume(k);
+        assert last > 3;
+
+        // exceptions
+        var thr = co.Coroutine(func(x) {
+          co.yield(x);
+          throw "boom";
+        });
+        assert thr.resume(42) == 42;
+        try { thr.resume();  assert false;  }
+          catch(e) assert std.string.find(e, "boom") != null;
+        assert thr.done();
+
+        // a coroutine that yields while an exception is being handled
+        var hdl = co.Coroutine(func(x) {
+          try
+            throw x;
+          catch(e) {
+            co.yield(e);
+            return countof __backtrace > 0;
+          }
+        });
+        assert hdl.resume("meow") == "meow";
+        assert hdl.resume() == true;
+
+        // a coroutine that yields from a deferred expression while an exception
+        // is being propagated
+        var dfr = co.Coroutine(func(x) {
+          defer co.yield("deferred");
+          throw "boom";
+        });
+        assert dfr.resume() == "deferred";
+        try { throw "other";  }
+          catch(e) assert std.string.find(e, "other") != null;
+        try { dfr.resume();  assert false;  }
+          catch(e) assert std.string.find(e, "boom") != null;
+
+        // no coroutine
+        assert co.is_running() == false;
+        try { co.yield(1);  assert false;  }
+          catch(e) assert std.string.find(e, "outside") != null;
+
+        // nesting
+        var outer = co.Coroutine(func(x) {
+          var inner = co.Coroutine(func(y) {
+            assert co.is_running();
+            co.yield(y + 1);
+            return y + 2;
+          });
+          co.yield(inner.resume(x));
+          co.yield(inner.resume());
+          return inner.done();
+        });
+        assert outer.resume(5) == 6;
+        assert outer.resume() == 7;
+        assert outer.resume() == true;
+
+        // re-entrance
+        var self;
+        self = co.Coroutine(func(x) {
+          try { self.resume();  assert false;  }
+            catch(e) return std.string.find(e, "running") != null;
+        });
+        assert self.resume() == true;
+        self = null;
+
+        // destruction of suspended coroutines
+        var sus = co.Coroutine(func(x) {
+          try
+            for(;;)
+              co.yield([x]);
+          catch(e)
+            assert false;
+        });
+        sus.resume(1);
+        sus.resume(2);
+        sus = null;
+        std.gc.collect();
+
+        // cycles through locals of suspended coroutines
+        std.gc.collect();
+        var nvars = std.gc.count_variables(0) + std.gc.count_variables(1)
+                    + std.gc.count_variables(2);
+        for(var i = 0;  i < 100;  ++i) {
+          var cyc = co.Coroutine(func(x) {
+            var me = x;
+            co.yield(null);
+          });
+          cyc.resume(cyc);
+        }
+        std.gc.collect();
+        assert std.gc.count_variables(0) + std.gc.count_variables(1)
+               + std.gc.count_variables(2) < nvars + 10;
+
+        // deep recursion in a coroutine
+        func recur(n) {
+          return recur(n + 1) + 1;
+        }
+        var deep = co.Coroutine(func(x) {
+          var r;
+          try { recur(0);  assert false;  }
+            catch(e) r = "overflow";
+          co.yield(r);
+          return "survived";
+        });
+        assert deep.resume() == "overflow";
+        assert deep.resume() == "survived";
+
+        // lots of coroutines
+        var all = [];
+        for(var i = 0;  i < 5000;  ++i) {
+          all[$] = co.Coroutine(func(x) {
+            var y = x;
+            for(;;)
+              y = co.yield(y + 1);
+          });
+          assert all[i].resume(i) == i + 1;
+        }
+        for(var i = 0;  i < 5000;  ++i)
+          assert all[i].resume(i * 2) == i * 2 + 1;
+        all = null;
+        std.gc.collect();
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+
+    // A suspended coroutine may outlive its global context. It is not unwound
+    // when destroyed then.
+    Value survivor;
+    {
+      Simple_Script temp;
+      temp.reload_string(
+        &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+          var sus = std.coroutine.Coroutine(func(x) {
+            var local = [x];
+            std.coroutine.yield(local);
+          });
+          sus.resume(1);
+          return sus;
+
+///////////////////////////////////////////////////////////////////////////////
+        )__");
+      survivor = temp.execute().dereference_readonly();
+    }
+    ASTERIA_TEST_CHECK(survivor.is_object());
+    survivor = nullopt;
+  }
@@ -0,0 +1,57 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // The left-hand operand is created lazily, which may rehash the dictionary
+    // of the function. Try functions with various numbers of parameters, so
+    // rehashing happens for some of them.
+    for(uint32_t nparams = 0;  nparams != 40;  ++nparams) {
+      cow_string params, args;
+      for(uint32_t k = 0;  k != nparams;  ++k) {
+        params += format_string("p$1, ", k);
+        args += "null, ";
+      }
+
+      auto source = format_string(
+          R"__(
+            func f($1a) { return __func + a;  }
+            func g($1a) { return a + __func;  }
+            return [ f($2"x"), g($2"x") ];
+          )__", params, args);
+
+      Simple_Script code;
+      code.reload_string(&__FILE__, __LINE__, source);
+      auto res = code.execute().dereference_readonly();
+      ASTERIA_TEST_CHECK(res.as_array().at(0).as_string() == "f(" + params + "a)x");
+      ASTERIA_TEST_CHECK(res.as_array().at(1).as_string() == "xg(" + params + "a)");
+    }
+
+    // The left-hand operand is evaluated first.
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        switch(1) {
+          case 0:
+            var a = 1;
+            var b = 2;
+          case 1:
+            try {
+              return a + b;
+              assert false;
+            }
+            catch(e)
+              return e;
+        }
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    auto res = code.execute().dereference_readonly();
+    ASTERIA_TEST_CHECK(res.as_string().find("variable or reference `a` bypassed") != cow_string::npos);
+  }
@@ -56,7 +56,7 @@ int main()
             }());
           }());
 
-          assert std.gc.collect() == 3;  // x, f, g
+          assert std.gc.collect() == 2;  // x, f
 
 ///////////////////////////////////////////////////////////////////////////////
         )__");
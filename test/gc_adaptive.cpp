@@ -0,0 +1,99 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/garbage_collector.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+      assert std.gc.set_adaptive(true) == false;
+      assert std.gc.get_adaptive() == true;
+
+      // Create cycles of different lengths, which are unreachable as soon as
+      // `leak()` returns.
+      func leak(n) {
+        var first = [ null ];
+        var last = first;
+        for(var i = 0;  i < n;  ++i) {
+          var next = [ null ];
+          last[0] = func() { return next; };
+          last = next;
+        }
+        last[0] = func() { return first; };
+      }
+
+      // These variables shall survive.
+      var keep = [ ];
+      for(var i = 0;  i < 100;  ++i) {
+        var x = i;
+        keep[i] = func() { return x; };
+      }
+
+      for(var i = 0;  i < 2000;  ++i)
+        leak(i % 50);
+
+      for(var i = 0;  i < 100;  ++i)
+        assert keep[i]() == i;
+
+      // Disable automatic collection, so only the ceiling applies.
+      assert std.gc.set_adaptive(false) == true;
+      std.gc.set_threshold(0, 0x7FFFFFFF);
+      std.gc.set_threshold(1, 0x7FFFFFFF);
+      std.gc.set_threshold(2, 0x7FFFFFFF);
+      std.gc.collect();
+
+      assert std.gc.set_ceiling(2000) == 0;
+      assert std.gc.get_ceiling() == 2000;
+
+      var max_count = 0;
+      for(var i = 0;  i < 2000;  ++i) {
+        leak(i % 50);
+        var count = std.gc.count_variables(0) + std.gc.count_variables(1)
+                    + std.gc.count_variables(2);
+        if(max_count < count)
+          max_count = count;
+      }
+      std.debug.logf("max count = $1", max_count);
+      assert max_count < 2200;
+
+      for(var i = 0;  i < 100;  ++i)
+        assert keep[i]() == i;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+
+    // Effective thresholds shall stay within their bounds.
+    const auto gcoll = code.global().garbage_collector();
+    gcoll->set_adaptive(true);
+    gcoll->set_variable_ceiling(0);
+    gcoll->set_threshold(gc_generation_newest, 10);
+    gcoll->set_threshold(gc_generation_middle, 70);
+    gcoll->set_threshold(gc_generation_oldest, 500);
+
+    for(int i = 0;  i < 100000;  ++i)
+      gcoll->create_variable()->initialize(V_integer(i));
+
+    ASTERIA_TEST_CHECK(gcoll->get_effective_threshold(gc_generation_newest) >= 1);
+    ASTERIA_TEST_CHECK(gcoll->get_effective_threshold(gc_generation_newest) <= 640);
+    ASTERIA_TEST_CHECK(gcoll->get_effective_threshold(gc_generation_middle) >= 8);
+    ASTERIA_TEST_CHECK(gcoll->get_effective_threshold(gc_generation_middle) <= 4480);
+    ASTERIA_TEST_CHECK(gcoll->get_effective_threshold(gc_generation_oldest) >= 62);
+    ASTERIA_TEST_CHECK(gcoll->get_effective_threshold(gc_generation_oldest) <= 32000);
+    ::fprintf(stderr, "effective thresholds = %zu, %zu, %zu\n",
+              gcoll->get_effective_threshold(gc_generation_newest),
+              gcoll->get_effective_threshold(gc_generation_middle),
+              gcoll->get_effective_threshold(gc_generation_oldest));
+
+    gcoll->set_threshold(gc_generation_newest, 20);
+    ASTERIA_TEST_CHECK(gcoll->get_effective_threshold(gc_generation_newest) == 20);
+    gcoll->set_adaptive(false);
+    ASTERIA_TEST_CHECK(gcoll->get_effective_threshold(gc_generation_oldest) == 500);
+  }
@@ -0,0 +1,80 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+      std.gc.set_threshold(0, 0x7FFFFFFF);
+      std.gc.set_threshold(1, 0x7FFFFFFF);
+      std.gc.set_threshold(2, 0x7FFFFFFF);
+
+      func count_all() {
+        return std.gc.count_variables(0) + std.gc.count_variables(1)
+               + std.gc.count_variables(2);
+      }
+
+      // These variables are never captured, so they are not tracked.
+      var base = count_all();
+      var sum = 0;
+      for(var i = 0;  i < 1000;  ++i) {
+        var x = i * 2;
+        var y;
+        y = x + 1;
+        var [ a, b ] = [ x, y ];
+        sum += a + b;
+      }
+      assert sum == 1999000;
+      assert count_all() - base < 10;
+
+      // These variables are captured by closures, so they are tracked, and
+      // cycles are collected.
+      base = count_all();
+      for(var i = 0;  i < 1000;  ++i) {
+        var c = [ null ];
+        c[0] = func() { return c; };
+      }
+      assert count_all() - base >= 1000;
+      std.gc.collect();
+      assert count_all() - base < 10;
+
+      // References that are passed by reference, bound to other names, or
+      // used as `this` also escape.
+      func set_self(p) {
+        p = func() { return p; };
+      }
+      func bind(r) {
+        return func() { return r; };
+      }
+      base = count_all();
+      for(var i = 0;  i < 100;  ++i) {
+        var d;
+        set_self(ref d);
+        assert typeof d() == "function";
+
+        var e = [ null ];
+        ref f -> e;
+        f[0] = func() { return f; };
+
+        var g = { };
+        g.h = func() { return this; };
+        assert countof g.h() == 1;
+
+        var k = [ 1 ];
+        for(each z -> k)
+          k[0] = func() { return z; };
+      }
+      std.gc.collect();
+      assert count_all() - base < 10;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
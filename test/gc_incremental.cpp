@@ -0,0 +1,80 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/garbage_collector.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.global().garbage_collector()->set_slice_size(16);
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+      assert std.gc.get_slice_size() == 16;
+
+      // Create cycles of different lengths, which are unreachable as soon as
+      // `leak()` returns.
+      func leak(n) {
+        var first = [ null ];
+        var last = first;
+        for(var i = 0;  i < n;  ++i) {
+          var next = [ null ];
+          last[0] = func() { return next; };
+          last = next;
+        }
+        last[0] = func() { return first; };
+      }
+
+      // These variables shall survive.
+      var keep = [ ];
+      for(var i = 0;  i < 100;  ++i) {
+        var x = i;
+        keep[i] = func() { return x; };
+      }
+
+      var max_count = 0;
+      for(var i = 0;  i < 3000;  ++i) {
+        leak(i % 50);
+        var count = std.gc.count_variables(0) + std.gc.count_variables(1)
+                    + std.gc.count_variables(2);
+        if(max_count < count)
+          max_count = count;
+      }
+      std.debug.logf("max count = $1", max_count);
+      assert max_count < 5000;
+
+      for(var i = 0;  i < 100;  ++i)
+        assert keep[i]() == i;
+
+      // Tiny slices can't keep up with cycles, which shall be collected by
+      // full passes eventually.
+      assert std.gc.set_slice_size(2) == 16;
+      max_count = 0;
+      for(var i = 0;  i < 20000;  ++i) {
+        leak(i % 10);
+        var count = std.gc.count_variables(0) + std.gc.count_variables(1)
+                    + std.gc.count_variables(2);
+        if(max_count < count)
+          max_count = count;
+      }
+      std.debug.logf("max count with tiny slices = $1", max_count);
+      assert max_count < 2000;
+
+      for(var i = 0;  i < 100;  ++i)
+        assert keep[i]() == i;
+
+      assert std.gc.set_slice_size(0) == 2;
+      std.gc.collect();
+      var count = std.gc.count_variables(0) + std.gc.count_variables(1)
+                  + std.gc.count_variables(2);
+      std.debug.logf("count after collection = $1", count);
+      assert count < 1000;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
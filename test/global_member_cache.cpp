@@ -0,0 +1,58 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/variable.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+      var r;
+      for(var i = 0;  i < 3;  ++i)
+        r = std.string.find;
+      return r;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+
+    auto res = code.execute().dereference_readonly();
+    ASTERIA_TEST_CHECK(res.is_function());
+    res = code.execute().dereference_readonly();
+    ASTERIA_TEST_CHECK(res.is_function());
+
+    // Replace `std` with another temporary object.
+    V_object str;
+    str.try_emplace(&"find", V_integer(42));
+    V_object obj;
+    obj.try_emplace(&"string", str);
+    code.global().insert_named_reference(&"std").set_temporary(obj);
+
+    res = code.execute().dereference_readonly();
+    ASTERIA_TEST_CHECK(res.as_integer() == 42);
+
+    // Members that are not objects are reported as usual.
+    V_object bad;
+    bad.try_emplace(&"string", V_integer(1));
+    code.global().insert_named_reference(&"std").set_temporary(bad);
+    ASTERIA_TEST_CHECK_CATCH(code.execute());
+
+    // Replace `std` with a variable, then modify it.
+    auto var = code.open_global_variable(&"std");
+    var->initialize(obj);
+    res = code.execute().dereference_readonly();
+    ASTERIA_TEST_CHECK(res.as_integer() == 42);
+
+    var->mut_value().mut_object().mut(&"string").mut_object().mut(&"find") = V_integer(43);
+    res = code.execute().dereference_readonly();
+    ASTERIA_TEST_CHECK(res.as_integer() == 43);
+
+    // Remove `std`.
+    code.erase_global_variable(&"std");
+    ASTERIA_TEST_CHECK_CATCH(code.execute());
+  }
@@ -3,6 +3,8 @@
 
 #include "utils.hpp"
 #include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/abstract_hooks.hpp"
+#include "../asteria/runtime/global_context.hpp"
 using namespace ::asteria;
 
 int main()
@@ -28,7 +30,57 @@ int main()
         catch(e)
           assert std.string.find(e, "Recursive import") != null;
 
+        // Recursion shall be detected even if the module has been cached.
+        try {
+          import("import_recursive.txt");
+          assert false;
+        }
+        catch(e)
+          assert std.string.find(e, "Recursive import") != null;
+
+        // Modified files shall be compiled again.
+        var temp = "/tmp/asteria_test_import_" + std.string.pcre_replace(__file, '[^a-z]', '_') + ".txt";
+        std.filesystem.write(temp, "return 1;");
+        assert import(temp) == 1;
+        assert import(temp) == 1;
+        std.filesystem.write(temp, "return 2;");
+        assert import(temp) == 2;
+        std.filesystem.remove_file(temp);
+
 ///////////////////////////////////////////////////////////////////////////////
       )__");
     code.execute();
+
+    // Modules that have been compiled without hooks may contain inlined calls,
+    // so they are not reused once hooks have been installed.
+    struct Test_Hooks : Abstract_Hooks
+      {
+        uint32_t nsq = 0;
+
+        void
+        on_call(const Source_Location& /*sloc*/, const cow_function& target) override
+          {
+            if(format_string("$1", target).find("sq(") != cow_string::npos)
+              this->nsq ++;
+          }
+      };
+
+    code.reload_string(
+      cow_string(abspath), __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var temp = "/tmp/asteria_test_import_hooks_" + std.string.pcre_replace(__file, '[^a-z]', '_') + ".txt";
+        std.filesystem.write(temp, "func sq(x) { return x * x;  }  return sq(3);");
+        var r = import(temp);
+        std.filesystem.remove_file(temp);
+        return r;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    ASTERIA_TEST_CHECK(code.execute().dereference_readonly().as_integer() == 9);
+
+    const auto hooks = ::rocket::make_refcnt<Test_Hooks>();
+    code.global().set_hooks(hooks);
+    ASTERIA_TEST_CHECK(code.execute().dereference_readonly().as_integer() == 9);
+    ASTERIA_TEST_CHECK(hooks->nsq == 1);
   }
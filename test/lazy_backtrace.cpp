@@ -0,0 +1,74 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/runtime_error.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    // The message is composed on demand, and is updated after new frames
+    // have been pushed.
+    Runtime_Error except(xtc_format, "test $1", 42);
+    cow_string what = ::rocket::sref(except.what());
+    ASTERIA_TEST_CHECK(what.find("runtime error: test 42") == 0);
+    ASTERIA_TEST_CHECK(what.find("1) native code") != cow_string::npos);
+    ASTERIA_TEST_CHECK(what.find("2)") == cow_string::npos);
+
+    except.push_frame_plain(Source_Location(&"dummy", 1, 2), &"remark");
+    what = ::rocket::sref(except.what());
+    ASTERIA_TEST_CHECK(what.find("2)   expression at 'dummy:1:2': \"remark\"") != cow_string::npos);
+
+    Runtime_Error copy = except;
+    ASTERIA_TEST_CHECK(::strcmp(copy.what(), except.what()) == 0);
+
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+      func fail() {
+        throw "boom";
+      }
+
+      func digest(bt) {
+        var r = [];
+        for(each k, v -> bt)
+          r[$] = [ v.frame, v.value ];
+        return r;
+      }
+
+      // `__backtrace` is created only when it is requested, but it is the
+      // same wherever it is requested within a `catch` clause.
+      var bt1, bt2;
+      try
+        fail();
+      catch(e) {
+        {
+          bt1 = __backtrace;
+        }
+        bt2 = __backtrace;
+      }
+      assert countof bt1 == 4;
+      assert bt1[0].frame == "throw statement";
+      assert bt1[0].value == "boom";
+      assert digest(bt1) == digest(bt2);
+
+      // Nested `catch` clauses see their own exceptions.
+      try
+        fail();
+      catch(e) {
+        try
+          throw "inner";
+        catch(x) {
+          assert __backtrace[0].value == "inner";
+          assert countof __backtrace > countof bt1;
+        }
+        assert digest(__backtrace) == digest(bt1);
+      }
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
@@ -0,0 +1,111 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+static
+cow_string
+do_run(bool lazy, cow_stringR source)
+  {
+    Simple_Script code;
+    code.mut_options().lazy_function_bodies = lazy;
+    code.reload_string(&"lazy", 1, source);
+    return format_string("$1", code.execute().dereference_readonly());
+  }
+
+int main()
+  {
+    const cow_string source = &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        var base = 100;
+        const obj = { base: 5, list: [ 1, 2, 3 ] };
+
+        func fib(n) { return n <= 1 ? n : fib(n - 1) + fib(n - 2);  }
+
+        func outer(x) {
+          var y = x * 2;
+          func inner(z) {
+            if(z > 0) {
+              return base + y + z + obj.base;
+            }
+            return inner(-z);
+          }
+          return inner;
+        }
+
+        func counter() {
+          var n = 0;
+          func next() { return ++n;  }
+          return next;
+        }
+
+        var fns = [ ];
+        for(var i = 0;  i < 3;  ++i) {
+          func get() { return i * 10 + base;  }
+          fns[$] = get;
+        }
+
+        var c = counter();
+        c();
+        c();
+        base = 200;
+
+        return [ fib(20), outer(3)(-4), c(), fns[0](), fns[2](), obj.list ];
+
+///////////////////////////////////////////////////////////////////////////////
+      )__";
+
+    // Results are the same as those in eager mode.
+    const auto eager = do_run(false, source);
+    ASTERIA_TEST_CHECK(do_run(true, source) == eager);
+
+    Simple_Script code;
+    code.mut_options().lazy_function_bodies = true;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+        // Bodies are not parsed until they are called.
+        func bad() { this is not valid {;} }
+        func good() { return 42;  }
+        assert good() == 42;
+
+        // An error is thrown from the call, and can be caught.
+        var e = catch( bad() );
+        assert e != null;
+        e = catch( bad() );
+        assert e != null;
+
+        // Nested braces are matched.
+        func nested(a) { if(a) { return { x: [ { } ] };  } return { };  }
+        assert countof nested(true).x == 1;
+
+        // Names that are only object keys don't fail the definition, even if
+        // variables of the same names have been bypassed. Variables that are
+        // used fail when they are used.
+        func pick(c) {
+          switch(c) {
+            case 1:
+              var key = "a";
+              var y = 5;
+            case 2:
+              func make() { return { key: c };  }
+              func get() { return y;  }
+              return (c == 1) ? [ make().key, get() ] : [ make().key, catch( get() ) ];
+          }
+        }
+        assert pick(1) == [ 1, 5 ];
+        assert pick(2)[0] == 2;
+        assert pick(2)[1] != null;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+
+    // Without lazy mode, the error is reported when the script is loaded.
+    code.mut_options().lazy_function_bodies = false;
+    ASTERIA_TEST_CHECK_CATCH(code.reload_string(&"bad", 1, &"func bad() { this is not valid {;} }"));
+  }
@@ -0,0 +1,83 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+      func add(p) { return p[0] + p[1];  }
+      func sub(p) { return p[0] - p[1];  }
+      func lt(p) { return p[0] < p[1];  }
+      func eq(p) { return p[0] == p[1];  }
+      func cmp(p) { return p[0] <=> p[1];  }
+
+      // Warm up these sites with integers.
+      for(var i = 0;  i < 100;  ++i) {
+        assert add([ i, 2 ]) == i + 2;
+        assert sub([ i, 2 ]) == i - 2;
+        assert lt([ i, 50 ]) == (i < 50);
+        assert eq([ i, 50 ]) == (i == 50);
+        assert cmp([ i, 50 ]) == (i <=> 50);
+      }
+
+      // Overflows shall still be reported.
+      try {
+        add([ 0x7FFFFFFFFFFFFFFF, 1 ]);
+        assert false;
+      }
+      catch(e)
+        assert std.string.find(e, "overflow") != null;
+
+      // Guards shall fail for other types, and results shall be correct.
+      assert add([ 1.5, 2.0 ]) == 3.5;
+      assert add([ "ab", "cd" ]) == "abcd";
+      assert add([ true, false ]) == true;
+      assert add([ 1.5, 2 ]) == 3.5;
+      assert lt([ "a", "b" ]) == true;
+      assert eq([ null, null ]) == true;
+      assert cmp([ 1.0, 0/0.0 ]) == "[unordered]";
+
+      // Warm up these sites with reals.
+      for(var i = 0;  i < 100;  ++i) {
+        var r = i / 4.0;
+        assert add([ r, 0.5 ]) == r + 0.5;
+        assert sub([ r, 0.5 ]) == r - 0.5;
+        assert lt([ r, 10.0 ]) == (r < 10.0);
+        assert eq([ r, 10.0 ]) == (r == 10.0);
+      }
+
+      // Unordered comparisons shall still be reported.
+      assert eq([ 0/0.0, 0/0.0 ]) == false;
+      assert eq([ -0.0, 0.0 ]) == true;
+      try {
+        lt([ 0/0.0, 1.0 ]);
+        assert false;
+      }
+      catch(e)
+        assert std.string.find(e, "not comparable") != null;
+
+      // Warm up these sites with strings.
+      for(var i = 0;  i < 100;  ++i) {
+        var s = std.string.format("$1", i);
+        assert add([ s, "x" ]) == s + "x";
+        assert lt([ s, "5" ]) == (s < "5");
+        assert eq([ s, "50" ]) == (s == "50");
+        assert cmp([ s, "50" ]) == (s <=> "50");
+      }
+
+      // Integers shall be accepted again.
+      assert add([ 1, 2 ]) == 3;
+      assert lt([ 2, 1 ]) == false;
+      assert cmp([ 2, 1 ]) == 1;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
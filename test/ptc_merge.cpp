@@ -0,0 +1,99 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+      func count_ptc_frames(bt) {
+        var n = 0;
+        for(each k, v -> bt)
+          if(v.value == "[proper tail call]")
+            ++n;
+        return n;
+      }
+
+      // Frames of a tail-recursive loop are merged, but still appear in
+      // backtraces.
+      func loop(n) {
+        if(n <= 0)
+          throw "boom";
+        return loop(n - 1);
+      }
+      try
+        loop(1000);
+      catch(e) {
+        assert e == "boom";
+        assert count_ptc_frames(__backtrace) == 1000;
+      }
+
+      // Each call in a chain of distinct closures keeps its own caller.
+      func make(next) {
+        return func(n) {
+          if(n <= 0)
+            throw "boom";
+          return next(n - 1);
+        };
+      }
+      var chain = func(n) { throw "boom";  };
+      for(var i = 0;  i < 10;  ++i)
+        chain = make(chain);
+      try
+        chain(100);
+      catch(e) {
+        assert e == "boom";
+        assert count_ptc_frames(__backtrace) == 10;
+        var m = 0;
+        var last = null;
+        for(each k, v -> __backtrace) {
+          if((last == "[proper tail call]") && (std.string.find(v.frame, "function") != null))
+            ++m;
+          last = v.value;
+        }
+        assert m == 10;
+      }
+
+      // Results are converted as usual.
+      var x = 42;
+      func get_ref(n) { if(n <= 0) return ref x;  return ref get_ref(n - 1);  }
+      func get_val(n) { if(n <= 0) return ref x;  return get_val(n - 1);  }
+      get_ref(100) = 43;
+      assert x == 43;
+      try {
+        get_val(100) = 44;
+        assert false;
+      }
+      catch(e)
+        assert x == 43;
+
+      // Frames with deferred expressions are not merged, so deferred
+      // expressions are evaluated in order.
+      var log = [];
+      func loop_defer(n) {
+        defer log[$] = n;
+        if(n <= 0)
+          return "done";
+        return loop_defer(n - 1);
+      }
+      assert loop_defer(5) == "done";
+      assert log == [ 0, 1, 2, 3, 4, 5 ];
+
+      // Deep tail recursion shall not blow anything up.
+      func sum(n, acc) {
+        if(n <= 0)
+          return acc;
+        return sum(n - 1, acc + n);
+      }
+      assert sum(1000000, 0) == 500000500000;
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
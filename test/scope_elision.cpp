@@ -0,0 +1,81 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+      // Blocks that declare nothing are executed in the enclosing context.
+      // References to outer variables must still be resolved correctly.
+      var a = 1;
+      {
+        {
+          var b = 2;
+          {
+            {
+              a += b;
+              if(a == 3) {
+                while(b < 10) {
+                  b += a;
+                }
+              }
+            }
+          }
+          assert b == 11;
+        }
+      }
+      assert a == 3;
+
+      // Loop bodies, with and without declarations.
+      var sum = 0;
+      for(var i = 0;  i < 10;  ++i) {
+        sum += i;
+      }
+      assert sum == 45;
+
+      var fs = [];
+      for(each k, v -> [ 1, 2, 3 ]) {
+        fs[$] = func() { return k * v;  };
+      }
+      assert countof fs == 3;
+      assert fs[2]() == 6;
+
+      var n = 0;
+      do {
+        if(n % 2 == 0) {
+          n += 3;
+        }
+        else {
+          n += 1;
+        }
+      }
+      while(n < 10);
+      assert n == 11;
+
+      // Deferred expressions in a block are evaluated when the block exits.
+      var log = [];
+      func f() {
+        {
+          defer log[$] = 1;
+        }
+        log[$] = 2;
+        {
+          {
+            log[$] = 3;
+          }
+        }
+      }
+      f();
+      assert log == [ 1, 2, 3 ];
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+  }
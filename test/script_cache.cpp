@@ -0,0 +1,207 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+#include "../asteria/runtime/global_context.hpp"
+#include "../asteria/runtime/module_loader.hpp"
+#include "../asteria/runtime/air_node.hpp"
+#include "../asteria/runtime/air_serializer.hpp"
+#include <dirent.h>
+#include <sys/stat.h>
+using namespace ::asteria;
+
+static
+void
+do_write_file(const cow_string& path, const cow_string& data)
+  {
+    ::rocket::unique_posix_file file(::fopen(path.c_str(), "wb"));
+    ROCKET_ASSERT(file);
+    ROCKET_ASSERT(::fwrite(data.data(), 1, data.size(), file) == data.size());
+  }
+
+static
+cow_string
+do_read_file(const cow_string& path)
+  {
+    ::rocket::unique_posix_file file(::fopen(path.c_str(), "rb"));
+    ROCKET_ASSERT(file);
+    cow_string data;
+    char temp[256];
+    while(size_t n = ::fread(temp, 1, sizeof(temp), file))
+      data.append(temp, n);
+    return data;
+  }
+
+static
+cow_vector<cow_string>
+do_list_files(const cow_string& dir)
+  {
+    cow_vector<cow_string> files;
+    ::rocket::unique_ptr<::DIR, int (::DIR*)> dp(::opendir(dir.c_str()), ::closedir);
+    if(!dp)
+      return files;
+
+    while(auto ent = ::readdir(dp))
+      if(ent->d_name[0] != '.')
+        files.emplace_back(dir + "/" + ent->d_name);
+    return files;
+  }
+
+static
+Value
+do_run(const cow_string& cache_dir, const cow_string& path)
+  {
+    Simple_Script code;
+    code.global().module_loader()->set_cache_directory(cache_dir);
+    code.reload_file(path);
+    cow_vector<Value> args;
+    args.emplace_back(&"arg");
+    return code.execute(move(args)).dereference_readonly();
+  }
+
+int main()
+  {
+    char dir[] = "/tmp/asteria_test_script_cache_XXXXXX";
+    ROCKET_ASSERT(::mkdtemp(dir));
+    const cow_string cache_dir = cow_string(dir) + "/cache/air";
+    const cow_string path = cow_string(dir) + "/main.ast";
+    const cow_string sub_path = cow_string(dir) + "/sub.ast";
+
+    const cow_string source = &R"__(
+        var a = [ 1, 2.5, "three", true, null, { x: [ 4 ] } ];
+        func fib(n) { return n <= 1 ? n : fib(n - 1) + fib(n - 2);  }
+
+        var s = 0;
+        for(each k, v -> { a: 1, b: 2 })
+          s += v;
+
+        switch(s) {
+          case 3:
+            s += 1;
+            break;
+          default:
+            s = -1;
+        }
+
+        var e;
+        try
+          throw "oops";
+        catch(x)
+          e = x;
+
+        var n = 0;
+        do
+          ++n;
+        while(n < 3);
+        while(n < 5)
+          n++;
+        for(var i = 0;  i < 3;  ++i)
+          n += i;
+
+        var f = func(x) = x * 2;
+        const g = func(x) = x + 1;
+        var [ p, q ] = [ 1, 2 ];
+        var { m } = { m: 3 };
+        var o = { };
+        o.z ??= 7;
+        var c = catch( fib("x") );
+        assert s == 4 : "failed";
+
+        return [ fib(15), s, e, n, f(21), p + q + m, o.z, a[5].x[0], __varg(0),
+                 0x7FFFFFFFFFFFFFFF, -0.5, "\x00\n", c != null,
+                 import("sub.ast", 20), g(41) ];
+      )__";
+    do_write_file(path, source);
+    do_write_file(sub_path, &"return __varg(0) + 1;");
+
+    // The first run saves both scripts.
+    auto first = do_run(cache_dir, path);
+    const auto str = format_string("$1", first);
+    auto files = do_list_files(cache_dir);
+    ASTERIA_TEST_CHECK(files.size() == 2);
+
+    // The second run loads them, with the same result. Files are not written
+    // again.
+    struct ::stat info;
+    ROCKET_ASSERT(::stat(files.at(0).c_str(), &info) == 0);
+    auto ino = info.st_ino;
+    auto second = do_run(cache_dir, path);
+    ROCKET_ASSERT(::stat(files.at(0).c_str(), &info) == 0);
+    ASTERIA_TEST_CHECK(info.st_ino == ino);
+    ASTERIA_TEST_CHECK(format_string("$1", second) == str);
+    ASTERIA_TEST_CHECK(second.as_array().at(0).as_integer() == 610);
+    ASTERIA_TEST_CHECK(second.as_array().at(13).as_integer() == 21);
+    ASTERIA_TEST_CHECK(second.as_array().at(14).as_integer() == 42);
+
+    // Code survives a round trip without changes.
+    Compiler_Options opts;
+    cow_string data;
+    for(const auto& file : files) {
+      data = do_read_file(file);
+      cow_vector<AIR_Node> code;
+      bool main_ok = deserialize_air(code, opts, source, data, nullptr);
+      bool sub_ok = deserialize_air(code, opts, &"return __varg(0) + 1;", data, nullptr);
+      ASTERIA_TEST_CHECK(main_ok != sub_ok);
+      if(main_ok)
+        break;
+    }
+
+    cow_vector<AIR_Node> code;
+    ASTERIA_TEST_CHECK(deserialize_air(code, opts, source, data, nullptr));
+    cow_string data2;
+    ASTERIA_TEST_CHECK(serialize_air(data2, opts, source, code));
+    ASTERIA_TEST_CHECK(data2 == data);
+
+    // The call to `g` has been inlined.
+    bool has_inline_call = false;
+    for(const auto& node : code)
+      if(node.index() == AIR_Node::index_inline_call)
+        has_inline_call = true;
+    ASTERIA_TEST_CHECK(has_inline_call);
+
+    // Data are rejected if they are truncated, or have been produced from
+    // another source or with other options.
+    ASTERIA_TEST_CHECK(!deserialize_air(code, opts, source, cow_string(data, 0, data.size() - 1), nullptr));
+    ASTERIA_TEST_CHECK(!deserialize_air(code, opts, source + " ", data, nullptr));
+    opts.optimization_level = 0;
+    ASTERIA_TEST_CHECK(!deserialize_air(code, opts, source, data, nullptr));
+
+    // Flags in options of functions must be either zero or one. In the data of
+    // this function, options are followed by six bytes.
+    opts = Compiler_Options();
+    AIR_Node::S_define_function xfunc;
+    xfunc.sloc = Source_Location(&"f", 1, 1);
+    xfunc.func = &"f()";
+    code.clear();
+    code.emplace_back(move(xfunc));
+    ASTERIA_TEST_CHECK(serialize_air(data, opts, source, code));
+    ASTERIA_TEST_CHECK(deserialize_air(code, opts, source, data, nullptr));
+    size_t ptc_pos = data.size() - 6 - sizeof(Compiler_Options) + 4;
+    ASTERIA_TEST_CHECK(data[ptc_pos] == '\x01');
+    data.mut(ptc_pos) = '\x02';
+    ASTERIA_TEST_CHECK(!deserialize_air(code, opts, source, data, nullptr));
+
+    // A corrupted cache file is ignored and replaced.
+    for(const auto& file : files)
+      do_write_file(file, &"garbage");
+    auto third = do_run(cache_dir, path);
+    ASTERIA_TEST_CHECK(format_string("$1", third) == str);
+    for(const auto& file : files)
+      ASTERIA_TEST_CHECK(do_read_file(file) != "garbage");
+
+    // A modified script is compiled again.
+    do_write_file(sub_path, &"return __varg(0) - 1;");
+    auto fourth = do_run(cache_dir, path);
+    ASTERIA_TEST_CHECK(fourth.as_array().at(13).as_integer() == 19);
+    ASTERIA_TEST_CHECK(do_run(cache_dir, path).as_array().at(13).as_integer() == 19);
+
+    // Clean up.
+    for(const auto& file : do_list_files(cache_dir))
+      ::unlink(file.c_str());
+    ::rmdir(cache_dir.c_str());
+    ::rmdir((cow_string(dir) + "/cache").c_str());
+    ::unlink(path.c_str());
+    ::unlink(sub_path.c_str());
+    ::rmdir(dir);
+  }
@@ -0,0 +1,150 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/simple_script.hpp"
+using namespace ::asteria;
+
+int main()
+  {
+    Simple_Script code;
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+      func frames(bt) {
+        var r = [];
+        for(each k, v -> bt)
+          r[$] = v.frame;
+        return r;
+      }
+
+      func fail(x) {
+        throw x;
+      }
+      func relay(x) {
+        return 1 + fail(x);
+      }
+
+      // Exceptions propagate through script functions.
+      try
+        relay(42);
+      catch(e) {
+        assert e == 42;
+        assert frames(__backtrace) == [ "throw statement", "  function", "  expression", "  function", "  expression", "  try clause" ];
+      }
+
+      // Exceptions propagate through native functions.
+      try
+        std.array.sort([ 2, 1 ], func(x, y) { return fail(x); });
+      catch(e) {
+        assert e == 2 || e == 1;
+        assert frames(__backtrace) == [ "throw statement", "  function", "  expression", "  function", "  expression", "  try clause" ];
+      }
+
+      // Deferred expressions are evaluated during unwinding.
+      var log = [];
+      func defers(x) {
+        defer log[$] = 1;
+        defer log[$] = 2;
+        fail(x);
+      }
+      try
+        defers(3);
+      catch(e)
+        log[$] = e;
+      assert log == [ 2, 1, 3 ];
+
+      // Exceptions from deferred expressions replace the one in flight.
+      func defer_fail() {
+        defer fail("second");
+        fail("first");
+      }
+      try
+        defer_fail();
+      catch(e) {
+        assert e == "second";
+        assert frames(__backtrace) == [ "throw statement", "  function", "  expression", "  defer statement", "throw statement",
+                                   "  function", "  expression", "  function", "  expression", "  try clause" ];
+      }
+
+      // Exceptions from `catch` clauses carry frames of the one being handled.
+      try
+        try
+          fail("inner");
+        catch(e)
+          fail("outer");
+      catch(e) {
+        assert e == "outer";
+        assert frames(__backtrace) == [ "throw statement", "  function", "  expression", "  catch clause", "throw statement",
+                                   "  function", "  expression", "  try clause", "  expression", "  try clause" ];
+      }
+
+      // Exceptions can be thrown from any expressions.
+      var x = 1;
+      try {
+        x += fail(2);
+        assert false;
+      }
+      catch(e)
+        assert e == 2 && x == 1;
+
+      var n = 0;
+      try
+        while(fail(n))
+          ++n;
+      catch(e)
+        assert e == 0;
+
+      try
+        for(var i = 0;  i < 10;  i = fail(i))
+          ++n;
+      catch(e)
+        assert e == 0 && n == 1;
+
+      try
+        for(each k, v -> fail("range"))
+          ++n;
+      catch(e)
+        assert e == "range" && n == 1;
+
+      try
+        switch(1) {
+          case fail("label"):
+            ++n;
+        }
+      catch(e)
+        assert e == "label" && n == 1;
+
+      assert catch(relay(5)) == 5;
+      assert catch(relay(5) + 1) == 5;
+
+      // A deep throw is unwound properly.
+      func deep(k) {
+        if(k <= 0)
+          throw "bottom";
+        return 1 + deep(k - 1);
+      }
+      try
+        deep(1000);
+      catch(e)
+        assert e == "bottom";
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    code.execute();
+
+    // Uncaught exceptions are thrown as C++ exceptions.
+    code.reload_string(
+      &__FILE__, __LINE__, &R"__(
+///////////////////////////////////////////////////////////////////////////////
+
+      func fail(x) {
+        throw x;
+      }
+      fail("uncaught");
+
+///////////////////////////////////////////////////////////////////////////////
+      )__");
+    ASTERIA_TEST_CHECK_CATCH(code.execute());
+  }
@@ -0,0 +1,105 @@
+// This file is part of Asteria.
+// Copyleft 2018 - 2023, LH_Mouse. All wrongs reserved.
+
+#include "utils.hpp"
+#include "../asteria/compiler/token_stream.hpp"
+#include "../asteria/compiler/token.hpp"
+#include "../asteria/compiler/compiler_error.hpp"
+using namespace ::asteria;
+
+static
+cow_string
+do_describe(Token_Stream& ts)
+  {
+    cow_string str;
+    while(auto p = ts.peek_opt()) {
+      str += format_string("$1:$2:$3+$4 ", p->line(), p->column(), p->length(), p->file());
+      if(p->is_keyword())
+        str += format_string("keyword $1\n", p->as_keyword_c_str());
+      else if(p->is_punctuator())
+        str += format_string("punctuator $1\n", p->as_punctuator());
+      else if(p->is_identifier())
+        str += format_string("identifier `$1`\n", p->as_identifier());
+      else if(p->is_integer_literal())
+        str += format_string("integer $1\n", p->as_integer_literal());
+      else if(p->is_real_literal())
+        str += format_string("real $1\n", p->as_real_literal());
+      else
+        str += format_string("string `$1`\n", p->as_string_literal());
+      ts.shift();
+    }
+    return str;
+  }
+
+static
+cow_string
+do_tokenize_stream(const Compiler_Options& opts, const cow_string& source)
+  {
+    Token_Stream ts(opts);
+    ::rocket::tinybuf_str cbuf;
+    cbuf.set_string(source, tinybuf::open_read);
+    try {
+      ts.reload(&"file", 3, move(cbuf));
+    }
+    catch(Compiler_Error& except) {
+      return format_string("error $1 at $2", except.status(), except.sloc());
+    }
+    return do_describe(ts);
+  }
+
+static
+cow_string
+do_tokenize_buffer(const Compiler_Options& opts, const cow_string& source)
+  {
+    Token_Stream ts(opts);
+    try {
+      ts.reload(&"file", 3, source.data(), source.size());
+    }
+    catch(Compiler_Error& except) {
+      return format_string("error $1 at $2", except.status(), except.sloc());
+    }
+    return do_describe(ts);
+  }
+
+int main()
+  {
+    // Both overloads produce the same tokens. Tokens and blanks are longer
+    // than sixteen characters, so they span multiple blocks.
+    const cow_string source = &R"__(#!some shebang
+        var a_very_long_identifier_name_1234567890 = "a long string literal that needs no escapes";
+        var b = "a long string literal\twith\u55b5escapes \"quoted\" and more characters";
+        var c = 'single quoted \n string that is even longer than sixteen bytes';
+        var d = "喵喵喵喵喵喵喵喵喵喵喵喵喵喵喵喵" + "";
+        /* a block comment with * asterisks ** and
+           multiple lines ***/ a_very_long_identifier_name_1234567890 . _x9;
+		 	 	 	 	 	 	 	 	 	 	 	 	 	  x = 0x01`7.8`4p+4 / 2 // comments
+        y = nan + infinity - -42e13;      z = a_very_long_identifier_name_1234567890;)__";
+
+    for(bool esq : { false, true }) {
+      Compiler_Options opts;
+      opts.escapable_single_quotes = esq;
+      auto str = do_tokenize_buffer(opts, source);
+      ASTERIA_TEST_CHECK(str == do_tokenize_stream(opts, source));
+      ASTERIA_TEST_CHECK(str.find(&"string `a long string literal\twith\xE5\x96\xB5"
+                                   "escapes \"quoted\" and more characters`") != cow_string::npos);
+    }
+
+    // Lines may end without a line feed, or with a carriage return.
+    Compiler_Options opts;
+    ASTERIA_TEST_CHECK(do_tokenize_buffer(opts, &"a\r\nb\n\nc") == do_tokenize_stream(opts, &"a\r\nb\n\nc"));
+    ASTERIA_TEST_CHECK(do_tokenize_buffer(opts, &"a\n") == do_tokenize_stream(opts, &"a\n"));
+    ASTERIA_TEST_CHECK(do_tokenize_buffer(opts, &"") == "");
+
+    // Errors are reported at the same locations.
+    for(const char* bad : { "\"unclosed string literal that is very long", "/* unclosed\n comment *",
+                            "x = \"\\q\"", "ok + \xFF\xFE", "a = \"null \0 in string\"",
+                            "identifier_longer_than_sixteen_characters @" }) {
+      cow_string text(bad);
+      if(text.starts_with("a = "))
+        text.assign(bad, 22);
+
+      auto str = do_tokenize_buffer(opts, text);
+      ASTERIA_TEST_CHECK(str.starts_with("error "));
+      ASTERIA_TEST_CHECK(str == do_tokenize_stream(opts, text));
+    }
+  }